@@ -0,0 +1,261 @@
+// BancTcp.c
+// Banc de mesure du chemin des commandes TCP : client PC qui envoie des
+// trames de rglage au gnrateur (carte ou Simulateur) et mesure dbit
+// et temps d'aller-retour, puis relve la mesure de la carte (?LAT#)
+//
+//  Usage : BancTcp [--hote a.b.c.d] [--port n] [--nb n] [--intervalle us]
+//                  [--attente ms]
+//
+//   --hote        adresse du gnrateur (127.0.0.1 par dfaut : Simulateur)
+//   --port        port du serveur de app.c (9760 par dfaut)
+//   --nb          nombre de trames (1000 par dfaut)
+//   --intervalle  0 (dfaut) : boucle ferme, chaque trame attend la
+//                 rponse de la prcdente (dbit maximal sans que deux
+//                 trames se retrouvent dans le mme tampon de APP_Tasks) ;
+//                 sinon une trame toutes les n us sans attendre, les
+//                 rponses sont comptes au passage
+//   --attente     attente entre la connexion et la premire trame (6000 ms
+//                 par dfaut) :  chaque connexion l'adresse IP reste 5 s
+//                 sur le LCD et le menu remote n'applique rien pendant ce
+//                 temps (les trames sont reues et rpondues)
+//
+//  Les trames alternent sinus et triangle et balayent la frquence de 100
+//   1090 Hz : chaque trame change les paramtres et donne une nouvelle
+//  table. La rponse de app.c a la longueur de la trame reue.
+//
+//  Ct PC : trames envoyes et rponses, dure, dbit, aller-retour
+//  (p50, p99, max). Ct carte : rapport de ?LAT# (latence commande ->
+//  premier chantillon de la nouvelle table, GesLatence),  remettre 
+//  zro avant la mesure par la commande console "latence raz".
+//
+//---------------------------------------------------------------------------
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#define BANC_PORT_DEFAUT 9760
+#define BANC_NB_DEFAUT 1000
+#define BANC_NB_MAX 100000
+#define BANC_ATTENTE_DEFAUT 6000
+// Attente maximale d'une rponse
+#define BANC_DELAI_MS 2000
+
+static uint64_t HorlogeNs(void) {
+    struct timespec t;
+
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return ((uint64_t) t.tv_sec * 1000000000u) + (uint64_t) t.tv_nsec;
+}
+
+//----------------------------------------------------------------------------
+//  Connecte
+//  Socket connect au gnrateur, -1 en cas d'chec
+//----------------------------------------------------------------------------
+
+static int Connecte(const char *hote, uint16_t port) {
+    struct sockaddr_in adresse;
+    struct timeval delai = {BANC_DELAI_MS / 1000, (BANC_DELAI_MS % 1000) * 1000};
+    int un = 1;
+    int s;
+
+    memset(&adresse, 0, sizeof (adresse));
+    adresse.sin_family = AF_INET;
+    adresse.sin_port = htons(port);
+    if (inet_pton(AF_INET, hote, &adresse.sin_addr) != 1) {
+        fprintf(stderr, "adresse invalide : %s\n", hote);
+        return -1;
+    }
+    s = socket(AF_INET, SOCK_STREAM, 0);
+    if (s < 0) {
+        perror("socket");
+        return -1;
+    }
+    if (connect(s, (struct sockaddr *) &adresse, sizeof (adresse)) < 0) {
+        perror("connect");
+        close(s);
+        return -1;
+    }
+    // Trames courtes : envoi immdiat, rception borne dans le temps
+    setsockopt(s, IPPROTO_TCP, TCP_NODELAY, &un, sizeof (un));
+    setsockopt(s, SOL_SOCKET, SO_RCVTIMEO, &delai, sizeof (delai));
+    return s;
+}
+
+//----------------------------------------------------------------------------
+//  Recoit
+//  Exactement nb octets (bloquant jusqu'au dlai), false sinon
+//----------------------------------------------------------------------------
+
+static bool Recoit(int s, char *pTampon, size_t nb) {
+    size_t recus = 0;
+
+    while (recus < nb) {
+        ssize_t n = recv(s, &pTampon[recus], nb - recus, 0);
+        if (n <= 0) {
+            return false;
+        }
+        recus += (size_t) n;
+    }
+    return true;
+}
+
+static int CompareDurees(const void *a, const void *b) {
+    uint64_t da = *(const uint64_t *) a;
+    uint64_t db = *(const uint64_t *) b;
+
+    return (da > db) - (da < db);
+}
+
+//----------------------------------------------------------------------------
+//  Rapport
+//  Requte ?LAT# et affichage de la rponse jusqu' la fin de trame '#'
+//----------------------------------------------------------------------------
+
+static void Rapport(int s) {
+    char texte[1024];
+    size_t longueur = 0;
+
+    if (send(s, "?LAT#", 5, 0) != 5) {
+        perror("send");
+        return;
+    }
+    while (longueur < sizeof (texte) - 1) {
+        ssize_t n = recv(s, &texte[longueur], sizeof (texte) - 1 - longueur, 0);
+        if (n <= 0) {
+            break;
+        }
+        longueur += (size_t) n;
+        texte[longueur] = '\0';
+        if (strstr(texte, "#\r\n") != NULL) {
+            break;
+        }
+    }
+    texte[longueur] = '\0';
+    printf("carte (?LAT#) :\n%s", texte);
+}
+
+int main(int argc, char *argv[]) {
+    const char *hote = "127.0.0.1";
+    uint16_t port = BANC_PORT_DEFAUT;
+    uint32_t nb = BANC_NB_DEFAUT;
+    uint32_t intervalleUs = 0;
+    uint32_t attenteMs = BANC_ATTENTE_DEFAUT;
+    uint64_t *pDurees;
+    uint64_t debut;
+    uint64_t duree;
+    uint32_t nbReponses = 0;
+    uint32_t nbEnvoyees = 0;
+    uint32_t i;
+    int s;
+
+    for (i = 1; i < (uint32_t) argc; i++) {
+        if ((strcmp(argv[i], "--hote") == 0) && (i + 1 < (uint32_t) argc)) {
+            hote = argv[++i];
+        } else if ((strcmp(argv[i], "--port") == 0) && (i + 1 < (uint32_t) argc)) {
+            port = (uint16_t) atoi(argv[++i]);
+        } else if ((strcmp(argv[i], "--nb") == 0) && (i + 1 < (uint32_t) argc)) {
+            nb = (uint32_t) atol(argv[++i]);
+        } else if ((strcmp(argv[i], "--intervalle") == 0) && (i + 1 < (uint32_t) argc)) {
+            intervalleUs = (uint32_t) atol(argv[++i]);
+        } else if ((strcmp(argv[i], "--attente") == 0) && (i + 1 < (uint32_t) argc)) {
+            attenteMs = (uint32_t) atol(argv[++i]);
+        } else {
+            fprintf(stderr, "usage : %s [--hote a.b.c.d] [--port n] [--nb n] "
+                    "[--intervalle us] [--attente ms]\n", argv[0]);
+            return 2;
+        }
+    }
+    if ((nb == 0) || (nb > BANC_NB_MAX)) {
+        fprintf(stderr, "--nb : 1 .. %u\n", BANC_NB_MAX);
+        return 2;
+    }
+    s = Connecte(hote, port);
+    if (s < 0) {
+        return 1;
+    }
+    pDurees = malloc(nb * sizeof (uint64_t));
+    if (pDurees == NULL) {
+        close(s);
+        return 1;
+    }
+
+    printf("%s:%u, %lu trames, %s\n", hote, (unsigned) port, (unsigned long) nb,
+            (intervalleUs == 0) ? "boucle fermee" : "cadence imposee");
+    sleep(attenteMs / 1000u);
+    usleep((attenteMs % 1000u) * 1000u);
+    debut = HorlogeNs();
+    for (i = 0; i < nb; i++) {
+        char trame[64];
+        char reponse[64];
+        uint64_t envoi;
+        int longueur;
+
+        longueur = snprintf(trame, sizeof (trame), "!S=%cF=%uA=5000O=+0W=0#",
+                (i % 2) ? 'T' : 'S', 100u + ((i * 10u) % 1000u));
+        if (intervalleUs != 0) {
+            // Cadence impose : envoi  l'chance, rponses lues au passage
+            uint64_t echeance = debut + ((uint64_t) i * intervalleUs * 1000u);
+            while (HorlogeNs() < echeance) {
+                ssize_t n = recv(s, reponse, sizeof (reponse), MSG_DONTWAIT);
+                if (n > 0) {
+                    nbReponses += (uint32_t) n;
+                }
+            }
+        }
+        envoi = HorlogeNs();
+        if (send(s, trame, (size_t) longueur, 0) != longueur) {
+            perror("send");
+            break;
+        }
+        nbEnvoyees++;
+        if (intervalleUs == 0) {
+            if (!Recoit(s, reponse, (size_t) longueur)) {
+                fprintf(stderr, "pas de reponse a la trame %lu\n", (unsigned long) i);
+                break;
+            }
+            pDurees[nbReponses++] = HorlogeNs() - envoi;
+        }
+    }
+    duree = HorlogeNs() - debut;
+
+    if (intervalleUs == 0) {
+        printf("trames %lu, reponses %lu\n", (unsigned long) nbEnvoyees,
+                (unsigned long) nbReponses);
+    } else {
+        // Octets de rponse : plusieurs trames peuvent partager un tampon
+        usleep(BANC_DELAI_MS * 1000);
+        while (true) {
+            char reponse[512];
+            ssize_t n = recv(s, reponse, sizeof (reponse), MSG_DONTWAIT);
+            if (n <= 0) {
+                break;
+            }
+            nbReponses += (uint32_t) n;
+        }
+        printf("trames %lu, octets de reponse %lu\n", (unsigned long) nbEnvoyees,
+                (unsigned long) nbReponses);
+    }
+    printf("duree %.3f s, debit %.1f trames/s\n", duree / 1e9,
+            (duree > 0) ? (nbEnvoyees * 1e9) / duree : 0.0);
+    if ((intervalleUs == 0) && (nbReponses > 0)) {
+        qsort(pDurees, nbReponses, sizeof (uint64_t), CompareDurees);
+        printf("aller-retour p50 %lu us, p99 %lu us, max %lu us\n",
+                (unsigned long) (pDurees[(nbReponses - 1) / 2] / 1000),
+                (unsigned long) (pDurees[((nbReponses - 1) * 99) / 100] / 1000),
+                (unsigned long) (pDurees[nbReponses - 1] / 1000));
+    }
+    Rapport(s);
+
+    free(pDurees);
+    close(s);
+    return (nbEnvoyees == nb) ? 0 : 1;
+}
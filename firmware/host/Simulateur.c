@@ -0,0 +1,141 @@
+// Simulateur.c
+// Gnrateur complet sur PC, en temps rel : serveur TCP sur un vrai port
+// du PC, console sur stdin / stdout, cran LCD recopi  chaque changement
+//
+//  Simulateur [--port n] [--nvm fichier] [--duree s]
+//
+//   --port   port TCP du PC reli au serveur de app.c (9760 par dfaut)
+//   --nvm    fichier de la page des paramtres (sauvegardes conserves
+//            d'un lancement  l'autre), page en mmoire sinon
+//   --duree  arrt aprs s secondes de temps simul, sans limite sinon
+//
+// Chaque ligne de stdin est une commande de la console (help, gen prof,
+// gen param...). Le temps simul est cal sur l'horloge du PC toutes les
+// millisecondes ; les cadences du DAC et les temps de rponse sont donc
+// ceux de la cible, au modle du simulateur prs (Simulation.h).
+//
+//---------------------------------------------------------------------------
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "Simulation.h"
+
+#define SIM_PORT_DEFAUT 9760
+
+static uint64_t HorlogeNs(void) {
+    struct timespec t;
+
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return ((uint64_t) t.tv_sec * 1000000000u) + (uint64_t) t.tv_nsec;
+}
+
+//----------------------------------------------------------------------------
+//  LitCommandes
+//  Lignes compltes de stdin (non bloquant) vers la console
+//----------------------------------------------------------------------------
+
+static void LitCommandes(void) {
+    static char ligne[128];
+    static size_t longueur = 0;
+    char c;
+
+    while (read(STDIN_FILENO, &c, 1) == 1) {
+        if ((c == '\n') || (c == '\r')) {
+            ligne[longueur] = '\0';
+            if (longueur > 0) {
+                SIM_Commande(ligne);
+            }
+            longueur = 0;
+            return;
+        }
+        if (longueur < sizeof (ligne) - 1) {
+            ligne[longueur++] = c;
+        }
+    }
+}
+
+//----------------------------------------------------------------------------
+//  AfficheLcd
+//  Recopie de l'cran s'il a chang
+//----------------------------------------------------------------------------
+
+static void AfficheLcd(void) {
+    static char precedent[SIM_LCD_LIGNES][SIM_LCD_COLONNES + 1];
+    bool change = false;
+    uint8_t ligne;
+
+    for (ligne = 1; ligne <= SIM_LCD_LIGNES; ligne++) {
+        if (strcmp(precedent[ligne - 1], SIM_LcdLigne(ligne)) != 0) {
+            strcpy(precedent[ligne - 1], SIM_LcdLigne(ligne));
+            change = true;
+        }
+    }
+    if (change) {
+        printf("+--------------------+\n");
+        for (ligne = 0; ligne < SIM_LCD_LIGNES; ligne++) {
+            printf("|%s|\n", precedent[ligne]);
+        }
+        printf("+--------------------+\n");
+        fflush(stdout);
+    }
+}
+
+int main(int argc, char **argv) {
+    uint16_t port = SIM_PORT_DEFAUT;
+    const char *pFichierNvm = NULL;
+    double duree = 0;
+    uint64_t debutPc;
+    uint64_t prochainCalage;
+    uint64_t prochainLcd;
+    int i;
+
+    for (i = 1; i < argc; i++) {
+        if ((strcmp(argv[i], "--port") == 0) && (i + 1 < argc)) {
+            port = (uint16_t) atoi(argv[++i]);
+        } else if ((strcmp(argv[i], "--nvm") == 0) && (i + 1 < argc)) {
+            pFichierNvm = argv[++i];
+        } else if ((strcmp(argv[i], "--duree") == 0) && (i + 1 < argc)) {
+            duree = atof(argv[++i]);
+        } else {
+            fprintf(stderr, "usage : %s [--port n] [--nvm fichier] [--duree s]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    SIM_NvmFichier(pFichierNvm);
+    if (!SIM_TcpEcoute(port)) {
+        fprintf(stderr, "port %u indisponible\n", port);
+        return 1;
+    }
+    fcntl(STDIN_FILENO, F_SETFL, fcntl(STDIN_FILENO, F_GETFL) | O_NONBLOCK);
+    SIM_ConsoleEcho(true);
+    printf("serveur TCP sur le port %u\n", port);
+
+    SYS_Initialize(NULL);
+
+    debutPc = HorlogeNs();
+    prochainCalage = SIM_MS(1);
+    prochainLcd = SIM_MS(100);
+    while ((duree <= 0) || (SIM_Temps() < (uint64_t) (duree * SIM_HORLOGE))) {
+        SIM_Tour();
+        if (SIM_Temps() >= prochainCalage) {
+            uint64_t ecoulePc = HorlogeNs() - debutPc;
+            uint64_t ecouleSim = SIM_EN_NS(SIM_Temps());
+
+            prochainCalage += SIM_MS(1);
+            if (ecouleSim > ecoulePc) {
+                usleep((useconds_t) ((ecouleSim - ecoulePc) / 1000u));
+            }
+            LitCommandes();
+        }
+        if (SIM_Temps() >= prochainLcd) {
+            prochainLcd += SIM_MS(100);
+            AfficheLcd();
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,226 @@
+// TestBruit.c
+// Contrle des formes sans table de GesBruit (compilation PC)
+//
+//  Bruit blanc : moyenne, cart-type (uniforme : crte / racine de 3),
+//                corrlation entre chantillons voisins, khi-deux de
+//                l'histogramme sur 16 classes
+//  Bruit rose  : pente de la densit spectrale par octave (FFT sur des
+//                segments de TEST_LONGUEUR_FFT points, fentre de Hann)
+//  PRBS        : priode 2^n - 1, nombre de 1 et de 0, relance aprs un
+//                registre nul
+//
+//  Retourne 0 si toutes les mesures sont dans les tolrances.
+//
+//---------------------------------------------------------------------------
+
+#include <complex.h>
+#include <math.h>
+#include <stdio.h>
+#include "GesBruit.h"
+
+// Echantillons analyss par forme de bruit
+#define TEST_NB_ECH (1L << 21)
+#define TEST_LONGUEUR_FFT 4096
+#define TEST_GRAINE 0x2545F491u
+
+// Tolrances
+#define TEST_MOYENNE_MAX 100.0      // cart-type / racine(N) = 6.5
+#define TEST_ECART_TYPE_REL 0.02
+#define TEST_CORRELATION_MAX 0.01
+#define TEST_KHI2_MAX 40.0          // 15 degrs de libert, p < 0.001
+#define TEST_PENTE_MIN (-4.0)       // dB par octave
+#define TEST_PENTE_MAX (-2.0)
+
+static int16_t echantillons[TEST_NB_ECH];
+static int nbErreurs = 0;
+
+//----------------------------------------------------------------------------
+//  Verifie
+//  Affiche une mesure et compte l'erreur si elle est hors tolrance
+//----------------------------------------------------------------------------
+
+static void Verifie(const char *nom, double valeur, double min, double max) {
+    bool ok = (valeur >= min) && (valeur <= max);
+
+    printf("  %-28s %12.4f  [%g .. %g] %s\n", nom, valeur, min, max, ok ? "ok" : "ERREUR");
+    if (!ok) {
+        nbErreurs++;
+    }
+}
+
+//----------------------------------------------------------------------------
+//  TestBlanc
+//----------------------------------------------------------------------------
+
+static void TestBlanc(S_Bruit *pBruit) {
+    long i;
+    long histo[16] = {0};
+    double somme = 0;
+    double somme2 = 0;
+    double produits = 0;
+    double moyenne;
+    double variance;
+    double attendu = TEST_NB_ECH / 16.0;
+    double khi2 = 0;
+    double ecartUniforme = SIGNAL_CRETE / sqrt(3.0);
+    int k;
+
+    for (i = 0; i < TEST_NB_ECH; i++) {
+        echantillons[i] = BRUIT_Suivant(pBruit, SignalBruitBlanc);
+    }
+    for (i = 0; i < TEST_NB_ECH; i++) {
+        somme += echantillons[i];
+        somme2 += (double) echantillons[i] * echantillons[i];
+        if (i > 0) {
+            produits += (double) echantillons[i] * echantillons[i - 1];
+        }
+        histo[(echantillons[i] + SIGNAL_CRETE) >> 11]++;
+    }
+    moyenne = somme / TEST_NB_ECH;
+    variance = (somme2 / TEST_NB_ECH) - (moyenne * moyenne);
+    for (k = 0; k < 16; k++) {
+        khi2 += (histo[k] - attendu) * (histo[k] - attendu) / attendu;
+    }
+
+    printf("Bruit blanc (%ld chantillons)\n", TEST_NB_ECH);
+    Verifie("moyenne", moyenne, -TEST_MOYENNE_MAX, TEST_MOYENNE_MAX);
+    Verifie("cart-type", sqrt(variance), ecartUniforme * (1 - TEST_ECART_TYPE_REL),
+            ecartUniforme * (1 + TEST_ECART_TYPE_REL));
+    Verifie("corrlation voisins", produits / TEST_NB_ECH / variance,
+            -TEST_CORRELATION_MAX, TEST_CORRELATION_MAX);
+    Verifie("khi-deux (15)", khi2, 0, TEST_KHI2_MAX);
+}
+
+//----------------------------------------------------------------------------
+//  Fft
+//  FFT radix 2 en place, n puissance de 2
+//----------------------------------------------------------------------------
+
+static void Fft(double complex *a, int n) {
+    int i, j, k, bit, longueur;
+
+    for (i = 1, j = 0; i < n; i++) {
+        for (bit = n >> 1; j & bit; bit >>= 1) {
+            j ^= bit;
+        }
+        j ^= bit;
+        if (i < j) {
+            double complex t = a[i];
+            a[i] = a[j];
+            a[j] = t;
+        }
+    }
+    for (longueur = 2; longueur <= n; longueur <<= 1) {
+        double complex w = cexp(-2 * M_PI * I / longueur);
+        for (i = 0; i < n; i += longueur) {
+            double complex wk = 1;
+            for (k = 0; k < (longueur / 2); k++) {
+                double complex u = a[i + k];
+                double complex v = a[i + k + (longueur / 2)] * wk;
+                a[i + k] = u + v;
+                a[i + k + (longueur / 2)] = u - v;
+                wk *= w;
+            }
+        }
+    }
+}
+
+//----------------------------------------------------------------------------
+//  TestRose
+//  Densit moyenne par octave de raies [b, 2b[, b = 4 .. 1024 : la pente
+//  entre octaves voisines doit rester proche de -3 dB
+//----------------------------------------------------------------------------
+
+static void TestRose(S_Bruit *pBruit) {
+    static double complex segment[TEST_LONGUEUR_FFT];
+    static double densite[TEST_LONGUEUR_FFT / 2];
+    long i;
+    long s;
+    int k;
+    int bas;
+    int min = 0;
+    int max = 0;
+    double precedent = 0;
+    char nom[40];
+
+    for (i = 0; i < TEST_NB_ECH; i++) {
+        echantillons[i] = BRUIT_Suivant(pBruit, SignalBruitRose);
+        if (echantillons[i] < min) {
+            min = echantillons[i];
+        }
+        if (echantillons[i] > max) {
+            max = echantillons[i];
+        }
+    }
+    for (s = 0; s < (TEST_NB_ECH / TEST_LONGUEUR_FFT); s++) {
+        for (k = 0; k < TEST_LONGUEUR_FFT; k++) {
+            segment[k] = echantillons[(s * TEST_LONGUEUR_FFT) + k]
+                    * (0.5 - (0.5 * cos(2 * M_PI * k / TEST_LONGUEUR_FFT)));
+        }
+        Fft(segment, TEST_LONGUEUR_FFT);
+        for (k = 0; k < (TEST_LONGUEUR_FFT / 2); k++) {
+            densite[k] += creal(segment[k] * conj(segment[k]));
+        }
+    }
+
+    printf("Bruit rose (%ld chantillons)\n", TEST_NB_ECH);
+    Verifie("minimum", min, -SIGNAL_CRETE, 0);
+    Verifie("maximum", max, 0, SIGNAL_CRETE);
+    for (bas = 4; bas <= 1024; bas *= 2) {
+        double moyenne = 0;
+        double db;
+        for (k = bas; k < (2 * bas); k++) {
+            moyenne += densite[k];
+        }
+        db = 10 * log10(moyenne / bas);
+        if (bas > 4) {
+            snprintf(nom, sizeof(nom), "pente octave %d-%d", bas, 2 * bas);
+            Verifie(nom, db - precedent, TEST_PENTE_MIN, TEST_PENTE_MAX);
+        }
+        precedent = db;
+    }
+}
+
+//----------------------------------------------------------------------------
+//  TestPrbs
+//  Priode mesure depuis un registre nul (relance  1 attendue)
+//----------------------------------------------------------------------------
+
+static void TestPrbs(S_Bruit *pBruit, E_FormesSignal forme, uint8_t ordre) {
+    uint32_t periodeAttendue = (1u << ordre) - 1;
+    uint32_t depart;
+    uint32_t periode = 0;
+    uint32_t uns = 0;
+    uint32_t i;
+
+    pBruit->Lfsr = 0;
+    for (i = 0; i < 1000; i++) {
+        BRUIT_Suivant(pBruit, forme);
+    }
+    depart = pBruit->Lfsr & periodeAttendue;
+    do {
+        if (BRUIT_Suivant(pBruit, forme) > 0) {
+            uns++;
+        }
+        periode++;
+    } while (((pBruit->Lfsr & periodeAttendue) != depart) && (periode <= periodeAttendue));
+
+    printf("PRBS%u\n", ordre);
+    Verifie("priode", periode, periodeAttendue, periodeAttendue);
+    Verifie("nombre de 1", uns, (periodeAttendue + 1) / 2, (periodeAttendue + 1) / 2);
+    Verifie("nombre de 0", periode - uns, (periodeAttendue - 1) / 2, (periodeAttendue - 1) / 2);
+}
+
+int main(void) {
+    S_Bruit bruit;
+
+    BRUIT_Init(&bruit, TEST_GRAINE);
+    TestBlanc(&bruit);
+    TestRose(&bruit);
+    TestPrbs(&bruit, SignalPrbs7, 7);
+    TestPrbs(&bruit, SignalPrbs15, 15);
+    TestPrbs(&bruit, SignalPrbs23, 23);
+
+    printf("%d erreur(s)\n", nbErreurs);
+    return (nbErreurs == 0) ? 0 : 1;
+}
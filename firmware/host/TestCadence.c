@@ -0,0 +1,107 @@
+// TestCadence.c
+// Contrle du modle de temps du DAC (GesDac, compilation PC) : cadence
+// maximale du gnrateur selon la cible et le nombre de canaux
+//
+//  Horloge SPI : SCK obtenue pour la demande de chaque cible (MX : PBCLK
+//               80 MHz, demande 20 MHz ; MZ : PBCLK2 100 MHz, demande
+//               25 MHz), arrondis et limites de la demande.
+//  Cadence     : dure des trames d'une mise  jour et cadence maximale
+//               pour 1 et 4 canaux, limite ensuite  GENSIG_FECH_MAX et
+//               au Timer3 (horloge / GENSIG_PERIODE_MIN) comme par
+//               GENSIG_FechMax, puis frquence maximale du signal
+//               (GENSIG_LONGUEUR_MIN points par priode).
+//
+//  Retourne 0 si toutes les mesures sont dans les tolrances.
+//
+//---------------------------------------------------------------------------
+
+#include <stdbool.h>
+#include <stdio.h>
+#include "GesDac.h"
+#include "Generateur.h"
+
+static int nbErreurs = 0;
+
+//----------------------------------------------------------------------------
+//  Verifie
+//  Affiche une mesure et compte l'erreur si elle est hors tolrance
+//----------------------------------------------------------------------------
+
+static void Verifie(const char *nom, double valeur, double min, double max) {
+    bool ok = (valeur >= min) && (valeur <= max);
+
+    printf("  %-28s %12.2f  [%g .. %g] %s\n", nom, valeur, min, max, ok ? "ok" : "ERREUR");
+    if (!ok) {
+        nbErreurs++;
+    }
+}
+
+//----------------------------------------------------------------------------
+//  FechMax
+//  Mme limitation que GENSIG_FechMaxPour (Generateur.c) : DAC, puis
+//  gnrateur, puis Timer3 cadenc par le bus priphrique
+//----------------------------------------------------------------------------
+
+static uint32_t FechMax(uint32_t sck, uint8_t nbCanaux, uint32_t horlogeTimer) {
+    uint32_t fechMax = DAC_FechMax(sck, nbCanaux);
+
+    if (fechMax > GENSIG_FECH_MAX) {
+        fechMax = GENSIG_FECH_MAX;
+    }
+    if (fechMax > (horlogeTimer / GENSIG_PERIODE_MIN)) {
+        fechMax = horlogeTimer / GENSIG_PERIODE_MIN;
+    }
+    return fechMax;
+}
+
+//----------------------------------------------------------------------------
+//  TestCible
+//  Valeurs attendues : SCK, dure et cadence du DAC seul pour 1 et 4
+//  canaux
+//----------------------------------------------------------------------------
+
+static void TestCible(const char *nom, uint32_t horlogeBus, uint32_t demande,
+        uint32_t sckAttendue, uint32_t temps1, uint32_t temps4) {
+    uint32_t sck = DAC_SckPossible(horlogeBus, demande);
+    uint32_t fech1 = FechMax(sck, 1, horlogeBus);
+    uint32_t fech4 = FechMax(sck, 4, horlogeBus);
+
+    printf("%s : bus %lu Hz, demande %lu Hz\n", nom, (unsigned long) horlogeBus,
+            (unsigned long) demande);
+    Verifie("SCK (Hz)", sck, sckAttendue, sckAttendue);
+    Verifie("trame 1 canal (ns)", DAC_TempsMotsNs(sck, DAC_MOTS_PAR_MAJ(1)), temps1, temps1);
+    Verifie("trames 4 canaux (ns)", DAC_TempsMotsNs(sck, DAC_MOTS_PAR_MAJ(4)), temps4, temps4);
+    Verifie("DAC 1 canal (S/s)", DAC_FechMax(sck, 1),
+            1000000000u / temps1, 1000000000u / temps1);
+    Verifie("DAC 4 canaux (S/s)", DAC_FechMax(sck, 4),
+            1000000000u / temps4, 1000000000u / temps4);
+    // Un canal : limit par le gnrateur, pas par le DAC
+    Verifie("Fech max 1 canal (S/s)", fech1, GENSIG_FECH_MAX, GENSIG_FECH_MAX);
+    Verifie("Fech max 4 canaux (S/s)", fech4, 1000000000u / temps4, 1000000000u / temps4);
+    Verifie("Fmax 1 canal (Hz)", fech1 / GENSIG_LONGUEUR_MIN,
+            GENSIG_FECH_MAX / GENSIG_LONGUEUR_MIN, GENSIG_FECH_MAX / GENSIG_LONGUEUR_MIN);
+    Verifie("Fmax 4 canaux (Hz)", fech4 / GENSIG_LONGUEUR_MIN,
+            (1000000000u / temps4) / GENSIG_LONGUEUR_MIN,
+            (1000000000u / temps4) / GENSIG_LONGUEUR_MIN);
+}
+
+int main(void) {
+    // SCK = 32 bits arrondis au ns suprieur + DAC_TEMPS_CS_NS par trame,
+    // 1 trame pour un canal, 5 pour quatre
+    TestCible("MX", 80000000, 20000000, 20000000, 1700, 8500);
+    TestCible("MZ", 100000000, 25000000, 25000000, 1380, 6900);
+
+    printf("Horloge SPI, cas limites (MX)\n");
+    Verifie("50 MHz -> 40 MHz", DAC_SckPossible(80000000, 50000000), 40000000, 40000000);
+    Verifie("30 MHz -> 20 MHz", DAC_SckPossible(80000000, 30000000), 20000000, 20000000);
+    Verifie("1 MHz", DAC_SckPossible(80000000, 1000000), 1000000, 1000000);
+    Verifie("sous le minimum", DAC_SckPossible(80000000, DAC_FREQ_SPI_MIN - 1), 0, 0);
+    Verifie("au-dessus du maximum", DAC_SckPossible(80000000, DAC_FREQ_SPI_MAX + 1), 0, 0);
+    Verifie("SCK nulle : dure", DAC_TempsMotsNs(0, 1), UINT32_MAX, UINT32_MAX);
+    Verifie("SCK nulle : cadence", DAC_FechMax(0, 1), 0, 0);
+    // 1 MHz, 4 canaux : 5 trames de 32.1 us
+    Verifie("1 MHz 4 canaux (S/s)", DAC_FechMax(1000000, 4), 6230, 6230);
+
+    printf("%d erreur(s)\n", nbErreurs);
+    return (nbErreurs == 0) ? 0 : 1;
+}
@@ -0,0 +1,203 @@
+// TestCaptureDac.c
+// Capture des mots SPI envoys au DAC par l'application complte
+// (simulateur)  la frquence maximale annonce : la cadence limite de
+// GENSIG_FechMax tient-elle sur le bus ?
+//
+// Compil deux fois : TestCaptureDac (gensim, 1 canal) et
+// TestCaptureDac4 (gensim_4canaux, GENSIG_NB_CANAUX = 4).
+//
+//  Pour SCK = 20 MHz (horloge de dpart) puis 2 MHz ("gen spi") :
+//   - trame de rglage  GENSIG_FrequenceMax par le client TCP virtuel,
+//     puis la mme frquence + 1 Hz, qui doit tre refuse
+//   - 20 ms de capture : mises  jour espaces de PR3 + 1 pas de PBCLK,
+//     DAC_MOTS_PAR_MAJ(GENSIG_NB_CANAUX) mots par mise  jour, dure
+//     d'une trame de DAC_BITS_PAR_MOT coups de SCK, aucun mot demand
+//     pendant la trame prcdente, mots d'une mise  jour termins avant
+//     l'chantillon suivant (CS du dernier mot remonte au plus tard 
+//     l'chantillon suivant avec DAC_NON_BLOQUANT)
+//   - plusieurs canaux : le canal k sort l'chantillon du canal 0 dcal
+//     de k / GENSIG_NB_CANAUX priode
+//
+//  Retourne 0 si toutes les mesures sont dans les tolrances.
+//
+//---------------------------------------------------------------------------
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include "Simulation.h"
+#include "Generateur.h"
+#include "appgen.h"
+#include "Mc32gestSpiDac.h"
+#include "peripheral/tmr/plib_tmr.h"
+
+static int nbErreurs = 0;
+
+//----------------------------------------------------------------------------
+//  Verifie
+//  Affiche une mesure et compte l'erreur si elle est hors tolrance
+//----------------------------------------------------------------------------
+
+static void Verifie(const char *nom, double valeur, double min, double max) {
+    bool ok = (valeur >= min) && (valeur <= max);
+
+    printf("  %-28s %12.2f  [%g .. %g] %s\n", nom, valeur, min, max, ok ? "ok" : "ERREUR");
+    if (!ok) {
+        nbErreurs++;
+    }
+}
+
+//----------------------------------------------------------------------------
+//  EnvoieTrame
+//  Rglage sinus  la frquence donne par le client TCP virtuel, puis
+//  attente de la rponse et de la construction de la table
+//----------------------------------------------------------------------------
+
+static void EnvoieTrame(int frequence) {
+    char trame[32];
+    char reponse[64];
+
+    snprintf(trame, sizeof (trame), "!S=SF=%dA=10000O=+0W=0#", frequence);
+    SIM_TcpEnvoie(trame, (uint16_t) strlen(trame));
+    SIM_Tourne(SIM_MS(100));
+    SIM_TcpRecoit(reponse, sizeof (reponse));
+}
+
+//----------------------------------------------------------------------------
+//  Commande
+//  Commande console, excute puis sortie vide
+//----------------------------------------------------------------------------
+
+static void Commande(const char *ligne) {
+    char texte[512];
+
+    SIM_ConsoleLit(texte, sizeof (texte));
+    SIM_Commande(ligne);
+    SIM_Tourne(SIM_MS(10));
+    SIM_ConsoleLit(texte, sizeof (texte));
+    printf("  > %s\n    %s", ligne, texte);
+}
+
+//----------------------------------------------------------------------------
+//  Capture
+//  20 ms de mots SPI et de mises  jour, contrles dcrits en tte
+//----------------------------------------------------------------------------
+
+static void Capture(void) {
+    const S_SimMotDac *pMots;
+    const S_SimMajDac *pMaj;
+    uint64_t periode = PLIB_TMR_Period16BitGet(TMR_ID_3) + 1u;
+    uint64_t trameNs = DAC_TempsMotsNs(SPI_FrequenceDac(), 1) - DAC_TEMPS_CS_NS;
+    uint64_t ecartMin = UINT64_MAX;
+    uint64_t ecartMax = 0;
+    uint64_t trameMin = UINT64_MAX;
+    uint64_t occupationMax = 0;
+    uint32_t nbMots;
+    uint32_t nbMaj;
+    uint32_t i;
+    uint32_t erreursPhase = 0;
+    uint8_t motsParMaj = DAC_MOTS_PAR_MAJ(GENSIG_NB_CANAUX);
+
+    SIM_DacRaz();
+    SIM_Tourne(SIM_MS(20));
+    pMots = SIM_DacMots();
+    pMaj = SIM_DacMaj();
+    nbMots = SIM_DacNbMots();
+    nbMaj = SIM_DacNbMaj();
+
+    for (i = 1; i < nbMaj; i++) {
+        uint64_t ecart = pMaj[i].Temps - pMaj[i - 1].Temps;
+        if (ecart < ecartMin) {
+            ecartMin = ecart;
+        }
+        if (ecart > ecartMax) {
+            ecartMax = ecart;
+        }
+    }
+    // Mots d'une mise  jour : du premier dpt  la fin du dcalage du
+    // dernier
+    for (i = 0; i + motsParMaj <= nbMots; i += motsParMaj) {
+        uint64_t occupation = pMots[i + motsParMaj - 1].Debut
+                + SIM_NS(trameNs) - pMots[i].Debut;
+        uint32_t k;
+        if (occupation > occupationMax) {
+            occupationMax = occupation;
+        }
+        for (k = i; k < i + motsParMaj; k++) {
+            if ((pMots[k].Fin - pMots[k].Debut) < trameMin) {
+                trameMin = pMots[k].Fin - pMots[k].Debut;
+            }
+        }
+    }
+#if GENSIG_NB_CANAUX > 1
+    {
+        uint16_t longueur = GENSIG_LongueurActive();
+        uint16_t dephasage = longueur / GENSIG_NB_CANAUX;
+        uint8_t canal;
+
+        for (i = 0; i + longueur < nbMaj; i++) {
+            for (canal = 1; canal < GENSIG_NB_CANAUX; canal++) {
+                if (pMaj[i].Valeurs[canal] != pMaj[i + (canal * dephasage)].Valeurs[0]) {
+                    erreursPhase++;
+                }
+            }
+        }
+    }
+#endif
+
+    printf("  periode %llu pas (%llu ns), %u points\n", (unsigned long long) periode,
+            (unsigned long long) SIM_EN_NS(periode), GENSIG_LongueurActive());
+    Verifie("mises a jour / 20 ms", nbMaj, (SIM_MS(20) / periode) - 1,
+            (SIM_MS(20) / periode) + 1);
+    Verifie("mots par mise a jour", (double) nbMots / nbMaj,
+            motsParMaj - 0.01, motsParMaj + 0.01);
+    Verifie("ecart min [pas]", ecartMin, periode, periode);
+    Verifie("ecart max [pas]", ecartMax, periode, periode);
+    Verifie("trame min [ns]", SIM_EN_NS(trameMin), trameNs - 13, SIM_EN_NS(periode));
+    Verifie("occupation SPI [ns]", SIM_EN_NS(occupationMax), 0, SIM_EN_NS(periode));
+    Verifie("chevauchements", SIM_DacNbChevauchements(), 0, 0);
+    Verifie("mots perdus", SIM_DacNbPerdus(), 0, 0);
+    Verifie("erreurs de phase", erreursPhase, 0, 0);
+}
+
+//----------------------------------------------------------------------------
+//  TesteFrequenceMax
+//  Frquence maximale accepte et tenue, +1 Hz refus
+//----------------------------------------------------------------------------
+
+static void TesteFrequenceMax(void) {
+    int16_t frequenceMax = GENSIG_FrequenceMax();
+
+    printf("sck %lu Hz, fech max %lu S/s, f max %d Hz\n",
+            (unsigned long) SPI_FrequenceDac(), (unsigned long) GENSIG_FechMax(),
+            frequenceMax);
+    EnvoieTrame(frequenceMax);
+    Verifie("frequence acceptee", RemoteParamGen.Frequence, frequenceMax, frequenceMax);
+    Capture();
+    EnvoieTrame(frequenceMax + 1);
+    Verifie("f max + 1 refusee", RemoteParamGen.Frequence, frequenceMax, frequenceMax);
+}
+
+int main(void) {
+    printf("%u canal(aux), %u mots par mise a jour\n", (unsigned) GENSIG_NB_CANAUX,
+            (unsigned) DAC_MOTS_PAR_MAJ(GENSIG_NB_CANAUX));
+
+    // Dmarrage, fin de l'affichage de l'adresse IP, connexion du client
+    SIM_NvmFichier(NULL);
+    SYS_Initialize(NULL);
+    SIM_Tourne(SIM_MS(9000));
+    SIM_TcpConnecte();
+    SIM_Tourne(SIM_MS(10));
+
+    TesteFrequenceMax();
+
+    // SCK abaisse  2 MHz (frquence basse d'abord : le changement est
+    // refus si la frquence en cours ne tient plus)
+    EnvoieTrame(100);
+    Commande("gen spi 2000000");
+    Verifie("sck [Hz]", SPI_FrequenceDac(), 2000000, 2000000);
+    TesteFrequenceMax();
+
+    printf("%d erreur(s)\n", nbErreurs);
+    return (nbErreurs == 0) ? 0 : 1;
+}
@@ -0,0 +1,180 @@
+// TestCrans.c
+// Crans rapides du PEC12  travers l'application complte (simulateur) :
+// broches A et B, anti-rebond, file GesEvent, regroupement des crans par
+// MENU_ChargeEvenement et acclration de Pec12MemoCrans / Pec12Pas
+//
+//  Regroupement : 9 crans espacs de 20 ms sur la frquence (pas
+//               FREQUENCE_MIN, facteur ACCEL_FREQUENCE) ; la boucle
+//               principale est bloque 60 ms pendant les crans 2  4 et
+//               6  8 (pas de service, chantillons en attente). Groupes
+//               attendus 1, 3, 1, 3, 1 ; le premier cran est lent (aucun
+//               cran avant), les suivants au facteur maximum
+//  Borne abaisse : frquence en cours de rglage au-dessus de la borne
+//               aprs "gen spi" (horloge plus lente) ; un cran vers le bas
+//               ramne sur MENU_FrequenceMax, multiple de FREQUENCE_MIN
+//
+//  Retourne 0 si toutes les mesures sont dans les tolrances.
+//
+//---------------------------------------------------------------------------
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Simulation.h"
+#include "Generateur.h"
+#include "GesPec12.h"
+#include "MenuGen.h"
+#include "appgen.h"
+
+// Cran de 20 ms : A descend, B descend (5 ms), A remonte (10 ms), B
+// remonte (15 ms) ; sens inverse en changeant A et B
+#define TEST_CRAN_MS 20
+#define TEST_NB_CRANS 9
+#define TEST_NB_GROUPES 5
+
+extern S_Pec12_Descriptor Pec12;
+
+static int nbErreurs = 0;
+
+//----------------------------------------------------------------------------
+//  Verifie
+//  Affiche une mesure et compte l'erreur si elle est hors tolrance
+//----------------------------------------------------------------------------
+
+static void Verifie(const char *nom, double valeur, double min, double max) {
+    bool ok = (valeur >= min) && (valeur <= max);
+
+    printf("  %-28s %12.2f  [%g .. %g] %s\n", nom, valeur, min, max, ok ? "ok" : "ERREUR");
+    if (!ok) {
+        nbErreurs++;
+    }
+}
+
+//----------------------------------------------------------------------------
+//  FrequenceAffichee
+//  Frquence de la ligne 2 du LCD (valeur en cours de rglage)
+//----------------------------------------------------------------------------
+
+static int FrequenceAffichee(void) {
+    const char *pEgal = strchr(SIM_LcdLigne(2), '=');
+
+    return (pEgal != NULL) ? atoi(pEgal + 1) : -1;
+}
+
+//----------------------------------------------------------------------------
+//  Crans
+//  nb crans dans le sens horaire (B d'abord, Pec12IsPlus) ou anti-horaire
+//  (A d'abord, Pec12IsMinus), la boucle principale tournant sauf entre
+//  les instants [debutBlocage, finBlocage[ de chaque paire (ms depuis le
+//  dbut des crans). Chaque groupe de crans trait par le menu est not
+//  dans pGroupes (nombre de crans)
+//----------------------------------------------------------------------------
+
+static uint8_t Crans(uint8_t nb, bool horaire, const uint16_t (*pBlocages)[2],
+        uint8_t nbBlocages, uint8_t *pGroupes, uint8_t nbGroupesMax) {
+    uint32_t dernierCran = Pec12.DernierCran;
+    uint8_t nbGroupes = 0;
+    uint64_t fin;
+    uint16_t t;
+
+    for (t = 0; t < (nb * TEST_CRAN_MS) + 50; t++) {
+        uint16_t phase = t % TEST_CRAN_MS;
+        bool actif = (t < (nb * TEST_CRAN_MS));
+        bool premier = actif && (phase < 10);
+        bool second = actif && (phase >= 5) && (phase < 15);
+        bool bloque = false;
+        uint8_t i;
+
+        SimBroches.Pec12A = horaire ? !second : !premier;
+        SimBroches.Pec12B = horaire ? !premier : !second;
+        for (i = 0; i < nbBlocages; i++) {
+            if ((t >= pBlocages[i][0]) && (t < pBlocages[i][1])) {
+                bloque = true;
+            }
+        }
+        if (bloque) {
+            SIM_Avance(SIM_MS(1));
+            continue;
+        }
+        fin = SIM_Temps() + SIM_MS(1);
+        while (SIM_Temps() < fin) {
+            SIM_Tour();
+            if (Pec12.DernierCran != dernierCran) {
+                dernierCran = Pec12.DernierCran;
+                if (nbGroupes < nbGroupesMax) {
+                    pGroupes[nbGroupes] = Pec12.NbPas;
+                }
+                nbGroupes++;
+            }
+        }
+    }
+    return nbGroupes;
+}
+
+//----------------------------------------------------------------------------
+//  Appui
+//  Appui court sur le bouton du PEC12 (OK)
+//----------------------------------------------------------------------------
+
+static void Appui(void) {
+    SimBroches.Pec12PB = 0;
+    SIM_Tourne(SIM_MS(30));
+    SimBroches.Pec12PB = 1;
+    SIM_Tourne(SIM_MS(30));
+}
+
+int main(void) {
+    static const uint16_t blocages[2][2] = {
+        {TEST_CRAN_MS, 4 * TEST_CRAN_MS}, {5 * TEST_CRAN_MS, 8 * TEST_CRAN_MS}
+    };
+    static const uint8_t groupesAttendus[TEST_NB_GROUPES] = {1, 3, 1, 3, 1};
+    uint8_t groupes[TEST_NB_GROUPES + 4];
+    uint8_t nbGroupes;
+    uint8_t i;
+    int depart;
+    int attendue;
+    int borne;
+    char texte[512];
+
+    // Dmarrage, fin de l'affichage de l'adresse IP : menu local
+    SIM_NvmFichier(NULL);
+    SYS_Initialize(NULL);
+    SIM_Tourne(SIM_MS(9000));
+
+    // Slection de la frquence, puis rglage
+    Crans(1, true, NULL, 0, groupes, 0);
+    Appui();
+    depart = FrequenceAffichee();
+    printf("Regroupement (depart %d Hz, ecran \"%s\")\n", depart, SIM_LcdLigne(2));
+
+    nbGroupes = Crans(TEST_NB_CRANS, false, blocages, 2, groupes, sizeof (groupes));
+    Verifie("groupes", nbGroupes, TEST_NB_GROUPES, TEST_NB_GROUPES);
+    for (i = 0; (i < nbGroupes) && (i < TEST_NB_GROUPES); i++) {
+        char nom[32];
+        snprintf(nom, sizeof (nom), "crans du groupe %u", (unsigned) (i + 1));
+        Verifie(nom, groupes[i], groupesAttendus[i], groupesAttendus[i]);
+    }
+    // Premier cran lent, les 8 suivants au facteur maximum
+    attendue = depart + FREQUENCE_MIN + ((TEST_NB_CRANS - 1) * FREQUENCE_MIN * ACCEL_FREQUENCE);
+    Verifie("frequence reglee [Hz]", FrequenceAffichee(), attendue, attendue);
+
+    // Horloge SPI abaisse pendant le rglage (frquence applique basse)
+    printf("Borne abaissee\n");
+    SIM_ConsoleLit(texte, sizeof (texte));
+    SIM_Commande("gen spi 2000000");
+    SIM_Tourne(SIM_MS(20));
+    SIM_ConsoleLit(texte, sizeof (texte));
+    borne = GENSIG_FrequenceMax() - (GENSIG_FrequenceMax() % FREQUENCE_MIN);
+    printf("  f max %d Hz, borne du menu %d Hz\n", GENSIG_FrequenceMax(), borne);
+    Verifie("reglage au-dessus [Hz]", FrequenceAffichee(), borne + 1, FREQUENCE_MAX);
+    // Cran lent (au-del de PEC12_ACCEL_LENT) : un seul pas de base
+    SIM_Tourne(SIM_MS(200));
+    Crans(1, true, NULL, 0, groupes, 0);
+    Verifie("un cran vers le bas [Hz]", FrequenceAffichee(), borne, borne);
+    Appui();
+    Verifie("frequence appliquee [Hz]", LocalParamGen.Frequence, borne, borne);
+
+    printf("%d erreur(s)\n", nbErreurs);
+    return (nbErreurs == 0) ? 0 : 1;
+}
@@ -0,0 +1,249 @@
+// TestRepliement.c
+// Contrle du carr et de la dent de scie  bande limite de GesSignal
+// (compilation PC)
+//
+//  Repliement : cart entre le spectre de la table (raies 1 .. N/2) et les
+//               coefficients de Fourier exacts de la forme idale limite
+//                k < N/2, rapport  l'nergie de la forme. Mesur pour
+//               la table  bande limite et pour la forme nave (calcule
+//               ici, mme mise  l'chelle), qui replie les harmoniques
+//               au-del de N/2.
+//  Construction par tapes : table identique qu'elle soit construite d'un
+//               coup, entrecoupe d'une autre demande de forme, ou
+//               abandonne puis relance ; dure de la pire tape.
+//  Saturation : amplitude et offset au-del de MAX_AMPLITUDE (limites de
+//               int16_t) donnent la table des bornes, sans dbordement.
+//
+//  Retourne 0 si toutes les mesures sont dans les tolrances.
+//
+//---------------------------------------------------------------------------
+
+#include <complex.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "GesSignal.h"
+#include "Generateur.h"
+
+#define TEST_AMPLITUDE 5000
+// Erreur maximum de la table  bande limite, gain minimum sur la forme
+// nave (dB)
+#define TEST_ERREUR_BL_MAX (-75.0)
+#define TEST_GAIN_MIN 50.0
+
+static uint16_t table[GENSIG_LONGUEUR_MAX];
+static uint16_t reference[GENSIG_LONGUEUR_MAX];
+static int nbErreurs = 0;
+
+//----------------------------------------------------------------------------
+//  Verifie
+//  Affiche une mesure et compte l'erreur si elle est hors tolrance
+//----------------------------------------------------------------------------
+
+static void Verifie(const char *nom, double valeur, double min, double max) {
+    bool ok = (valeur >= min) && (valeur <= max);
+
+    printf("  %-28s %12.2f  [%g .. %g] %s\n", nom, valeur, min, max, ok ? "ok" : "ERREUR");
+    if (!ok) {
+        nbErreurs++;
+    }
+}
+
+//----------------------------------------------------------------------------
+//  ErreurSpectre
+//  Energie de l'cart  la forme idale limite  k < N/2, rapporte 
+//  l'nergie de celle-ci (dB). Composante continue retire.
+//----------------------------------------------------------------------------
+
+static double ErreurSpectre(const uint16_t *pTable, uint16_t longueur, E_FormesSignal forme) {
+    double crete = (double) SIGNAL_CRETE * TEST_AMPLITUDE * VAL_MAX_PAS
+            / ((double) MAX_AMPLITUDE * 2 * SIGNAL_CRETE);
+    double moyenne = 0;
+    double erreur = 0;
+    double energie = 0;
+    uint16_t k;
+    uint16_t n;
+
+    for (n = 0; n < longueur; n++) {
+        moyenne += pTable[n];
+    }
+    moyenne /= longueur;
+    for (k = 1; k <= (longueur / 2); k++) {
+        double complex x = 0;
+        double complex ideal = 0;
+        for (n = 0; n < longueur; n++) {
+            x += (pTable[n] - moyenne) * cexp(-2 * M_PI * I * k * n / longueur);
+        }
+        if (k < (longueur / 2)) {
+            double c;
+            if (forme == SignalCarre) {
+                c = (k % 2) ? 4 / (M_PI * k) : 0;
+            } else {
+                c = -2 / (M_PI * k);
+            }
+            ideal = crete * c / (2 * I) * longueur;
+        }
+        erreur += cabs(x - ideal) * cabs(x - ideal);
+        energie += cabs(ideal) * cabs(ideal);
+    }
+    return 10 * log10(erreur / energie);
+}
+
+//----------------------------------------------------------------------------
+//  TableNaive
+//  Carr ou dent sans limitation de bande, mis  l'chelle comme par
+//  SIGNAL_CalculeTable
+//----------------------------------------------------------------------------
+
+static void TableNaive(const S_ParamGen *pParam, uint16_t *pTable, uint16_t longueur) {
+    int32_t milieu;
+    int32_t gain;
+    int32_t n;
+    int32_t forme;
+
+    SIGNAL_CalculeEchelle(pParam, &milieu, &gain);
+    for (n = 0; n < longueur; n++) {
+        if (pParam->Forme == SignalCarre) {
+            forme = (n < (longueur / 2)) ? SIGNAL_CRETE : -SIGNAL_CRETE;
+        } else {
+            forme = (2 * SIGNAL_CRETE * (n - (longueur / 2))) / longueur;
+        }
+        pTable[n] = (uint16_t) ((milieu + (forme * gain) + (1 << 13)) >> 14);
+    }
+}
+
+//----------------------------------------------------------------------------
+//  TestRepliement
+//----------------------------------------------------------------------------
+
+static void TestRepliement(E_FormesSignal forme) {
+    S_ParamGen param = {forme, 20, TEST_AMPLITUDE, 0, 0};
+    uint16_t longueur;
+    char nom[40];
+
+    printf("%s, amplitude %d (dB)\n", (forme == SignalCarre) ? "Carr" : "Dent de scie",
+            TEST_AMPLITUDE);
+    // Calcul en O(N^2) : limit  1024 points
+    for (longueur = GENSIG_LONGUEUR_MIN; longueur <= 1024; longueur *= 2) {
+        double bandeLimitee;
+        double naive;
+
+        SIGNAL_CalculeTable(&param, table, longueur);
+        bandeLimitee = ErreurSpectre(table, longueur, forme);
+        TableNaive(&param, table, longueur);
+        naive = ErreurSpectre(table, longueur, forme);
+        printf("  N=%-5u nave %7.1f\n", longueur, naive);
+        snprintf(nom, sizeof(nom), "bande limite N=%u", longueur);
+        Verifie(nom, bandeLimitee, -200, TEST_ERREUR_BL_MAX);
+        snprintf(nom, sizeof(nom), "gain N=%u", longueur);
+        Verifie(nom, naive - bandeLimitee, TEST_GAIN_MIN, 200);
+    }
+}
+
+//----------------------------------------------------------------------------
+//  TestEtapes
+//  Une dent de GENSIG_LONGUEUR_MAX / 2 points construite d'un coup sert de
+//  rfrence, puis :
+//    entrecoupe  un sinus est demand au milieu de la construction
+//    relance     un carr remplace la construction, puis la dent est
+//                 redemande
+//----------------------------------------------------------------------------
+
+static void TestEtapes(void) {
+    S_ParamGen param = {SignalDentDeScie, 20, MAX_AMPLITUDE, 0, 0};
+    uint16_t longueur = GENSIG_LONGUEUR_MAX / 2;
+    int etapes = 0;
+    double pire = 0;
+    clock_t debut;
+
+    printf("Construction par tapes (dent, N=%u)\n", longueur);
+    SIGNAL_Init();
+    SIGNAL_CalculeTable(&param, reference, longueur);
+
+    SIGNAL_Init();
+    if (!SIGNAL_FormePrete(SignalDentDeScie, longueur)) {
+        do {
+            etapes++;
+            if (etapes == 10) {
+                SIGNAL_FormePrete(SignalSinus, GENSIG_LONGUEUR_MAX);
+            }
+        } while (SIGNAL_Avance());
+    }
+    Verifie("prte aprs les tapes", SIGNAL_FormePrete(SignalDentDeScie, longueur), 1, 1);
+    SIGNAL_CalculeTable(&param, table, longueur);
+    Verifie("entrecoupe identique", memcmp(table, reference, longueur * 2) == 0, 1, 1);
+
+    SIGNAL_Init();
+    SIGNAL_FormePrete(SignalDentDeScie, longueur);
+    SIGNAL_Avance();
+    SIGNAL_Avance();
+    SIGNAL_FormePrete(SignalCarre, GENSIG_LONGUEUR_MAX);
+    SIGNAL_Avance();
+    Verifie("dent non prte", SIGNAL_FormePrete(SignalDentDeScie, longueur), 0, 0);
+    SIGNAL_CalculeTable(&param, table, longueur);
+    Verifie("relance identique", memcmp(table, reference, longueur * 2) == 0, 1, 1);
+
+    // Pire tape du carr de longueur maximum
+    SIGNAL_Init();
+    SIGNAL_FormePrete(SignalCarre, GENSIG_LONGUEUR_MAX);
+    etapes = 0;
+    do {
+        bool encore;
+        double duree;
+        debut = clock();
+        encore = SIGNAL_Avance();
+        duree = (clock() - debut) * 1e6 / CLOCKS_PER_SEC;
+        if (duree > pire) {
+            pire = duree;
+        }
+        etapes++;
+        if (!encore) {
+            break;
+        }
+    } while (true);
+    printf("  carr N=%u : %d tapes, pire %.0f us (PC)\n", GENSIG_LONGUEUR_MAX, etapes, pire);
+}
+
+//----------------------------------------------------------------------------
+//  TestSaturation
+//  Sinus hors limites compar au sinus aux bornes : amplitude INT16_MAX
+//  contre MAX_AMPLITUDE, offsets INT16_MAX / INT16_MIN contre
+//  +/-MAX_AMPLITUDE
+//----------------------------------------------------------------------------
+
+static void TestSaturation(void) {
+    static const struct {
+        const char *nom;
+        S_ParamGen horsLimites;
+        S_ParamGen borne;
+    } cas[] = {
+        {"amplitude max", {SignalSinus, 20, INT16_MAX, 0, 0},
+            {SignalSinus, 20, MAX_AMPLITUDE, 0, 0}},
+        {"offset max", {SignalSinus, 20, MAX_AMPLITUDE, INT16_MAX, 0},
+            {SignalSinus, 20, MAX_AMPLITUDE, MAX_AMPLITUDE, 0}},
+        {"offset min", {SignalSinus, 20, MAX_AMPLITUDE, INT16_MIN, 0},
+            {SignalSinus, 20, MAX_AMPLITUDE, -MAX_AMPLITUDE, 0}},
+    };
+    uint16_t longueur = GENSIG_LONGUEUR_MAX;
+    unsigned i;
+
+    printf("Saturation (sinus, N=%u)\n", longueur);
+    SIGNAL_Init();
+    for (i = 0; i < sizeof (cas) / sizeof (cas[0]); i++) {
+        SIGNAL_CalculeTable(&cas[i].borne, reference, longueur);
+        SIGNAL_CalculeTable(&cas[i].horsLimites, table, longueur);
+        Verifie(cas[i].nom, memcmp(table, reference, longueur * 2) == 0, 1, 1);
+    }
+}
+
+int main(void) {
+    SIGNAL_Init();
+    TestRepliement(SignalCarre);
+    TestRepliement(SignalDentDeScie);
+    TestEtapes();
+    TestSaturation();
+
+    printf("%d erreur(s)\n", nbErreurs);
+    return (nbErreurs == 0) ? 0 : 1;
+}
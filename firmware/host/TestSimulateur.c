@@ -0,0 +1,194 @@
+// TestSimulateur.c
+// Contrle du simulateur avec l'application complte (gensim) : dmarrage,
+// cadence du DAC, trame TCP, sauvegarde en flash et console
+//
+//  Dmarrage  : cran d'accueil, puis adresse IP sur le LCD quand
+//               l'interface est prte
+//  LCD        : crans entiers dposs d'un coup au-del de la taille de
+//               la file (GesLcd) : dbordement, puis cran redessin, qui
+//               doit tre le dernier dpos
+//  DAC        : mises  jour des sorties sur 100 ms compares  la priode
+//               du Timer3 (PR3 + 1 pas de PBCLK), sans chevauchement
+//               de trames SPI
+//  TCP        : trame de rglage avec sauvegarde (W=1) du client virtuel,
+//               rponse du serveur, paramtres distants et page flash ;
+//               trame d'amplitude hors limites refuse
+//  Console    : "gen param" excute par SYS_CMD, texte sorti sans
+//               criture perdue ni crase ; "gen prof histo" envoy en
+//               entier par CONSOLE_Tasks, une ligne par point et par
+//               histogramme ; rapport de "gen sched" envoy en entier
+//
+//  Retourne 0 si toutes les mesures sont dans les tolrances.
+//
+//---------------------------------------------------------------------------
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include "Simulation.h"
+#include "Generateur.h"
+#include "appgen.h"
+#include "GesLcd.h"
+#include "GesMesure.h"
+#include "GesSched.h"
+#include "peripheral/tmr/plib_tmr.h"
+
+// Ecrans dposs sans vidage (24 octets par ligne, file de LCDQ_TAILLE)
+#define TEST_NB_ECRANS 30
+
+static int nbErreurs = 0;
+
+//----------------------------------------------------------------------------
+//  Verifie
+//  Affiche une mesure et compte l'erreur si elle est hors tolrance
+//----------------------------------------------------------------------------
+
+static void Verifie(const char *nom, double valeur, double min, double max) {
+    bool ok = (valeur >= min) && (valeur <= max);
+
+    printf("  %-28s %12.2f  [%g .. %g] %s\n", nom, valeur, min, max, ok ? "ok" : "ERREUR");
+    if (!ok) {
+        nbErreurs++;
+    }
+}
+
+//----------------------------------------------------------------------------
+//  EcranVide
+//  true si aucune ligne du LCD ne contient de caractre visible
+//----------------------------------------------------------------------------
+
+static bool EcranVide(void) {
+    uint8_t ligne;
+
+    for (ligne = 1; ligne <= SIM_LCD_LIGNES; ligne++) {
+        if (strspn(SIM_LcdLigne(ligne), " ") != SIM_LCD_COLONNES) {
+            return false;
+        }
+    }
+    return true;
+}
+
+//----------------------------------------------------------------------------
+//  CompteLignes
+//  Nombre de lignes termines par "\r\n" dans un texte
+//----------------------------------------------------------------------------
+
+static uint16_t CompteLignes(const char *pTexte) {
+    uint16_t nb = 0;
+
+    for (pTexte = strstr(pTexte, "\r\n"); pTexte != NULL; pTexte = strstr(pTexte + 2, "\r\n")) {
+        nb++;
+    }
+    return nb;
+}
+
+static void AfficheEcran(void) {
+    uint8_t ligne;
+
+    for (ligne = 1; ligne <= SIM_LCD_LIGNES; ligne++) {
+        printf("    |%s|\n", SIM_LcdLigne(ligne));
+    }
+}
+
+int main(void) {
+    char texte[2048];
+    char rapport[512];
+    uint32_t attendues;
+    uint16_t nb;
+    uint8_t ligne;
+    uint8_t i;
+    uint8_t nbLignes;
+    const char *pLigne;
+
+    SIM_NvmFichier(NULL);
+    SYS_Initialize(NULL);
+
+    printf("Demarrage\n");
+    SIM_Tourne(SIM_MS(200));
+    AfficheEcran();
+    Verifie("ecran d'accueil", !EcranVide(), 1, 1);
+
+    // Avant le dpart des tches de service : l'cran n'est crit que
+    // par le test
+    printf("LCD\n");
+    for (i = 1; i <= TEST_NB_ECRANS; i++) {
+        for (ligne = 1; ligne <= SIM_LCD_LIGNES; ligne++) {
+            LCDQ_Gotoxy(1, ligne);
+            LCDQ_Printf("ecran %02u ligne %u    ", (unsigned) i, (unsigned) ligne);
+        }
+    }
+    SIM_Tourne(SIM_MS(500));
+    AfficheEcran();
+    Verifie("commandes perdues", LcdQueue.NbPerdus, 1, TEST_NB_ECRANS * SIM_LCD_LIGNES * 2);
+    Verifie("ecrans redessines", LcdQueue.NbRedessins, 1, 1);
+    for (ligne = 1; ligne <= SIM_LCD_LIGNES; ligne++) {
+        char attendue[SIM_LCD_COLONNES + 1];
+        snprintf(attendue, sizeof (attendue), "ecran %02u ligne %u    ",
+                (unsigned) TEST_NB_ECRANS, (unsigned) ligne);
+        Verifie("ligne du dernier ecran", strcmp(SIM_LcdLigne(ligne), attendue) == 0, 1, 1);
+    }
+    SIM_Tourne(SIM_MS(3000));
+    AfficheEcran();
+    Verifie("adresse IP", strstr(SIM_LcdLigne(3), "192.168.100.115") != NULL, 1, 1);
+
+    printf("DAC\n");
+    SIM_DacRaz();
+    SIM_Tourne(SIM_MS(100));
+    attendues = (uint32_t) (SIM_MS(100) / (PLIB_TMR_Period16BitGet(TMR_ID_3) + 1u));
+    Verifie("mises a jour / 100 ms", SIM_DacNbMaj(), attendues - 1, attendues + 1);
+    Verifie("chevauchements SPI", SIM_DacNbChevauchements(), 0, 0);
+
+    printf("TCP\n");
+    SIM_TcpConnecte();
+    SIM_Tourne(SIM_MS(10));
+    nb = SIM_TcpEnvoie("!S=SF=1000A=5000O=+0W=1#", 24);
+    Verifie("octets envoyes", nb, 24, 24);
+    SIM_Tourne(SIM_MS(50));
+    nb = SIM_TcpRecoit(texte, sizeof (texte) - 1);
+    texte[nb] = '\0';
+    printf("    reponse : %s\n", texte);
+    Verifie("reponse", (nb > 0) && (texte[0] == '!'), 1, 1);
+    Verifie("frequence distante", RemoteParamGen.Frequence, 1000, 1000);
+    Verifie("amplitude distante", RemoteParamGen.Amplitude, 5000, 5000);
+    Verifie("ecritures flash", SIM_NvmNbEcritures(), 1, 1);
+    SIM_TcpEnvoie("!S=SF=1000A=40000O=+0W=1#", 25);
+    SIM_Tourne(SIM_MS(50));
+    SIM_TcpRecoit(texte, sizeof (texte) - 1);
+    Verifie("amplitude hors limites", RemoteParamGen.Amplitude, 5000, 5000);
+    Verifie("ecritures flash", SIM_NvmNbEcritures(), 1, 1);
+
+    printf("Console\n");
+    SIM_ConsoleLit(texte, sizeof (texte));
+    SIM_Commande("gen param");
+    SIM_Tourne(SIM_MS(20));
+    nb = (uint16_t) SIM_ConsoleLit(texte, sizeof (texte));
+    printf("%s", texte);
+    Verifie("texte sorti", nb > 0, 1, 1);
+    Verifie("ecritures perdues", SIM_ConsoleCompteurs()->NbPerdues, 0, 0);
+    Verifie("ecritures ecrasees", SIM_ConsoleCompteurs()->NbEcrasees, 0, 0);
+    SIM_Commande("gen prof histo");
+    SIM_Tourne(SIM_MS(200));
+    nb = (uint16_t) SIM_ConsoleLit(texte, sizeof (texte));
+    printf("%s", texte);
+    Verifie("texte sorti", nb > 0, 1, 1);
+    // Lignes des points : ni en-tte, ni histogramme (en retrait)
+    nbLignes = 0;
+    for (pLigne = strstr(texte, "\r\n"); pLigne != NULL; pLigne = strstr(pLigne + 2, "\r\n")) {
+        if ((pLigne[2] != ' ') && (pLigne[2] != '\0')) {
+            nbLignes++;
+        }
+    }
+    Verifie("lignes des points", nbLignes, MESURE_NbPoints(), MESURE_NbPoints());
+    SIM_Commande("gen sched");
+    SIM_Tourne(SIM_MS(100));
+    SIM_ConsoleLit(texte, sizeof (texte));
+    printf("%s", texte);
+    SCHED_Format(rapport, sizeof (rapport));
+    Verifie("lignes du rapport sched", CompteLignes(texte), CompteLignes(rapport),
+            CompteLignes(rapport));
+    Verifie("ecritures perdues", SIM_ConsoleCompteurs()->NbPerdues, 0, 0);
+    Verifie("ecritures ecrasees", SIM_ConsoleCompteurs()->NbEcrasees, 0, 0);
+
+    printf("%d erreur(s)\n", nbErreurs);
+    return (nbErreurs == 0) ? 0 : 1;
+}
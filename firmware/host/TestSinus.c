@@ -0,0 +1,148 @@
+// TestSinus.c
+// Contrle des tables de GesSignal (compilation PC) : puret du sinus et
+// dure de calcul selon la longueur de table
+//
+//  Sinus pleine chelle (Amplitude 10000, Offset 0) pour chaque longueur
+//  de GENSIG_LONGUEUR_MIN  GENSIG_LONGUEUR_MAX :
+//       THD+N   puissance hors fondamentale / fondamentale, limite par
+//               la quantification 16 bits du DAC (environ -98 dB)
+//       crtes  0 et VAL_MAX_PAS atteints
+//  Longueur choisie par SIGNAL_Longueur aux frquences extrmes, crtage
+//  d'un sinus dcal (exemple de SIGNAL_CalculeTable), dure de calcul
+//  des quatre formes (cache vid) par longueur.
+//
+//  Retourne 0 si toutes les mesures sont dans les tolrances.
+//
+//---------------------------------------------------------------------------
+
+#include <math.h>
+#include <stdio.h>
+#include <time.h>
+#include "GesSignal.h"
+#include "Generateur.h"
+
+// THD+N maximum par longueur (dB)
+#define TEST_THD_MAX (-90.0)
+
+static uint16_t table[GENSIG_LONGUEUR_MAX];
+static int nbErreurs = 0;
+
+//----------------------------------------------------------------------------
+//  Verifie
+//  Affiche une mesure et compte l'erreur si elle est hors tolrance
+//----------------------------------------------------------------------------
+
+static void Verifie(const char *nom, double valeur, double min, double max) {
+    bool ok = (valeur >= min) && (valeur <= max);
+
+    printf("  %-28s %12.2f  [%g .. %g] %s\n", nom, valeur, min, max, ok ? "ok" : "ERREUR");
+    if (!ok) {
+        nbErreurs++;
+    }
+}
+
+//----------------------------------------------------------------------------
+//  ThdBruit
+//  Rapport (dB) entre la puissance hors fondamentale (composante continue
+//  retire) et celle de la fondamentale
+//----------------------------------------------------------------------------
+
+static double ThdBruit(const uint16_t *pTable, uint16_t longueur) {
+    double moyenne = 0;
+    double total = 0;
+    double reel = 0;
+    double imaginaire = 0;
+    double fondamentale;
+    uint16_t n;
+
+    for (n = 0; n < longueur; n++) {
+        moyenne += pTable[n];
+    }
+    moyenne /= longueur;
+    for (n = 0; n < longueur; n++) {
+        double v = pTable[n] - moyenne;
+        total += v * v;
+        reel += v * cos(2 * M_PI * n / longueur);
+        imaginaire += v * sin(2 * M_PI * n / longueur);
+    }
+    fondamentale = 2 * ((reel * reel) + (imaginaire * imaginaire)) / longueur;
+    return 10 * log10((total - fondamentale) / fondamentale);
+}
+
+//----------------------------------------------------------------------------
+//  Min, Max
+//----------------------------------------------------------------------------
+
+static uint16_t Min(const uint16_t *pTable, uint16_t longueur) {
+    uint16_t min = VAL_MAX_PAS;
+    uint16_t n;
+
+    for (n = 0; n < longueur; n++) {
+        if (pTable[n] < min) {
+            min = pTable[n];
+        }
+    }
+    return min;
+}
+
+static uint16_t Max(const uint16_t *pTable, uint16_t longueur) {
+    uint16_t max = 0;
+    uint16_t n;
+
+    for (n = 0; n < longueur; n++) {
+        if (pTable[n] > max) {
+            max = pTable[n];
+        }
+    }
+    return max;
+}
+
+int main(void) {
+    S_ParamGen param = {SignalSinus, 20, MAX_AMPLITUDE, 0, 0};
+    uint16_t longueur;
+    char nom[40];
+    int forme;
+
+    SIGNAL_Init();
+
+    printf("Sinus pleine chelle\n");
+    for (longueur = GENSIG_LONGUEUR_MIN; longueur <= GENSIG_LONGUEUR_MAX; longueur *= 2) {
+        SIGNAL_CalculeTable(&param, table, longueur);
+        snprintf(nom, sizeof(nom), "THD+N N=%u (dB)", longueur);
+        Verifie(nom, ThdBruit(table, longueur), -200, TEST_THD_MAX);
+        snprintf(nom, sizeof(nom), "min N=%u", longueur);
+        Verifie(nom, Min(table, longueur), 0, 0);
+        snprintf(nom, sizeof(nom), "max N=%u", longueur);
+        Verifie(nom, Max(table, longueur), VAL_MAX_PAS, VAL_MAX_PAS);
+    }
+
+    printf("Longueur de table\n");
+    Verifie("20 Hz", SIGNAL_Longueur(20, GENSIG_FECH_MAX),
+            GENSIG_LONGUEUR_MAX, GENSIG_LONGUEUR_MAX);
+    Verifie("2000 Hz", SIGNAL_Longueur(2000, GENSIG_FECH_MAX),
+            GENSIG_LONGUEUR_MIN, GENSIG_LONGUEUR_MIN);
+
+    // Amplitude 10000, Offset +1000 : -500 .. 9500 mV, bas aplati  0
+    printf("Ecrtage\n");
+    param.Offset = 1000;
+    SIGNAL_CalculeTable(&param, table, 64);
+    Verifie("creux (n = 48)", table[48], 0, 0);
+    Verifie("crte (n = 16)", table[16], 62257, 62259);
+
+    printf("Dure de calcul des quatre formes (PC, ms)\n");
+    param.Offset = 0;
+    for (longueur = GENSIG_LONGUEUR_MIN; longueur <= GENSIG_LONGUEUR_MAX; longueur *= 2) {
+        clock_t debut;
+        // Cache vid : SIGNAL_Init recalcule aussi le quart de sinus
+        SIGNAL_Init();
+        debut = clock();
+        for (forme = SignalSinus; forme <= SignalCarre; forme++) {
+            param.Forme = (E_FormesSignal) forme;
+            SIGNAL_CalculeTable(&param, table, longueur);
+        }
+        printf("  N=%-5u %8.3f\n", longueur, (clock() - debut) * 1000.0 / CLOCKS_PER_SEC);
+    }
+
+    printf("%d erreur(s)\n", nbErreurs);
+    return (nbErreurs == 0) ? 0 : 1;
+}
@@ -0,0 +1,262 @@
+// TestSynchro.c
+// Synchronisation de deux cartes par l'entre de dclenchement (IC1,
+// GENSIG_Declenche)  travers l'application complte (simulateur,
+// gensim_declenchement)
+//
+//  Chaque carte tourne dans son propre processus (le simulateur est
+//  global) : la carte A dans un processus fils, la carte B dans le
+//  processus principal. Les deux cartes :
+//   - reoivent la mme horloge externe sur T3CK (SIM_HorlogeExterne,
+//     mmes fronts) et les mmes paramtres par le client TCP virtuel
+//   - dmarrent  des instants diffrents (la carte B TEST_DECALAGE_US
+//     plus tard) : Timer3 et index de table sans relation de phase
+//   - reoivent le mme front de dclenchement, puis un second une
+//     seconde plus tard (la phase ne doit plus bouger)
+//  La carte A envoie ses mises  jour du DAC au processus principal par
+//  un tube. Avant le front : dcalage entre les premires mises  jour
+//  des deux cartes (affich) et valeurs diffrentes. Aprs chaque front :
+//  mmes instants de mise  jour et mmes valeurs sur les deux cartes.
+//
+//  Retourne 0 si toutes les mesures sont dans les tolrances.
+//
+//---------------------------------------------------------------------------
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "Simulation.h"
+#include "Generateur.h"
+#include "appgen.h"
+#include "peripheral/tmr/plib_tmr.h"
+
+// Horloge commune des cartes et paramtres (les deux cartes identiques)
+#define TEST_HORLOGE_EXT 10000000u
+#define TEST_TRAME "!S=SF=1000A=10000O=+0W=0#"
+// Dmarrage de la carte B aprs la carte A
+#define TEST_DECALAGE_US 1237
+// Instants absolus : configuration termine, fronts de dclenchement
+#define TEST_DEBUT_MS 10000
+#define TEST_FRONT_US 10050321
+#define TEST_NB_FRONTS 2
+#define TEST_ECART_FRONTS_MS 1000
+// Capture compare : 20 ms, 10 ms aprs chaque front
+#define TEST_ATTENTE_MS 10
+#define TEST_CAPTURE_MS 20
+#define TEST_NB_MAJ_MAX 4096
+
+typedef struct {
+    uint32_t NbMaj;
+    S_SimMajDac Maj[TEST_NB_MAJ_MAX];
+} S_Capture;
+
+static int nbErreurs = 0;
+
+//----------------------------------------------------------------------------
+//  Verifie
+//  Affiche une mesure et compte l'erreur si elle est hors tolrance
+//----------------------------------------------------------------------------
+
+static void Verifie(const char *nom, double valeur, double min, double max) {
+    bool ok = (valeur >= min) && (valeur <= max);
+
+    printf("  %-28s %12.2f  [%g .. %g] %s\n", nom, valeur, min, max, ok ? "ok" : "ERREUR");
+    if (!ok) {
+        nbErreurs++;
+    }
+}
+
+//----------------------------------------------------------------------------
+//  Commande
+//  Commande console, excute puis sortie vide
+//----------------------------------------------------------------------------
+
+static void Commande(const char *ligne) {
+    char texte[512];
+
+    SIM_ConsoleLit(texte, sizeof (texte));
+    SIM_Commande(ligne);
+    SIM_Tourne(SIM_MS(10));
+    SIM_ConsoleLit(texte, sizeof (texte));
+}
+
+//----------------------------------------------------------------------------
+//  TourneJusqua
+//  Boucle principale jusqu' l'instant absolu donn
+//----------------------------------------------------------------------------
+
+static void TourneJusqua(uint64_t instant) {
+    while (SIM_Temps() < instant) {
+        SIM_Tour();
+    }
+}
+
+//----------------------------------------------------------------------------
+//  Capture
+//  Mises  jour du DAC de [debut, debut + TEST_CAPTURE_MS[ (instants
+//  absolus) recopies dans pCapture. La boucle principale avance par
+//  tours, cals diffremment sur chaque carte : la capture dborde de
+//  part et d'autre et n'en garde que la fentre, commune aux deux cartes
+//----------------------------------------------------------------------------
+
+static void Capture(uint64_t debut, S_Capture *pCapture) {
+    uint64_t fin = debut + SIM_MS(TEST_CAPTURE_MS);
+    const S_SimMajDac *pMaj;
+    uint32_t nb;
+    uint32_t i;
+
+    TourneJusqua(debut - SIM_MS(1));
+    SIM_DacRaz();
+    TourneJusqua(fin + SIM_MS(1));
+    pMaj = SIM_DacMaj();
+    nb = SIM_DacNbMaj();
+    pCapture->NbMaj = 0;
+    for (i = 0; (i < nb) && (pCapture->NbMaj < TEST_NB_MAJ_MAX); i++) {
+        if ((pMaj[i].Temps >= debut) && (pMaj[i].Temps < fin)) {
+            pCapture->Maj[pCapture->NbMaj++] = pMaj[i];
+        }
+    }
+}
+
+//----------------------------------------------------------------------------
+//  Carte
+//  Dmarrage d'une carte dcal de decalage, horloge externe, paramtres,
+//  puis une capture avant les fronts et une aprs chacun (pCaptures,
+//  TEST_NB_FRONTS + 1 captures)
+//----------------------------------------------------------------------------
+
+static void Carte(uint64_t decalage, S_Capture *pCaptures) {
+    char reponse[64];
+    char ligne[32];
+    uint8_t i;
+
+    // Horloge commune prsente ds l'instant 0, carte alimente plus tard
+    SIM_HorlogeExterne(TEST_HORLOGE_EXT, 0);
+    SIM_Avance(decalage);
+    SIM_NvmFichier(NULL);
+    SYS_Initialize(NULL);
+    SIM_Tourne(SIM_MS(9000));
+    SIM_TcpConnecte();
+    SIM_Tourne(SIM_MS(10));
+    SIM_TcpEnvoie(TEST_TRAME, (uint16_t) strlen(TEST_TRAME));
+    SIM_Tourne(SIM_MS(100));
+    SIM_TcpRecoit(reponse, sizeof (reponse));
+    snprintf(ligne, sizeof (ligne), "gen horloge %u", TEST_HORLOGE_EXT);
+    Commande(ligne);
+
+    Capture(SIM_MS(TEST_DEBUT_MS), &pCaptures[0]);
+    for (i = 0; i < TEST_NB_FRONTS; i++) {
+        uint64_t front = SIM_US(TEST_FRONT_US) + (i * SIM_MS(TEST_ECART_FRONTS_MS));
+        TourneJusqua(front - SIM_MS(1));
+        SIM_FrontDeclenchement(front);
+        Capture(front + SIM_MS(TEST_ATTENTE_MS), &pCaptures[i + 1]);
+    }
+}
+
+//----------------------------------------------------------------------------
+//  Compare
+//  Mises  jour des deux cartes : mme nombre, mmes instants, mmes
+//  valeurs si elles sont alignes, des valeurs diffrentes sinon (la
+//  synchronisation est bien l'effet du front)
+//----------------------------------------------------------------------------
+
+static void Compare(const S_Capture *pA, const S_Capture *pB, bool alignees) {
+    uint32_t nb = (pA->NbMaj < pB->NbMaj) ? pA->NbMaj : pB->NbMaj;
+    uint32_t ecartsTemps = 0;
+    uint32_t ecartsValeurs = 0;
+    uint32_t i;
+
+    for (i = 0; i < nb; i++) {
+        if (pA->Maj[i].Temps != pB->Maj[i].Temps) {
+            ecartsTemps++;
+        }
+        if (pA->Maj[i].Valeurs[0] != pB->Maj[i].Valeurs[0]) {
+            ecartsValeurs++;
+        }
+    }
+    Verifie("mises a jour A", pA->NbMaj, 1, TEST_NB_MAJ_MAX - 1);
+    if (!alignees) {
+        Verifie("valeurs differentes", ecartsValeurs, 1, nb);
+        return;
+    }
+    Verifie("mises a jour B", pB->NbMaj, pA->NbMaj, pA->NbMaj);
+    Verifie("instants differents", ecartsTemps, 0, 0);
+    Verifie("valeurs differentes", ecartsValeurs, 0, 0);
+}
+
+int main(void) {
+    static S_Capture capturesA[TEST_NB_FRONTS + 1];
+    static S_Capture capturesB[TEST_NB_FRONTS + 1];
+    int tube[2];
+    int statut;
+    pid_t fils;
+    size_t lus = 0;
+    uint8_t i;
+
+    if (pipe(tube) != 0) {
+        perror("pipe");
+        return 2;
+    }
+    fflush(stdout);
+    fils = fork();
+    if (fils < 0) {
+        perror("fork");
+        return 2;
+    }
+    if (fils == 0) {
+        // Carte A : captures envoyes au processus principal
+        size_t ecrits = 0;
+
+        close(tube[0]);
+        Carte(0, capturesA);
+        while (ecrits < sizeof (capturesA)) {
+            ssize_t n = write(tube[1], (const char *) capturesA + ecrits,
+                    sizeof (capturesA) - ecrits);
+            if (n <= 0) {
+                _exit(2);
+            }
+            ecrits += (size_t) n;
+        }
+        _exit(0);
+    }
+
+    // Carte B, puis rception des captures de la carte A
+    close(tube[1]);
+    Carte(SIM_US(TEST_DECALAGE_US), capturesB);
+    while (lus < sizeof (capturesA)) {
+        ssize_t n = read(tube[0], (char *) capturesA + lus, sizeof (capturesA) - lus);
+        if (n <= 0) {
+            break;
+        }
+        lus += (size_t) n;
+    }
+    close(tube[0]);
+    waitpid(fils, &statut, 0);
+    if ((lus != sizeof (capturesA)) || !WIFEXITED(statut) || (WEXITSTATUS(statut) != 0)) {
+        fprintf(stderr, "carte A : captures incompletes\n");
+        return 2;
+    }
+
+    printf("horloge %u Hz, %u points, PR3 %u, %lu declenchement(s) (carte B)\n",
+            TEST_HORLOGE_EXT, GENSIG_LongueurActive(),
+            (unsigned) PLIB_TMR_Period16BitGet(TMR_ID_3),
+            (unsigned long) GENSIG_NbDeclenchements());
+    printf("Avant le front\n");
+    if ((capturesA[0].NbMaj > 0) && (capturesB[0].NbMaj > 0)) {
+        printf("  decalage des mises a jour %lld ns\n",
+                (long long) SIM_EN_NS(capturesB[0].Maj[0].Temps)
+                - (long long) SIM_EN_NS(capturesA[0].Maj[0].Temps));
+    }
+    Compare(&capturesA[0], &capturesB[0], false);
+    for (i = 0; i < TEST_NB_FRONTS; i++) {
+        printf("Apres le front %u\n", (unsigned) (i + 1));
+        Compare(&capturesA[i + 1], &capturesB[i + 1], true);
+    }
+    Verifie("declenchements (carte B)", GENSIG_NbDeclenchements(),
+            TEST_NB_FRONTS, TEST_NB_FRONTS);
+
+    printf("%d erreur(s)\n", nbErreurs);
+    return (nbErreurs == 0) ? 0 : 1;
+}
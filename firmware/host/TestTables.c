@@ -0,0 +1,360 @@
+// TestTables.c
+// Tables de rfrence de GesSignal (compilation PC)
+//
+//  Usage : TestTables fichier          comparaison avec le fichier
+//          TestTables --genere fichier criture du fichier
+//
+//  Cas couverts : les quatre formes  table, pour chaque longueur de
+//  GENSIG_LONGUEUR_MIN  GENSIG_LONGUEUR_MAX, chaque amplitude de
+//  amplitudes[] et chaque offset de offsets[] (bornes du menu, pas de
+//  rglage autour de 0, crtage ds que |Offset| + Amplitude > 10000).
+//
+//  Format du fichier (texte, lignes '#' ignores), une ligne par cas :
+//       forme longueur amplitude offset crc32 [valeurs]
+//  crc32 (polynme 0xEDB88320) des valeurs en octets de poids faible
+//  d'abord ; les valeurs ne sont crites que pour la longueur
+//  GENSIG_LONGUEUR_MIN, les autres longueurs sont vrifies par le crc.
+//  Le fichier est gnr sur PC : le quart de sinus vient du sinf de la
+//  bibliothque C du PC, celui de XC32 peut en diffrer d'un arrondi.
+//
+//  Comparaison : chaque table doit tre identique  celle du fichier
+//  (valeurs et crc pour la longueur GENSIG_LONGUEUR_MIN, crc sinon).
+//  Indpendamment du fichier, chaque table est aussi compare  un calcul
+//  en double prcision de la forme idale (sinus et triangle exacts,
+//  sries de Fourier limites  k < N/2) mis  l'chelle et crt comme
+//  document dans SIGNAL_CalculeTable : l'cart doit rester sous
+//  ecartMax[forme] pas. Pour le sinus et le triangle, l'cart avec un
+//  arrondi direct de valeurBrute (calcul 64 bits d'avant la mise 
+//  l'chelle en Q14) doit rester d'au plus un pas.
+//
+//  Retourne 0 si tous les cas sont conformes.
+//
+//---------------------------------------------------------------------------
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "GesSignal.h"
+#include "Generateur.h"
+
+#define TEST_NB_FORMES (SignalCarre + 1)
+
+static const int16_t amplitudes[] = {0, 100, 5000, 10000};
+static const int16_t offsets[] = {-5000, -1000, -100, 0, 100, 1000, 5000};
+// Ecart maximum (pas) avec la forme idale en double prcision. Sinus :
+// forme arrondie au 1/SIGNAL_CRETE de la crte (un pas  pleine
+// amplitude), gain Q14 et arrondi final (un demi-pas chacun). Triangle :
+// forme exacte, gain et arrondi seuls. Dent et carr : s'y ajoutent les
+// troncatures des sommes d'harmoniques (Q30, puis Q14 pour la dent).
+static const double ecartMax[TEST_NB_FORMES] = {2.1, 1.1, 6.0, 4.0};
+static const char *nomsFormes[TEST_NB_FORMES] = {"sinus", "triangle", "dent", "carr"};
+
+#define TEST_NB_AMPLITUDES (sizeof(amplitudes) / sizeof(amplitudes[0]))
+#define TEST_NB_OFFSETS (sizeof(offsets) / sizeof(offsets[0]))
+
+static uint16_t table[GENSIG_LONGUEUR_MAX];
+static double ideale[GENSIG_LONGUEUR_MAX];
+
+//----------------------------------------------------------------------------
+//  Crc32
+//----------------------------------------------------------------------------
+
+static uint32_t Crc32(const uint16_t *pTable, uint16_t longueur) {
+    uint32_t crc = 0xFFFFFFFFu;
+    uint16_t n;
+    int octet;
+    int bit;
+
+    for (n = 0; n < longueur; n++) {
+        for (octet = 0; octet < 2; octet++) {
+            crc ^= (pTable[n] >> (8 * octet)) & 0xFF;
+            for (bit = 0; bit < 8; bit++) {
+                crc = (crc >> 1) ^ ((crc & 1) ? 0xEDB88320u : 0);
+            }
+        }
+    }
+    return ~crc;
+}
+
+//----------------------------------------------------------------------------
+//  FormeIdeale
+//  Forme normalise en double prcision, crte 1
+//----------------------------------------------------------------------------
+
+static void FormeIdeale(E_FormesSignal forme, uint16_t longueur) {
+    uint16_t n;
+    uint16_t k;
+
+    for (n = 0; n < longueur; n++) {
+        double phase = 2 * M_PI * n / longueur;
+        double somme = 0;
+
+        switch (forme) {
+            case SignalSinus:
+                ideale[n] = sin(phase);
+                break;
+            case SignalTriangle:
+                if (n < (longueur / 2)) {
+                    ideale[n] = 4.0 * (n - (longueur / 4.0)) / longueur;
+                } else {
+                    ideale[n] = 4.0 * ((3.0 * longueur / 4.0) - n) / longueur;
+                }
+                break;
+            case SignalDentDeScie:
+                for (k = 1; k < (longueur / 2); k++) {
+                    somme += sin(k * phase) / k;
+                }
+                ideale[n] = -2 / M_PI * somme;
+                break;
+            default:
+                for (k = 1; k < (longueur / 2); k += 2) {
+                    somme += sin(k * phase) / k;
+                }
+                ideale[n] = 4 / M_PI * somme;
+                break;
+        }
+    }
+}
+
+//----------------------------------------------------------------------------
+//  Echelle
+//  Valeur en mV (offset divis par 2 et de signe invers) crte puis
+//  convertie en pas du DAC, sans arrondi
+//----------------------------------------------------------------------------
+
+static double Echelle(const S_ParamGen *pParam, double forme) {
+    double mv = MOITIE_AMPLITUDE - (pParam->Offset / 2) + (forme * pParam->Amplitude / 2);
+
+    if (mv < 0) {
+        mv = 0;
+    } else if (mv > MAX_AMPLITUDE) {
+        mv = MAX_AMPLITUDE;
+    }
+    return mv * VAL_MAX_PAS / MAX_AMPLITUDE;
+}
+
+//----------------------------------------------------------------------------
+//  ArrondiDirect
+//  Code du DAC par arrondi direct de valeurBrute (calcul 64 bits), 
+//  partir de la forme normalise entire du sinus ou du triangle
+//----------------------------------------------------------------------------
+
+static int32_t ArrondiDirect(const S_ParamGen *pParam, uint16_t longueur, uint16_t n) {
+    int32_t n32 = n;
+    int32_t l32 = longueur;
+    int32_t forme;
+    int64_t valeurBrute;
+    int64_t pleineEchelle = (int64_t) MAX_AMPLITUDE * 2 * SIGNAL_CRETE;
+
+    if (pParam->Forme == SignalSinus) {
+        // Mme calcul que SIGNAL_Init sur le quart de priode, puis symtrie
+        uint32_t i = (uint32_t) n * (GENSIG_LONGUEUR_MAX / longueur);
+        uint32_t j = i & ((GENSIG_LONGUEUR_MAX / 2) - 1);
+        uint32_t q = (j <= (GENSIG_LONGUEUR_MAX / 4)) ? j : ((GENSIG_LONGUEUR_MAX / 2) - j);
+        float valeur = sinf(2 * (float) M_PI * ((float) q / (float) GENSIG_LONGUEUR_MAX))
+                * SIGNAL_CRETE;
+        forme = (int32_t) (valeur + 0.5f);
+        if (i & (GENSIG_LONGUEUR_MAX / 2)) {
+            forme = -forme;
+        }
+    } else if (n32 < (l32 / 2)) {
+        forme = (4 * SIGNAL_CRETE * (n32 - (l32 / 4))) / l32;
+    } else {
+        forme = (4 * SIGNAL_CRETE * ((3 * l32 / 4) - n32)) / l32;
+    }
+    valeurBrute = ((int64_t) (MOITIE_AMPLITUDE - (pParam->Offset / 2)) * 2 * SIGNAL_CRETE)
+            + ((int64_t) forme * pParam->Amplitude);
+    if (valeurBrute < 0) {
+        valeurBrute = 0;
+    } else if (valeurBrute > pleineEchelle) {
+        valeurBrute = pleineEchelle;
+    }
+    return (int32_t) (((valeurBrute * VAL_MAX_PAS) + (pleineEchelle / 2)) / pleineEchelle);
+}
+
+//----------------------------------------------------------------------------
+//  VerifieReference
+//  Ecart maximum (pas) avec la forme idale, et avec l'arrondi direct pour
+//  le sinus et le triangle (0 sinon)
+//----------------------------------------------------------------------------
+
+static void VerifieReference(const S_ParamGen *pParam, uint16_t longueur,
+        double *pEcartIdeal, int32_t *pEcartDirect) {
+    uint16_t n;
+    double ecart;
+    int32_t direct;
+
+    *pEcartIdeal = 0;
+    *pEcartDirect = 0;
+    for (n = 0; n < longueur; n++) {
+        ecart = fabs(table[n] - Echelle(pParam, ideale[n]));
+        if (ecart > *pEcartIdeal) {
+            *pEcartIdeal = ecart;
+        }
+        if (pParam->Forme <= SignalTriangle) {
+            direct = abs(table[n] - ArrondiDirect(pParam, longueur, n));
+            if (direct > *pEcartDirect) {
+                *pEcartDirect = direct;
+            }
+        }
+    }
+}
+
+//----------------------------------------------------------------------------
+//  LitCas
+//  Ligne suivante du fichier (hors commentaires) : retourne false en fin
+//  de fichier ou si la ligne ne correspond pas au cas attendu
+//----------------------------------------------------------------------------
+
+static bool LitCas(FILE *pFichier, const S_ParamGen *pParam, uint16_t longueur,
+        uint32_t *pCrc, uint16_t *pValeurs) {
+    static char ligne[16 * GENSIG_LONGUEUR_MIN];
+    int forme, lu, amplitude, offset, decalage;
+    unsigned long crc;
+    char *pCurseur;
+    uint16_t n;
+
+    do {
+        if (fgets(ligne, sizeof(ligne), pFichier) == NULL) {
+            return false;
+        }
+    } while ((ligne[0] == '#') || (ligne[0] == '\n'));
+
+    if ((sscanf(ligne, "%d %d %d %d %lx%n", &forme, &lu, &amplitude, &offset, &crc,
+            &decalage) != 5) || (forme != pParam->Forme) || (lu != longueur)
+            || (amplitude != pParam->Amplitude) || (offset != pParam->Offset)) {
+        return false;
+    }
+    *pCrc = (uint32_t) crc;
+    if (longueur == GENSIG_LONGUEUR_MIN) {
+        pCurseur = ligne + decalage;
+        for (n = 0; n < longueur; n++) {
+            unsigned int valeur;
+            if (sscanf(pCurseur, "%u%n", &valeur, &decalage) != 1) {
+                return false;
+            }
+            pValeurs[n] = (uint16_t) valeur;
+            pCurseur += decalage;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char *argv[]) {
+    static uint16_t valeurs[GENSIG_LONGUEUR_MIN];
+    bool genere = (argc == 3) && (strcmp(argv[1], "--genere") == 0);
+    FILE *pFichier;
+    S_ParamGen param = {SignalSinus, 20, 0, 0, 0};
+    uint16_t longueur;
+    unsigned int a, o;
+    int forme;
+    int nbCas = 0;
+    int nbDifferences = 0;
+    int nbErreurs = 0;
+    uint16_t n;
+
+    if ((argc != 2) && !genere) {
+        fprintf(stderr, "usage : %s [--genere] fichier\n", argv[0]);
+        return 2;
+    }
+    pFichier = fopen(argv[argc - 1], genere ? "w" : "r");
+    if (pFichier == NULL) {
+        perror(argv[argc - 1]);
+        return 2;
+    }
+    if (genere) {
+        fprintf(pFichier, "# Tables de GesSignal (TestTables --genere)\n"
+                "# forme longueur amplitude offset crc32 [valeurs pour la longueur %d]\n",
+                GENSIG_LONGUEUR_MIN);
+    }
+
+    SIGNAL_Init();
+    printf("forme      cas  cart idal  cart direct   dure (ms, PC)\n");
+    for (forme = SignalSinus; forme <= SignalCarre; forme++) {
+        double pireIdeal = 0;
+        int32_t pireDirect = 0;
+        double duree = 0;
+        int nbCasForme = 0;
+
+        param.Forme = (E_FormesSignal) forme;
+        for (longueur = GENSIG_LONGUEUR_MIN; longueur <= GENSIG_LONGUEUR_MAX; longueur *= 2) {
+            FormeIdeale(param.Forme, longueur);
+            for (a = 0; a < TEST_NB_AMPLITUDES; a++) {
+                for (o = 0; o < TEST_NB_OFFSETS; o++) {
+                    clock_t debut;
+                    uint32_t crc;
+                    uint32_t crcFichier;
+                    double ecartIdeal;
+                    int32_t ecartDirect;
+
+                    param.Amplitude = amplitudes[a];
+                    param.Offset = offsets[o];
+                    debut = clock();
+                    SIGNAL_CalculeTable(&param, table, longueur);
+                    duree += (double) (clock() - debut);
+                    crc = Crc32(table, longueur);
+                    nbCas++;
+                    nbCasForme++;
+
+                    VerifieReference(&param, longueur, &ecartIdeal, &ecartDirect);
+                    if (ecartIdeal > pireIdeal) {
+                        pireIdeal = ecartIdeal;
+                    }
+                    if (ecartDirect > pireDirect) {
+                        pireDirect = ecartDirect;
+                    }
+                    if ((ecartIdeal > ecartMax[forme]) || (ecartDirect > 1)) {
+                        printf("  %s N=%u A=%d O=%d : cart idal %.2f, direct %d\n",
+                                nomsFormes[forme], longueur, param.Amplitude, param.Offset,
+                                ecartIdeal, ecartDirect);
+                        nbErreurs++;
+                    }
+
+                    if (genere) {
+                        fprintf(pFichier, "%d %u %d %d %08x", forme, longueur,
+                                param.Amplitude, param.Offset, crc);
+                        if (longueur == GENSIG_LONGUEUR_MIN) {
+                            for (n = 0; n < longueur; n++) {
+                                fprintf(pFichier, " %u", table[n]);
+                            }
+                        }
+                        fprintf(pFichier, "\n");
+                    } else if (!LitCas(pFichier, &param, longueur, &crcFichier, valeurs)) {
+                        printf("  %s N=%u A=%d O=%d : cas absent du fichier\n",
+                                nomsFormes[forme], longueur, param.Amplitude, param.Offset);
+                        nbErreurs++;
+                    } else if ((crc != crcFichier) || ((longueur == GENSIG_LONGUEUR_MIN)
+                            && (memcmp(table, valeurs, sizeof(valeurs)) != 0))) {
+                        printf("  %s N=%u A=%d O=%d : table diffrente", nomsFormes[forme],
+                                longueur, param.Amplitude, param.Offset);
+                        if (longueur == GENSIG_LONGUEUR_MIN) {
+                            for (n = 0; (n < longueur) && (table[n] == valeurs[n]); n++) {
+                            }
+                            printf(" (n = %u : %u au lieu de %u)", n, table[n], valeurs[n]);
+                        }
+                        printf("\n");
+                        nbDifferences++;
+                    }
+                }
+            }
+        }
+        printf("%-9s %4d  %9.2f  ", nomsFormes[forme], nbCasForme, pireIdeal);
+        if (forme <= SignalTriangle) {
+            printf("%12d", pireDirect);
+        } else {
+            printf("%12s", "-");
+        }
+        printf("  %14.2f\n", duree * 1000.0 / CLOCKS_PER_SEC);
+    }
+    fclose(pFichier);
+
+    if (genere) {
+        printf("%d cas crits dans %s, %d erreur(s)\n", nbCas, argv[2], nbErreurs);
+    } else {
+        printf("%d cas, %d table(s) diffrente(s), %d erreur(s)\n", nbCas, nbDifferences,
+                nbErreurs);
+    }
+    return ((nbDifferences == 0) && (nbErreurs == 0)) ? 0 : 1;
+}
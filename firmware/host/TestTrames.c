@@ -0,0 +1,258 @@
+// TestTrames.c
+// Rejeu de trames TCP enregistres  travers l'application complte
+// (simulateur) : GetMessage, SendMessage, menu remote et
+// GENSIG_UpdateSignal
+//
+//  Usage : TestTrames fichier          rejeu et comparaison
+//          TestTrames --genere fichier rponses rcrites dans le fichier
+//
+//  Format du fichier (texte, lignes '#' ignores) :
+//       > trame envoye par le client
+//       < rponse du serveur
+//       = forme frquence amplitude offset critures
+//  Chaque trame est envoye par le client TCP virtuel. La rponse doit
+//  tre celle du fichier (elle a la longueur de la trame reue : cho de
+//  wCurrentChunk octets par APP_Tasks). RemoteParamGen doit valoir les
+//  paramtres de la ligne '=' (inchangs si la trame est refuse), avec
+//  le nombre d'critures de la page flash, et ces paramtres doivent
+//  tre appliqus au DAC (aprs une sauvegarde,  la fin du message de
+//  sauvegarde sur le LCD : le menu remote n'applique rien avant) :
+//   - frquence : GENSIG_LongueurActive chantillons de PR3 + 1 pas de
+//     PBCLK par priode,  1 % prs
+//   - sinus et triangle : minimum et maximum des sorties sur un nombre
+//     entier de priodes, crts  0..VAL_MAX_PAS
+//   - sans crtage : moyenne au milieu (offset), et pour le carr et la
+//     dent de scie cart type de Amplitude / 2 et Amplitude / (2 racine 3)
+//
+//  Retourne 0 si toutes les trames sont conformes.
+//
+//---------------------------------------------------------------------------
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Simulation.h"
+#include "Generateur.h"
+#include "appgen.h"
+#include "peripheral/tmr/plib_tmr.h"
+
+#define TEST_NB_TRAMES 32
+#define TEST_LONGUEUR_TRAME 64
+// Tolrance des niveaux : 0.1 % de la pleine chelle
+#define TEST_TOLERANCE_PAS (VAL_MAX_PAS / 1000.0)
+
+typedef struct {
+    char Trame[TEST_LONGUEUR_TRAME];
+    char Reponse[TEST_LONGUEUR_TRAME];
+    S_ParamGen Param;
+    int NbEcritures;
+} S_Echange;
+
+static S_Echange echanges[TEST_NB_TRAMES];
+static int nbEchanges = 0;
+static int nbErreurs = 0;
+
+//----------------------------------------------------------------------------
+//  Verifie
+//  Affiche une mesure et compte l'erreur si elle est hors tolrance
+//----------------------------------------------------------------------------
+
+static void Verifie(const char *nom, double valeur, double min, double max) {
+    bool ok = (valeur >= min) && (valeur <= max);
+
+    printf("  %-28s %12.2f  [%g .. %g] %s\n", nom, valeur, min, max, ok ? "ok" : "ERREUR");
+    if (!ok) {
+        nbErreurs++;
+    }
+}
+
+//----------------------------------------------------------------------------
+//  LitFichier
+//  Trames et rponses du fichier ; false si le fichier est illisible ou
+//  mal form
+//----------------------------------------------------------------------------
+
+static bool LitFichier(const char *chemin) {
+    FILE *pFichier = fopen(chemin, "r");
+    char ligne[TEST_LONGUEUR_TRAME];
+    int valeurs[5];
+
+    if (pFichier == NULL) {
+        perror(chemin);
+        return false;
+    }
+    while (fgets(ligne, sizeof (ligne), pFichier) != NULL) {
+        ligne[strcspn(ligne, "\r\n")] = '\0';
+        if ((ligne[0] == '>') && (nbEchanges < TEST_NB_TRAMES)) {
+            snprintf(echanges[nbEchanges].Trame, TEST_LONGUEUR_TRAME, "%s", &ligne[2]);
+            echanges[nbEchanges].Reponse[0] = '\0';
+            nbEchanges++;
+        } else if ((ligne[0] == '<') && (nbEchanges > 0)) {
+            snprintf(echanges[nbEchanges - 1].Reponse, TEST_LONGUEUR_TRAME, "%s", &ligne[2]);
+        } else if ((ligne[0] == '=') && (nbEchanges > 0)
+                && (sscanf(&ligne[2], "%d %d %d %d %d", &valeurs[0], &valeurs[1],
+                &valeurs[2], &valeurs[3], &valeurs[4]) == 5)) {
+            S_Echange *pEchange = &echanges[nbEchanges - 1];
+            pEchange->Param.Forme = (E_FormesSignal) valeurs[0];
+            pEchange->Param.Frequence = (int16_t) valeurs[1];
+            pEchange->Param.Amplitude = (int16_t) valeurs[2];
+            pEchange->Param.Offset = (int16_t) valeurs[3];
+            pEchange->NbEcritures = valeurs[4];
+        } else if ((ligne[0] != '#') && (ligne[0] != '\0')) {
+            fprintf(stderr, "ligne ignoree : %s\n", ligne);
+        }
+    }
+    fclose(pFichier);
+    return nbEchanges > 0;
+}
+
+static bool EcritFichier(const char *chemin) {
+    FILE *pFichier = fopen(chemin, "w");
+    int i;
+
+    if (pFichier == NULL) {
+        perror(chemin);
+        return false;
+    }
+    fprintf(pFichier, "# Trames TCP et rponses du serveur (TestTrames --genere)\n"
+            "# > trame envoye, < rponse,\n"
+            "# = forme frquence amplitude offset critures flash\n");
+    for (i = 0; i < nbEchanges; i++) {
+        const S_Echange *pEchange = &echanges[i];
+        fprintf(pFichier, "> %s\n< %s\n= %d %d %d %d %d\n", pEchange->Trame,
+                pEchange->Reponse, pEchange->Param.Forme, pEchange->Param.Frequence,
+                pEchange->Param.Amplitude, pEchange->Param.Offset, pEchange->NbEcritures);
+    }
+    fclose(pFichier);
+    return true;
+}
+
+//----------------------------------------------------------------------------
+//  VerifieSortie
+//  Frquence et niveaux du DAC compars aux paramtres (dtail en tte)
+//----------------------------------------------------------------------------
+
+static void VerifieSortie(const S_ParamGen *pParam) {
+    const S_SimMajDac *pMaj;
+    uint16_t longueur = GENSIG_LongueurActive();
+    uint64_t periode = (uint64_t) longueur * (PLIB_TMR_Period16BitGet(TMR_ID_3) + 1u);
+    double frequence = (double) SIM_MS(1000) / periode;
+    double milieu = (MOITIE_AMPLITUDE - (pParam->Offset / 2)) * (double) VAL_MAX_PAS / MAX_AMPLITUDE;
+    double demi = (pParam->Amplitude / 2.0) * VAL_MAX_PAS / MAX_AMPLITUDE;
+    double bas = fmax(milieu - demi, 0);
+    double haut = fmin(milieu + demi, VAL_MAX_PAS);
+    bool ecrete = ((milieu - demi) < 0) || ((milieu + demi) > VAL_MAX_PAS);
+    double somme = 0;
+    double somme2 = 0;
+    double moyenne;
+    double ecartType;
+    uint16_t min = UINT16_MAX;
+    uint16_t max = 0;
+    uint32_t nb;
+    uint32_t i;
+
+    Verifie("frequence [Hz]", frequence, pParam->Frequence * 0.99, pParam->Frequence * 1.01);
+
+    SIM_DacRaz();
+    SIM_Tourne(SIM_MS(110));
+    pMaj = SIM_DacMaj();
+    nb = (SIM_DacNbMaj() / longueur) * longueur;
+    for (i = 0; i < nb; i++) {
+        uint16_t v = pMaj[i].Valeurs[0];
+        somme += v;
+        somme2 += (double) v * v;
+        if (v < min) {
+            min = v;
+        }
+        if (v > max) {
+            max = v;
+        }
+    }
+    if (nb == 0) {
+        Verifie("periodes capturees", 0, 1, 1);
+        return;
+    }
+    moyenne = somme / nb;
+    ecartType = sqrt(fmax((somme2 / nb) - (moyenne * moyenne), 0));
+
+    if ((pParam->Forme == SignalSinus) || (pParam->Forme == SignalTriangle)) {
+        Verifie("minimum [pas]", min, bas - TEST_TOLERANCE_PAS, bas + TEST_TOLERANCE_PAS);
+        Verifie("maximum [pas]", max, haut - TEST_TOLERANCE_PAS, haut + TEST_TOLERANCE_PAS);
+    }
+    if (!ecrete) {
+        Verifie("moyenne [pas]", moyenne, milieu - TEST_TOLERANCE_PAS,
+                milieu + TEST_TOLERANCE_PAS);
+        if (pParam->Forme == SignalCarre) {
+            Verifie("ecart type [pas]", ecartType, demi * 0.98, demi * 1.02);
+        } else if (pParam->Forme == SignalDentDeScie) {
+            Verifie("ecart type [pas]", ecartType, demi * 0.98 / sqrt(3), demi * 1.02 / sqrt(3));
+        }
+    }
+}
+
+int main(int argc, char *argv[]) {
+    bool genere = (argc == 3) && (strcmp(argv[1], "--genere") == 0);
+    char reponse[TEST_LONGUEUR_TRAME];
+    int i;
+
+    if ((argc != 2) && !genere) {
+        fprintf(stderr, "usage : %s [--genere] fichier\n", argv[0]);
+        return 2;
+    }
+    if (!LitFichier(argv[argc - 1])) {
+        return 2;
+    }
+
+    // Dmarrage, fin de l'affichage de l'adresse IP, connexion du client
+    SIM_NvmFichier(NULL);
+    SYS_Initialize(NULL);
+    SIM_Tourne(SIM_MS(9000));
+    SIM_TcpConnecte();
+    SIM_Tourne(SIM_MS(10));
+
+    for (i = 0; i < nbEchanges; i++) {
+        S_Echange *pEchange = &echanges[i];
+        uint32_t nbEcritures = SIM_NvmNbEcritures();
+        uint16_t nb;
+
+        SIM_TcpEnvoie(pEchange->Trame, (uint16_t) strlen(pEchange->Trame));
+        SIM_Tourne(SIM_MS(200));
+        while (appRJ45Status.usbStatSave) {
+            SIM_Tourne(SIM_MS(10));
+        }
+        SIM_Tourne(SIM_MS(100));
+        nb = SIM_TcpRecoit(reponse, sizeof (reponse) - 1);
+        reponse[nb] = '\0';
+        printf("> %s\n< %s\n", pEchange->Trame, reponse);
+        if (genere) {
+            snprintf(pEchange->Reponse, TEST_LONGUEUR_TRAME, "%s", reponse);
+            pEchange->Param = RemoteParamGen;
+            pEchange->NbEcritures = (int) (SIM_NvmNbEcritures() - nbEcritures);
+            continue;
+        }
+
+        Verifie("reponse enregistree", strcmp(reponse, pEchange->Reponse) == 0, 1, 1);
+        Verifie("forme", RemoteParamGen.Forme, pEchange->Param.Forme, pEchange->Param.Forme);
+        Verifie("frequence distante [Hz]", RemoteParamGen.Frequence,
+                pEchange->Param.Frequence, pEchange->Param.Frequence);
+        Verifie("amplitude distante [mV]", RemoteParamGen.Amplitude,
+                pEchange->Param.Amplitude, pEchange->Param.Amplitude);
+        Verifie("offset distant [mV]", RemoteParamGen.Offset,
+                pEchange->Param.Offset, pEchange->Param.Offset);
+        Verifie("ecritures flash", SIM_NvmNbEcritures() - nbEcritures,
+                pEchange->NbEcritures, pEchange->NbEcritures);
+        VerifieSortie(&pEchange->Param);
+    }
+
+    if (genere) {
+        if (!EcritFichier(argv[2])) {
+            return 2;
+        }
+        printf("%d trame(s) ecrite(s) dans %s\n", nbEchanges, argv[2]);
+        return 0;
+    }
+    printf("%d erreur(s)\n", nbErreurs);
+    return (nbErreurs == 0) ? 0 : 1;
+}
@@ -0,0 +1,22 @@
+#ifndef Mc32DriverLcd_H
+#define Mc32DriverLcd_H
+
+// Mc32DriverLcd.h (simulateur)
+// Afficheur 4 lignes de 20 caractres du kit, mmes fonctions que le
+// pilote du kit. SimLcd.c tient le contenu de l'cran (SIM_LcdLigne) :
+// positions 1..20 / 1..4, '\f' efface l'cran et ramne le curseur en
+// haut  gauche.
+//
+//---------------------------------------------------------------------------
+
+#include <stdint.h>
+
+void lcd_init(void);
+void lcd_gotoxy(uint8_t x, uint8_t y);
+void lcd_putc(int8_t c);
+void printf_lcd(const char *format, ...);
+void lcd_ClearLine(uint8_t NoLine);
+void lcd_bl_on(void);
+void lcd_bl_off(void);
+
+#endif
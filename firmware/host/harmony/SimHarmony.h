@@ -0,0 +1,155 @@
+#ifndef SimHarmony_h
+#define SimHarmony_h
+
+// SimHarmony.h
+// Dclarations d'Harmony 2.06 utilises par l'application, pour la
+// compilation PC (simulateur)
+//
+// Principe : les modules de ../src sont compils sans modification. Les
+//            en-ttes d'Harmony qu'ils incluent (system/..., driver/...,
+//            usb/..., tcpip/...) sont remplacs par des en-ttes du mme
+//            nom qui incluent ce fichier. Seul ce qui est appel par
+//            l'application est dclar, avec les mmes noms et types que
+//            dans Harmony. Les fonctions sont implmentes par le
+//            simulateur (../sim) : horloges, interruptions, console
+//            (SYS_CMD et son tampon d'impression), tches vides des
+//            modules sans quivalent (USB, Ethernet, MIIM).
+//            Les timers et les interruptions sont dclars dans
+//            peripheral/tmr/plib_tmr.h et peripheral/int/plib_int.h, la
+//            pile TCP/IP dans tcpip/tcpip.h.
+//
+//---------------------------------------------------------------------------
+
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "peripheral/int/plib_int.h"
+
+// *****************************************************************************
+// system/common : modules
+// *****************************************************************************
+
+typedef uintptr_t SYS_MODULE_OBJ;
+typedef unsigned short int SYS_MODULE_INDEX;
+#define SYS_MODULE_OBJ_INVALID ((SYS_MODULE_OBJ) -1)
+
+typedef enum {
+    SYS_STATUS_ERROR_EXTENDED = -10,
+    SYS_STATUS_ERROR = -1,
+    SYS_STATUS_UNINITIALIZED = 0,
+    SYS_STATUS_BUSY = 1,
+    SYS_STATUS_READY = 2,
+    SYS_STATUS_READY_EXTENDED = 10
+} SYS_STATUS;
+
+#define SYS_MODULE_POWER_RUN_FULL 2
+
+typedef union {
+    uint8_t value;
+    struct {
+        uint8_t powerState : 4;
+        uint8_t reserved : 4;
+    } sys;
+} SYS_MODULE_INIT;
+
+// Initialisation et boucle (system_init.c, system_tasks.c)
+void SYS_Initialize(void *data);
+void SYS_Tasks(void);
+
+// *****************************************************************************
+// system/clk, system/devcon
+// *****************************************************************************
+
+typedef enum {
+    CLK_BUS_PERIPHERAL_1 = 0,
+    CLK_BUS_PERIPHERAL_2,
+    CLK_BUS_PERIPHERAL_3,
+    CLK_BUS_PERIPHERAL_4,
+    CLK_BUS_PERIPHERAL_5,
+    CLK_BUS_PERIPHERAL_7,
+    CLK_BUS_PERIPHERAL_8
+} CLK_BUSES_PERIPHERAL;
+
+uint32_t SYS_CLK_PeripheralFrequencyGet(CLK_BUSES_PERIPHERAL peripheralBus);
+uint32_t SYS_CLK_SystemFrequencyGet(void);
+
+typedef enum {
+    OSC_ID_0 = 0
+} OSC_MODULE_ID;
+
+typedef enum {
+    OSC_ON_WAIT_IDLE = 0,
+    OSC_ON_WAIT_SLEEP = 1
+} OSC_OPERATION_ON_WAIT;
+
+void SYS_DEVCON_SystemUnlock(void);
+void SYS_DEVCON_SystemLock(void);
+void PLIB_OSC_OnWaitActionSet(OSC_MODULE_ID index, OSC_OPERATION_ON_WAIT onWaitMode);
+
+// *****************************************************************************
+// system/int
+// *****************************************************************************
+
+// Sans effet : le simulateur n'excute les interruptions qu'entre deux
+// tours de boucle (SIM_Avance), jamais au milieu d'une section
+bool SYS_INT_Disable(void);
+void SYS_INT_Restore(bool state);
+void SYS_INT_SourceEnable(INT_SOURCE source);
+bool SYS_INT_SourceDisable(INT_SOURCE source);
+
+// *****************************************************************************
+// system/command, system/console
+// *****************************************************************************
+
+struct SYS_CMD_DEVICE_NODE;
+
+typedef void (*SYS_CMD_MSG_FNC)(const void *cmdIoParam, const char *str);
+typedef void (*SYS_CMD_PRINT_FNC)(const void *cmdIoParam, const char *format, ...);
+typedef void (*SYS_CMD_PUTC_FNC)(const void *cmdIoParam, char c);
+
+typedef struct {
+    SYS_CMD_MSG_FNC msg;        // texte constant, transmis par pointeur
+    SYS_CMD_PRINT_FNC print;    // texte format dans le tampon d'impression
+    SYS_CMD_PUTC_FNC putc;
+} SYS_CMD_API;
+
+typedef struct SYS_CMD_DEVICE_NODE {
+    const SYS_CMD_API *pCmdApi;
+    const void *cmdIoParam;
+} SYS_CMD_DEVICE_NODE;
+
+typedef int (*SYS_CMD_FNC)(SYS_CMD_DEVICE_NODE *pCmdIO, int argc, char **argv);
+
+typedef struct {
+    const char *cmdStr;
+    SYS_CMD_FNC cmdFnc;
+    const char *cmdDescr;
+} SYS_CMD_DESCRIPTOR;
+
+bool SYS_CMD_ADDGRP(const SYS_CMD_DESCRIPTOR *pCmdTbl, int nCmds,
+        const char *groupName, const char *menuStr);
+bool SYS_CMD_READY_TO_READ(void);
+bool SYS_CMD_Tasks(void);
+void SYS_CMD_MESSAGE(const char *message);
+void SYS_CMD_PRINT(const char *format, ...);
+
+// SYS_CMD_REMAP_SYS_CONSOLE_MESSAGE (system_config.h) : les messages de la
+// console passent par le tampon d'impression de SYS_CMD
+#define SYS_CONSOLE_MESSAGE(message) SYS_CMD_MESSAGE(message)
+#define SYS_CONSOLE_PRINT(...) SYS_CMD_PRINT(__VA_ARGS__)
+
+void SYS_CONSOLE_Tasks(SYS_MODULE_OBJ object);
+
+// *****************************************************************************
+// Tches des modules sans quivalent sur PC (vides)
+// *****************************************************************************
+
+void SYS_TMR_Tasks(SYS_MODULE_OBJ object);
+void DRV_MIIM_Tasks(SYS_MODULE_OBJ object);
+void DRV_USBFS_Tasks(SYS_MODULE_OBJ object);
+void DRV_USBFS_Tasks_ISR(SYS_MODULE_OBJ object);
+void USB_DEVICE_Tasks(SYS_MODULE_OBJ object);
+void DRV_ETHMAC_Tasks_ISR(SYS_MODULE_OBJ object);
+
+#endif
@@ -0,0 +1,70 @@
+#ifndef _BSP_H
+#define _BSP_H
+
+// bsp.h (simulateur)
+// Broches du kit PIC32MX ES utilises par l'application : LED0  LED7
+// (actives  0), entres du PEC12 et de S9 (au repos  1, pull-up).
+// Chaque broche est un champ de SimBroches : l'application les lit et
+// les crit comme les bits LATx / PORTx, les tests agissent sur les
+// entres et lisent les sorties (LED0 : sortie de synchronisation).
+//
+//---------------------------------------------------------------------------
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef struct {
+    uint8_t Led0 : 1;
+    uint8_t Led1 : 1;
+    uint8_t Led2 : 1;
+    uint8_t Led3 : 1;
+    uint8_t Led4 : 1;
+    uint8_t Led5 : 1;
+    uint8_t Led6 : 1;
+    uint8_t Led7 : 1;
+    uint8_t Pec12A : 1;
+    uint8_t Pec12B : 1;
+    uint8_t Pec12PB : 1;
+    uint8_t S9 : 1;
+} S_SimBroches;
+
+extern volatile S_SimBroches SimBroches;
+
+#define LED0_W SimBroches.Led0
+#define LED1_W SimBroches.Led1
+#define LED2_W SimBroches.Led2
+#define LED3_W SimBroches.Led3
+#define LED4_W SimBroches.Led4
+#define LED5_W SimBroches.Led5
+#define LED6_W SimBroches.Led6
+#define LED7_W SimBroches.Led7
+#define LED0_R SimBroches.Led0
+#define LED1_R SimBroches.Led1
+#define LED2_R SimBroches.Led2
+#define LED3_R SimBroches.Led3
+#define LED4_R SimBroches.Led4
+#define LED5_R SimBroches.Led5
+#define LED6_R SimBroches.Led6
+#define LED7_R SimBroches.Led7
+
+#define PEC12_A SimBroches.Pec12A
+#define PEC12_B SimBroches.Pec12B
+#define PEC12_PB SimBroches.Pec12PB
+#define S_OK SimBroches.S9
+
+typedef enum {
+    BSP_LED_0 = 0,
+    BSP_LED_1,
+    BSP_LED_2,
+    BSP_LED_3,
+    BSP_LED_4,
+    BSP_LED_5,
+    BSP_LED_6,
+    BSP_LED_7
+} BSP_LED;
+
+void BSP_LEDOn(BSP_LED led);
+void BSP_LEDOff(BSP_LED led);
+void BSP_LEDToggle(BSP_LED led);
+
+#endif
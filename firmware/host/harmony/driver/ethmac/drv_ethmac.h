@@ -0,0 +1,7 @@
+#ifndef SIM_DRV_ETHMAC_H
+#define SIM_DRV_ETHMAC_H
+
+// drv_ethmac.h (simulateur) : voir SimHarmony.h
+#include "SimHarmony.h"
+
+#endif
@@ -0,0 +1,7 @@
+#ifndef SIM_DRV_MIIM_H
+#define SIM_DRV_MIIM_H
+
+// drv_miim.h (simulateur) : voir SimHarmony.h
+#include "SimHarmony.h"
+
+#endif
@@ -0,0 +1,45 @@
+#ifndef _DRV_TMR_H
+#define _DRV_TMR_H
+
+// drv_tmr.h (simulateur)
+// Types du pilote timer d'Harmony utiliss par le pilote statique
+// (system_config/.../framework/driver/drv_tmr_static.c, compil tel quel)
+//
+//---------------------------------------------------------------------------
+
+#include "SimHarmony.h"
+#include "peripheral/tmr/plib_tmr.h"
+
+#define DRV_TMR_INDEX_0 0
+
+typedef enum {
+    DRV_TMR_CLKSOURCE_INTERNAL = 0x00,
+    DRV_TMR_CLKSOURCE_EXTERNAL_SYNCHRONOUS = 0x01,
+    DRV_TMR_CLKSOURCE_EXTERNAL_ASYNCHRONOUS = 0x11
+} DRV_TMR_CLK_SOURCES;
+
+typedef enum {
+    DRV_TMR_CLIENT_STATUS_INVALID = -1,
+    DRV_TMR_CLIENT_STATUS_BUSY = 0,
+    DRV_TMR_CLIENT_STATUS_READY = 1,
+    DRV_TMR_CLIENT_STATUS_RUNNING = 2
+} DRV_TMR_CLIENT_STATUS;
+
+typedef enum {
+    DRV_TMR_OPERATION_MODE_NONE = 0,
+    DRV_TMR_OPERATION_MODE_16_BIT,
+    DRV_TMR_OPERATION_MODE_32_BIT_MASTER,
+    DRV_TMR_OPERATION_MODE_32_BIT_SLAVE
+} DRV_TMR_OPERATION_MODE;
+
+typedef struct {
+    uint32_t dividerMin;
+    uint32_t dividerMax;
+    uint32_t dividerStep;
+} DRV_TMR_DIVIDER_RANGE;
+
+typedef void (*DRV_TMR_CALLBACK)(uintptr_t context, uint32_t alarmCount);
+
+void DRV_TMR_Tasks(SYS_MODULE_OBJ object);
+
+#endif
@@ -0,0 +1,11 @@
+#ifndef _DRV_TMR_VARIANT_MAPPING_H
+#define _DRV_TMR_VARIANT_MAPPING_H
+
+// drv_tmr_variant_mapping.h (simulateur)
+// Bus d'horloge des timers (PIC32MX : PBCLK)
+
+#include "SimHarmony.h"
+
+#define CLK_BUS_FOR_TIMER_PERIPHERAL CLK_BUS_PERIPHERAL_1
+
+#endif
@@ -0,0 +1,7 @@
+#ifndef SIM_DRV_USBFS_H
+#define SIM_DRV_USBFS_H
+
+// drv_usbfs.h (simulateur) : voir SimHarmony.h
+#include "SimHarmony.h"
+
+#endif
@@ -0,0 +1,70 @@
+#ifndef _PLIB_INT_H
+#define _PLIB_INT_H
+
+// plib_int.h (simulateur)
+// Sources, vecteurs et priorits des interruptions utilises par
+// l'application. Le simulateur (SimMateriel.c) tient l'tat des
+// autorisations et des priorits.
+//
+//---------------------------------------------------------------------------
+
+#include <stdbool.h>
+
+typedef enum {
+    INT_ID_0 = 0
+} INT_MODULE_ID;
+
+typedef enum {
+    INT_SOURCE_TIMER_1 = 0,
+    INT_SOURCE_TIMER_2,
+    INT_SOURCE_TIMER_3,
+    INT_SOURCE_TIMER_4,
+    INT_SOURCE_TIMER_5,
+    INT_SOURCE_INPUT_CAPTURE_1,
+    INT_SOURCE_USB_1,
+    INT_SOURCE_ETH_1,
+    INT_SOURCE_NB
+} INT_SOURCE;
+
+typedef enum {
+    INT_VECTOR_T1 = 0,
+    INT_VECTOR_T2,
+    INT_VECTOR_T3,
+    INT_VECTOR_T4,
+    INT_VECTOR_T5,
+    INT_VECTOR_IC1,
+    INT_VECTOR_USB1,
+    INT_VECTOR_ETH,
+    INT_VECTOR_NB
+} INT_VECTOR;
+
+typedef enum {
+    INT_DISABLE_INTERRUPT = 0,
+    INT_PRIORITY_LEVEL1,
+    INT_PRIORITY_LEVEL2,
+    INT_PRIORITY_LEVEL3,
+    INT_PRIORITY_LEVEL4,
+    INT_PRIORITY_LEVEL5,
+    INT_PRIORITY_LEVEL6,
+    INT_PRIORITY_LEVEL7
+} INT_PRIORITY_LEVEL;
+
+typedef enum {
+    INT_SUBPRIORITY_LEVEL0 = 0,
+    INT_SUBPRIORITY_LEVEL1,
+    INT_SUBPRIORITY_LEVEL2,
+    INT_SUBPRIORITY_LEVEL3
+} INT_SUBPRIORITY_LEVEL;
+
+void PLIB_INT_SourceEnable(INT_MODULE_ID index, INT_SOURCE source);
+void PLIB_INT_SourceDisable(INT_MODULE_ID index, INT_SOURCE source);
+bool PLIB_INT_SourceIsEnabled(INT_MODULE_ID index, INT_SOURCE source);
+void PLIB_INT_SourceFlagClear(INT_MODULE_ID index, INT_SOURCE source);
+void PLIB_INT_SourceFlagSet(INT_MODULE_ID index, INT_SOURCE source);
+bool PLIB_INT_SourceFlagGet(INT_MODULE_ID index, INT_SOURCE source);
+void PLIB_INT_VectorPrioritySet(INT_MODULE_ID index, INT_VECTOR vector,
+        INT_PRIORITY_LEVEL priority);
+void PLIB_INT_VectorSubPrioritySet(INT_MODULE_ID index, INT_VECTOR vector,
+        INT_SUBPRIORITY_LEVEL subPriority);
+
+#endif
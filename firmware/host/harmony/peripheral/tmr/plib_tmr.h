@@ -0,0 +1,59 @@
+#ifndef _PLIB_TMR_H
+#define _PLIB_TMR_H
+
+// plib_tmr.h (simulateur)
+// Timers 16 bits du PIC32MX : compteur, priode, prdiviseur, horloge
+// interne (PBCLK) ou externe (TxCK). Le modle (SimMateriel.c) calcule le
+// compteur  l'instant simul et dclenche l'interruption  chaque
+// galit compteur / priode.
+//
+//---------------------------------------------------------------------------
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef enum {
+    TMR_ID_1 = 0,
+    TMR_ID_2,
+    TMR_ID_3,
+    TMR_ID_4,
+    TMR_ID_5,
+    TMR_NUMBER_OF_MODULES
+} TMR_MODULE_ID;
+
+typedef enum {
+    TMR_CLOCK_SOURCE_PERIPHERAL_CLOCK = 0,
+    TMR_CLOCK_SOURCE_EXTERNAL_INPUT_PIN = 1
+} TMR_CLOCK_SOURCE;
+
+typedef enum {
+    TMR_PRESCALE_VALUE_1 = 0,
+    TMR_PRESCALE_VALUE_2,
+    TMR_PRESCALE_VALUE_4,
+    TMR_PRESCALE_VALUE_8,
+    TMR_PRESCALE_VALUE_16,
+    TMR_PRESCALE_VALUE_32,
+    TMR_PRESCALE_VALUE_64,
+    TMR_PRESCALE_VALUE_256
+} TMR_PRESCALE;
+
+void PLIB_TMR_Start(TMR_MODULE_ID index);
+void PLIB_TMR_Stop(TMR_MODULE_ID index);
+void PLIB_TMR_ClockSourceSelect(TMR_MODULE_ID index, TMR_CLOCK_SOURCE source);
+void PLIB_TMR_ClockSourceExternalSyncEnable(TMR_MODULE_ID index);
+void PLIB_TMR_ClockSourceExternalSyncDisable(TMR_MODULE_ID index);
+void PLIB_TMR_PrescaleSelect(TMR_MODULE_ID index, TMR_PRESCALE prescale);
+uint16_t PLIB_TMR_PrescaleGet(TMR_MODULE_ID index);
+void PLIB_TMR_Mode16BitEnable(TMR_MODULE_ID index);
+void PLIB_TMR_Counter16BitSet(TMR_MODULE_ID index, uint16_t value);
+uint16_t PLIB_TMR_Counter16BitGet(TMR_MODULE_ID index);
+void PLIB_TMR_Counter16BitClear(TMR_MODULE_ID index);
+void PLIB_TMR_Period16BitSet(TMR_MODULE_ID index, uint16_t period);
+uint16_t PLIB_TMR_Period16BitGet(TMR_MODULE_ID index);
+void PLIB_TMR_StopInIdleEnable(TMR_MODULE_ID index);
+void PLIB_TMR_StopInIdleDisable(TMR_MODULE_ID index);
+bool PLIB_TMR_ExistsClockSource(TMR_MODULE_ID index);
+bool PLIB_TMR_ExistsClockSourceSync(TMR_MODULE_ID index);
+bool PLIB_TMR_ExistsPrescale(TMR_MODULE_ID index);
+
+#endif
@@ -0,0 +1,7 @@
+#ifndef SIM_SYS_CLK_H
+#define SIM_SYS_CLK_H
+
+// sys_clk.h (simulateur) : voir SimHarmony.h
+#include "SimHarmony.h"
+
+#endif
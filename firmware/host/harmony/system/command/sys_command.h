@@ -0,0 +1,7 @@
+#ifndef SIM_SYS_COMMAND_H
+#define SIM_SYS_COMMAND_H
+
+// sys_command.h (simulateur) : voir SimHarmony.h
+#include "SimHarmony.h"
+
+#endif
@@ -0,0 +1,7 @@
+#ifndef SIM_SYS_COMMON_H
+#define SIM_SYS_COMMON_H
+
+// sys_common.h (simulateur) : voir SimHarmony.h
+#include "SimHarmony.h"
+
+#endif
@@ -0,0 +1,7 @@
+#ifndef SIM_SYS_MODULE_H
+#define SIM_SYS_MODULE_H
+
+// sys_module.h (simulateur) : voir SimHarmony.h
+#include "SimHarmony.h"
+
+#endif
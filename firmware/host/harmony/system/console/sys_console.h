@@ -0,0 +1,7 @@
+#ifndef SIM_SYS_CONSOLE_H
+#define SIM_SYS_CONSOLE_H
+
+// sys_console.h (simulateur) : voir SimHarmony.h
+#include "SimHarmony.h"
+
+#endif
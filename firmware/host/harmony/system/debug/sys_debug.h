@@ -0,0 +1,7 @@
+#ifndef SIM_SYS_DEBUG_H
+#define SIM_SYS_DEBUG_H
+
+// sys_debug.h (simulateur) : voir SimHarmony.h
+#include "SimHarmony.h"
+
+#endif
@@ -0,0 +1,7 @@
+#ifndef SIM_SYS_DEVCON_H
+#define SIM_SYS_DEVCON_H
+
+// sys_devcon.h (simulateur) : voir SimHarmony.h
+#include "SimHarmony.h"
+
+#endif
@@ -0,0 +1,7 @@
+#ifndef SIM_SYS_INT_H
+#define SIM_SYS_INT_H
+
+// sys_int.h (simulateur) : voir SimHarmony.h
+#include "SimHarmony.h"
+
+#endif
@@ -0,0 +1,7 @@
+#ifndef SIM_SYS_PORTS_H
+#define SIM_SYS_PORTS_H
+
+// sys_ports.h (simulateur) : voir SimHarmony.h
+#include "SimHarmony.h"
+
+#endif
@@ -0,0 +1,7 @@
+#ifndef SIM_SYS_RANDOM_H
+#define SIM_SYS_RANDOM_H
+
+// sys_random.h (simulateur) : voir SimHarmony.h
+#include "SimHarmony.h"
+
+#endif
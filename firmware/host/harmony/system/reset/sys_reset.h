@@ -0,0 +1,7 @@
+#ifndef SIM_SYS_RESET_H
+#define SIM_SYS_RESET_H
+
+// sys_reset.h (simulateur) : voir SimHarmony.h
+#include "SimHarmony.h"
+
+#endif
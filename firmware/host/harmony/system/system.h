@@ -0,0 +1,7 @@
+#ifndef SIM_SYSTEM_H
+#define SIM_SYSTEM_H
+
+// system.h (simulateur) : voir SimHarmony.h
+#include "SimHarmony.h"
+
+#endif
@@ -0,0 +1,7 @@
+#ifndef SIM_SYS_TMR_H
+#define SIM_SYS_TMR_H
+
+// sys_tmr.h (simulateur) : voir SimHarmony.h
+#include "SimHarmony.h"
+
+#endif
@@ -0,0 +1,74 @@
+#ifndef __TCPIP_H__
+#define __TCPIP_H__
+
+// tcpip.h (simulateur)
+// Partie de la pile TCP/IP d'Harmony utilise par le serveur (app.c) :
+// tat de la pile, interface rseau, socket serveur TCP.
+// SimTcp.c fournit une interface toujours prte (192.168.100.115) et un
+// socket dont les FIFO RX et TX (TCPIP_TCP_SOCKET_DEFAULT_RX_SIZE et
+// _TX_SIZE octets) sont remplies soit par les tests (client virtuel),
+// soit par un vrai socket TCP du PC (SIM_TcpEcoute).
+//
+//---------------------------------------------------------------------------
+
+#include "SimHarmony.h"
+
+typedef union {
+    uint32_t Val;
+    uint16_t w[2];
+    uint8_t v[4];
+} IPV4_ADDR;
+
+typedef enum {
+    IP_ADDRESS_TYPE_ANY = 0,
+    IP_ADDRESS_TYPE_IPV4,
+    IP_ADDRESS_TYPE_IPV6
+} IP_ADDRESS_TYPE;
+
+typedef union {
+    IPV4_ADDR v4Add;
+} IP_MULTI_ADDRESS;
+
+typedef const void *TCPIP_NET_HANDLE;
+
+typedef int16_t TCP_SOCKET;
+#define INVALID_SOCKET (-1)
+typedef uint16_t TCP_PORT;
+
+typedef enum {
+    TCP_OPTION_LINGER,
+    TCP_OPTION_KEEP_ALIVE,
+    TCP_OPTION_RX_BUFF,
+    TCP_OPTION_TX_BUFF,
+    TCP_OPTION_NODELAY
+} TCP_SOCKET_OPTION;
+
+typedef struct {
+    bool keepAliveEnable;
+    uint16_t keepAliveTmo;
+    uint8_t keepAliveUnackLim;
+} TCP_OPTION_KEEP_ALIVE_DATA;
+
+// Pile
+SYS_STATUS TCPIP_STACK_Status(SYS_MODULE_OBJ object);
+void TCPIP_STACK_Task(SYS_MODULE_OBJ object);
+int TCPIP_STACK_NumberOfNetworksGet(void);
+TCPIP_NET_HANDLE TCPIP_STACK_IndexToNet(int netIx);
+const char *TCPIP_STACK_NetNameGet(TCPIP_NET_HANDLE netH);
+const char *TCPIP_STACK_NetBIOSName(TCPIP_NET_HANDLE netH);
+bool TCPIP_STACK_NetIsReady(TCPIP_NET_HANDLE netH);
+uint32_t TCPIP_STACK_NetAddress(TCPIP_NET_HANDLE netH);
+
+// Socket TCP
+TCP_SOCKET TCPIP_TCP_ServerOpen(IP_ADDRESS_TYPE addType, TCP_PORT localPort,
+        IP_MULTI_ADDRESS *localAddress);
+bool TCPIP_TCP_OptionsSet(TCP_SOCKET hTCP, TCP_SOCKET_OPTION option, void *optParam);
+bool TCPIP_TCP_IsConnected(TCP_SOCKET hTCP);
+uint16_t TCPIP_TCP_GetIsReady(TCP_SOCKET hTCP);
+uint16_t TCPIP_TCP_PutIsReady(TCP_SOCKET hTCP);
+uint16_t TCPIP_TCP_ArrayGet(TCP_SOCKET hTCP, uint8_t *buffer, uint16_t count);
+uint16_t TCPIP_TCP_ArrayPut(TCP_SOCKET hTCP, const uint8_t *Data, uint16_t Len);
+bool TCPIP_TCP_Flush(TCP_SOCKET hTCP);
+void TCPIP_TCP_Close(TCP_SOCKET hTCP);
+
+#endif
@@ -0,0 +1,7 @@
+#ifndef SIM_USB_DEVICE_H
+#define SIM_USB_DEVICE_H
+
+// usb_device.h (simulateur) : voir SimHarmony.h
+#include "SimHarmony.h"
+
+#endif
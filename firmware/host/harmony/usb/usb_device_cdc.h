@@ -0,0 +1,7 @@
+#ifndef SIM_USB_DEVICE_CDC_H
+#define SIM_USB_DEVICE_CDC_H
+
+// usb_device_cdc.h (simulateur) : voir SimHarmony.h
+#include "SimHarmony.h"
+
+#endif
@@ -0,0 +1,57 @@
+#ifndef _XC_H
+#define _XC_H
+
+// xc.h (simulateur)
+// Registres et fonctions intrinsques de XC32 utiliss par l'application
+//
+//  _CP0_GET_COUNT     core timer : moiti de l'horloge systme, calcul
+//                     depuis le temps simul
+//  __builtin_disable_interrupts, __builtin_enable_interrupts
+//                     sans effet : les interruptions simules ne tombent
+//                     qu'entre deux tours de boucle
+//  IC1CON, IC1BUF     capture d'entre 1 (dclenchement), FIFO remplie
+//                     par SIM_FrontDeclenchement
+//  __ISR              attribut ignor, les routines sont appeles par le
+//                     simulateur
+//  _splim             bas de la pile (GesMesure) : tableau du simulateur,
+//                     MESURE_PeintPile ne doit pas tre appele sur PC
+//
+//---------------------------------------------------------------------------
+
+#include <stdint.h>
+
+uint32_t SIM_CoreTimer(void);
+#define _CP0_GET_COUNT() SIM_CoreTimer()
+
+#define __builtin_disable_interrupts() ((uint32_t) 1)
+#define __builtin_enable_interrupts() ((void) 0)
+
+#define __ISR(vecteur, ipl)
+
+typedef union {
+    struct {
+        uint32_t ICM : 3;
+        uint32_t ICBNE : 1;
+        uint32_t ICOV : 1;
+        uint32_t ICI : 2;
+        uint32_t ICTMR : 1;
+        uint32_t C32 : 1;
+        uint32_t FEDGE : 1;
+        uint32_t : 3;
+        uint32_t SIDL : 1;
+        uint32_t : 1;
+        uint32_t ON : 1;
+    };
+    uint32_t w;
+} __IC1CONbits_t;
+
+extern volatile __IC1CONbits_t IC1CONbits;
+#define IC1CON (IC1CONbits.w)
+
+// Lecture de la plus ancienne capture (ICBNE  0 quand la FIFO est vide)
+uint16_t SIM_LitIC1BUF(void);
+#define IC1BUF SIM_LitIC1BUF()
+
+extern uint32_t _splim[];
+
+#endif
@@ -0,0 +1,300 @@
+// SimConsole.c
+// Service de commandes SYS_CMD et console USB CDC (sys_command.h)
+//
+// Reproduit le chemin de sortie d'Harmony 2.06 :
+//  msg     le pointeur du texte est mis dans la file d'criture de la
+//          console, sans copie
+//  print   le texte format est copi dans le tampon circulaire printBuff
+//          (SYS_CMD_PRINT_BUFFER_SIZE, position aligne sur 4, retour au
+//          dbut s'il ne tient pas), puis son adresse est mise dans la
+//          file. Un texte plus long que le tampon est abandonn.
+//  file    SYS_CONSOLE_USB_CDC_WR_QUEUE_DEPTH critures en attente, une
+//          criture de plus est perdue
+//
+// SYS_CONSOLE_Tasks envoie la plus ancienne criture quand la prcdente
+// est termine. Dure d'une criture : 125 us plus 1 us par octet,
+// estimation d'un transfert bulk USB full speed vers un PC peu charg.
+// Le texte envoy est celui qui se trouve  l'adresse au moment de
+// l'envoi : une zone de printBuff rcrite entre-temps est compte
+// (NbEcrasees), comme la sortie corrompue sur la cible.
+//
+//---------------------------------------------------------------------------
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include "Simulation.h"
+#include "system_config.h"
+
+#define SIM_CMD_NB_GROUPES 4
+#define SIM_CMD_LONGUEUR_LIGNE 128
+#define SIM_CMD_NB_ARGS 16
+#define SIM_CONSOLE_SORTIE 65536
+#define SIM_CONSOLE_US_ECRITURE 125
+
+typedef struct {
+    const SYS_CMD_DESCRIPTOR *pTable;
+    int Nb;
+    const char *pNom;
+    const char *pMenu;
+} S_SimGroupe;
+
+typedef struct {
+    const char *pTexte;
+    uint16_t Longueur;
+    char Copie[SYS_CMD_PRINT_BUFFER_SIZE];
+} S_SimEcriture;
+
+static S_SimGroupe groupes[SIM_CMD_NB_GROUPES];
+static uint8_t nbGroupes = 0;
+static char ligneEnAttente[SIM_CMD_LONGUEUR_LIGNE];
+static bool commandeEnAttente = false;
+
+static char printBuff[SYS_CMD_PRINT_BUFFER_SIZE];
+static size_t printBuffPtr = 0;
+
+static S_SimEcriture file[SYS_CONSOLE_USB_CDC_WR_QUEUE_DEPTH];
+static uint8_t debutFile = 0;
+static uint8_t nbFile = 0;
+static uint64_t finEcriture = 0;
+
+static char sortie[SIM_CONSOLE_SORTIE];
+static uint32_t nbSortie = 0;
+static bool echo = false;
+static S_SimConsole compteurs;
+
+// *****************************************************************************
+// File d'criture et envoi
+// *****************************************************************************
+
+static void SIM_ConsoleEcrit(const char *pTexte) {
+    S_SimEcriture *pEcriture;
+    size_t longueur = strlen(pTexte);
+
+    if (nbFile >= SYS_CONSOLE_USB_CDC_WR_QUEUE_DEPTH) {
+        compteurs.NbPerdues++;
+        return;
+    }
+    if (longueur >= SYS_CMD_PRINT_BUFFER_SIZE) {
+        longueur = SYS_CMD_PRINT_BUFFER_SIZE - 1;
+    }
+    pEcriture = &file[(debutFile + nbFile) % SYS_CONSOLE_USB_CDC_WR_QUEUE_DEPTH];
+    pEcriture->pTexte = pTexte;
+    pEcriture->Longueur = (uint16_t) longueur;
+    memcpy(pEcriture->Copie, pTexte, longueur);
+    nbFile++;
+}
+
+static void SIM_ConsoleSortie(const char *pTexte, uint16_t longueur) {
+    if (echo) {
+        fwrite(pTexte, 1, longueur, stdout);
+        fflush(stdout);
+    }
+    if (longueur > (SIM_CONSOLE_SORTIE - 1 - nbSortie)) {
+        longueur = (uint16_t) (SIM_CONSOLE_SORTIE - 1 - nbSortie);
+    }
+    memcpy(&sortie[nbSortie], pTexte, longueur);
+    nbSortie += longueur;
+}
+
+void SYS_CONSOLE_Tasks(SYS_MODULE_OBJ object) {
+    S_SimEcriture *pEcriture;
+
+    (void) object;
+    if ((nbFile == 0) || (SIM_Temps() < finEcriture)) {
+        return;
+    }
+    pEcriture = &file[debutFile];
+    if (memcmp(pEcriture->pTexte, pEcriture->Copie, pEcriture->Longueur) != 0) {
+        compteurs.NbEcrasees++;
+    }
+    SIM_ConsoleSortie(pEcriture->pTexte, pEcriture->Longueur);
+    compteurs.NbEcritures++;
+    finEcriture = SIM_Temps() + SIM_US(SIM_CONSOLE_US_ECRITURE + pEcriture->Longueur);
+    debutFile = (debutFile + 1) % SYS_CONSOLE_USB_CDC_WR_QUEUE_DEPTH;
+    nbFile--;
+}
+
+uint32_t SIM_ConsoleLit(char *pTampon, uint32_t taille) {
+    uint32_t nb = nbSortie;
+
+    if (nb > taille - 1) {
+        nb = taille - 1;
+    }
+    memcpy(pTampon, sortie, nb);
+    pTampon[nb] = '\0';
+    memmove(sortie, &sortie[nb], nbSortie - nb);
+    nbSortie -= nb;
+    return nb;
+}
+
+void SIM_ConsoleEcho(bool actif) {
+    echo = actif;
+}
+
+const S_SimConsole *SIM_ConsoleCompteurs(void) {
+    return &compteurs;
+}
+
+// *****************************************************************************
+// API d'impression (pCmdIO->pCmdApi)
+// *****************************************************************************
+
+static void SIM_CmdMessage(const void *cmdIoParam, const char *str) {
+    (void) cmdIoParam;
+    SIM_ConsoleEcrit(str);
+}
+
+static void SIM_CmdVPrint(const char *format, va_list args) {
+    char tmpBuf[SYS_CMD_PRINT_BUFFER_SIZE];
+    int longueur;
+    size_t remplissage;
+
+    longueur = vsnprintf(tmpBuf, sizeof (tmpBuf), format, args);
+    if (longueur >= SYS_CMD_PRINT_BUFFER_SIZE) {
+        compteurs.NbTronquees++;
+        return;
+    }
+    if (longueur <= 0) {
+        return;
+    }
+    if (printBuffPtr + longueur >= SYS_CMD_PRINT_BUFFER_SIZE) {
+        printBuffPtr = 0;
+    }
+    strcpy(&printBuff[printBuffPtr], tmpBuf);
+    SIM_ConsoleEcrit(&printBuff[printBuffPtr]);
+    remplissage = longueur % 4;
+    if (remplissage > 0) {
+        remplissage = 4 - remplissage;
+    }
+    printBuffPtr += longueur + remplissage;
+}
+
+static void SIM_CmdPrint(const void *cmdIoParam, const char *format, ...) {
+    va_list args;
+
+    (void) cmdIoParam;
+    va_start(args, format);
+    SIM_CmdVPrint(format, args);
+    va_end(args);
+}
+
+static void SIM_CmdPutc(const void *cmdIoParam, char c) {
+    char texte[2] = {c, '\0'};
+
+    SIM_CmdPrint(cmdIoParam, "%s", texte);
+}
+
+static const SYS_CMD_API apiConsole = {
+    SIM_CmdMessage,
+    SIM_CmdPrint,
+    SIM_CmdPutc
+};
+
+static SYS_CMD_DEVICE_NODE noeudConsole = {
+    &apiConsole,
+    NULL
+};
+
+void SYS_CMD_MESSAGE(const char *message) {
+    SIM_ConsoleEcrit(message);
+}
+
+void SYS_CMD_PRINT(const char *format, ...) {
+    va_list args;
+
+    va_start(args, format);
+    SIM_CmdVPrint(format, args);
+    va_end(args);
+}
+
+// *****************************************************************************
+// Commandes
+// *****************************************************************************
+
+bool SYS_CMD_ADDGRP(const SYS_CMD_DESCRIPTOR *pCmdTbl, int nCmds,
+        const char *groupName, const char *menuStr) {
+    if (nbGroupes >= SIM_CMD_NB_GROUPES) {
+        return false;
+    }
+    groupes[nbGroupes].pTable = pCmdTbl;
+    groupes[nbGroupes].Nb = nCmds;
+    groupes[nbGroupes].pNom = groupName;
+    groupes[nbGroupes].pMenu = menuStr;
+    nbGroupes++;
+    return true;
+}
+
+bool SYS_CMD_READY_TO_READ(void) {
+    return true;
+}
+
+bool SIM_Commande(const char *ligne) {
+    if (commandeEnAttente) {
+        return false;
+    }
+    snprintf(ligneEnAttente, sizeof (ligneEnAttente), "%s", ligne);
+    commandeEnAttente = true;
+    return true;
+}
+
+// Liste des commandes, sortie directe (hors du modle de la file USB)
+static void SIM_Aide(void) {
+    char texte[SIM_CMD_LONGUEUR_LIGNE * 2];
+    uint8_t g;
+    int i;
+    int longueur;
+
+    for (g = 0; g < nbGroupes; g++) {
+        longueur = snprintf(texte, sizeof (texte), "------- %s %s -------\r\n",
+                groupes[g].pNom, groupes[g].pMenu);
+        SIM_ConsoleSortie(texte, (uint16_t) longueur);
+        for (i = 0; i < groupes[g].Nb; i++) {
+            longueur = snprintf(texte, sizeof (texte), "*** %s%s ***\r\n",
+                    groupes[g].pTable[i].cmdStr, groupes[g].pTable[i].cmdDescr);
+            SIM_ConsoleSortie(texte, (uint16_t) longueur);
+        }
+    }
+}
+
+bool SYS_CMD_Tasks(void) {
+    char *argv[SIM_CMD_NB_ARGS];
+    int argc = 0;
+    char *p;
+    uint8_t g;
+    int i;
+
+    if (!commandeEnAttente) {
+        return true;
+    }
+    commandeEnAttente = false;
+    for (p = strtok(ligneEnAttente, " \t\r\n"); (p != NULL) && (argc < SIM_CMD_NB_ARGS);
+            p = strtok(NULL, " \t\r\n")) {
+        argv[argc++] = p;
+    }
+    if (argc == 0) {
+        return true;
+    }
+    if (strcmp(argv[0], "help") == 0) {
+        SIM_Aide();
+        return true;
+    }
+    // Nom du groupe facultatif
+    for (g = 0; g < nbGroupes; g++) {
+        if ((argc > 1) && (strcmp(argv[0], groupes[g].pNom) == 0)) {
+            argc--;
+            memmove(&argv[0], &argv[1], argc * sizeof (argv[0]));
+            break;
+        }
+    }
+    for (g = 0; g < nbGroupes; g++) {
+        for (i = 0; i < groupes[g].Nb; i++) {
+            if (strcmp(argv[0], groupes[g].pTable[i].cmdStr) == 0) {
+                (*groupes[g].pTable[i].cmdFnc)(&noeudConsole, argc, argv);
+                return true;
+            }
+        }
+    }
+    SIM_CmdMessage(NULL, "*** Command Processor: unknown command. ***\r\n");
+    return true;
+}
@@ -0,0 +1,276 @@
+// SimDac.c
+// SPI1 et DAC LTC2604 du kit (fonctions de Mc32gestSpiDac.h)
+//
+// Chaque mot est horodat : dbut du dcalage (dpt dans le FIFO, ou fin
+// du mot prcdent si le SPI est occup), fin = front montant de CS.
+// Les appels d'une mme interruption partent au mme instant et se
+// suivent sur le SPI ; un mot demand par un appel ultrieur alors que le
+// SPI est encore occup est un chevauchement (sur la cible, attente dans
+// l'interruption). Le dcodage des commandes suit la fiche du LTC2604 :
+// registres d'entre, sorties mises  jour au front montant de CS.
+//
+//---------------------------------------------------------------------------
+
+#include <stdlib.h>
+#include "Simulation.h"
+#include "Mc32gestSpiDac.h"
+
+// SCK au dmarrage (DAC_FREQ_SPI de Mc32gestSPiDac.c pour le MX)
+#define SIM_SCK_DEFAUT 20000000u
+
+static uint32_t frequenceSpi = SIM_SCK_DEFAUT;
+static uint32_t frequenceChoisie = SIM_SCK_DEFAUT;
+
+// SPI occup jusqu' (fin du mot + temps CS haut) et dernier appel
+static uint64_t spiLibre = 0;
+static uint64_t dernierAppel = UINT64_MAX;
+// Mot en cours (SPI_DebutMotDac)
+static bool trameEnCours = false;
+static uint32_t motEnCours;
+static uint64_t debutEnCours;
+
+static uint16_t registres[DAC_NB_CANAUX];
+static uint16_t sorties[DAC_NB_CANAUX];
+
+static S_SimMotDac *pMots = NULL;
+static S_SimMajDac *pMaj = NULL;
+static uint32_t nbMots = 0;
+static uint32_t nbMaj = 0;
+static uint32_t nbPerdus = 0;
+static uint32_t nbChevauchements = 0;
+
+// *****************************************************************************
+// Enregistrement
+// *****************************************************************************
+
+void SIM_DacRaz(void) {
+    if (pMots == NULL) {
+        pMots = malloc(SIM_DAC_CAPACITE * sizeof (S_SimMotDac));
+        pMaj = malloc(SIM_DAC_CAPACITE * sizeof (S_SimMajDac));
+    }
+    nbMots = 0;
+    nbMaj = 0;
+    nbPerdus = 0;
+    nbChevauchements = 0;
+}
+
+uint32_t SIM_DacNbMots(void) {
+    return nbMots;
+}
+
+const S_SimMotDac *SIM_DacMots(void) {
+    return pMots;
+}
+
+uint32_t SIM_DacNbMaj(void) {
+    return nbMaj;
+}
+
+const S_SimMajDac *SIM_DacMaj(void) {
+    return pMaj;
+}
+
+uint32_t SIM_DacNbPerdus(void) {
+    return nbPerdus;
+}
+
+uint32_t SIM_DacNbChevauchements(void) {
+    return nbChevauchements;
+}
+
+uint16_t SIM_DacSortie(uint8_t canal) {
+    return sorties[canal];
+}
+
+static void SIM_NoteMaj(uint64_t instant) {
+    uint8_t canal;
+
+    if (pMaj == NULL) {
+        SIM_DacRaz();
+    }
+    if (nbMaj >= SIM_DAC_CAPACITE) {
+        nbPerdus++;
+        return;
+    }
+    pMaj[nbMaj].Temps = instant;
+    for (canal = 0; canal < DAC_NB_CANAUX; canal++) {
+        pMaj[nbMaj].Valeurs[canal] = sorties[canal];
+    }
+    nbMaj++;
+}
+
+// Front montant de CS : excution de la commande
+static void SIM_FinTrame(uint32_t mot, uint64_t debut, uint64_t fin) {
+    uint8_t commande = (mot >> 20) & 0x0F;
+    uint8_t adresse = (mot >> 16) & 0x0F;
+    uint16_t valeur = (uint16_t) mot;
+    bool maj = false;
+    uint8_t canal;
+
+    if (pMots == NULL) {
+        SIM_DacRaz();
+    }
+    if (nbMots < SIM_DAC_CAPACITE) {
+        pMots[nbMots].Debut = debut;
+        pMots[nbMots].Fin = fin;
+        pMots[nbMots].Mot = mot;
+        nbMots++;
+    } else {
+        nbPerdus++;
+    }
+
+    switch (commande) {
+        case 0x0:   // criture du registre d'entre n
+        case 0x2:   // criture n, mise  jour de toutes les sorties
+        case 0x3:   // criture et mise  jour de n
+            for (canal = 0; canal < DAC_NB_CANAUX; canal++) {
+                if ((adresse == LTC2604_ADR_TOUS) || (adresse == canal)) {
+                    registres[canal] = valeur;
+                    if (commande == 0x3) {
+                        sorties[canal] = valeur;
+                        maj = true;
+                    }
+                }
+            }
+            if (commande == 0x2) {
+                for (canal = 0; canal < DAC_NB_CANAUX; canal++) {
+                    sorties[canal] = registres[canal];
+                }
+                maj = true;
+            }
+            break;
+        case 0x1:   // mise  jour de n (ou de toutes)
+            for (canal = 0; canal < DAC_NB_CANAUX; canal++) {
+                if ((adresse == LTC2604_ADR_TOUS) || (adresse == canal)) {
+                    sorties[canal] = registres[canal];
+                    maj = true;
+                }
+            }
+            break;
+        default:    // mise en veille, sans effet sur les sorties
+            break;
+    }
+    if (maj) {
+        SIM_NoteMaj(fin);
+    }
+}
+
+// Dbut du dcalage d'un mot : instant de dpart sur le SPI
+static uint64_t SIM_DebutDecalage(void) {
+    uint64_t maintenant = SIM_Temps();
+    uint64_t debut = maintenant;
+
+    if (maintenant < spiLibre) {
+        if (maintenant != dernierAppel) {
+            nbChevauchements++;
+        }
+        debut = spiLibre;
+    }
+    dernierAppel = maintenant;
+    return debut;
+}
+
+static uint64_t SIM_DureeDecalage(void) {
+    return SIM_NS(DAC_TempsMotsNs(frequenceSpi, 1) - DAC_TEMPS_CS_NS);
+}
+
+// *****************************************************************************
+// Fonctions de Mc32gestSpiDac.h
+// *****************************************************************************
+
+void SPI_InitLTC2604(void) {
+    uint8_t canal;
+
+    // Impulsion de CLR : registres et sorties  zro
+    for (canal = 0; canal < DAC_NB_CANAUX; canal++) {
+        registres[canal] = 0;
+        sorties[canal] = 0;
+    }
+    trameEnCours = false;
+    frequenceSpi = frequenceChoisie;
+}
+
+uint32_t SPI_SckPossible(uint32_t Frequence) {
+    return DAC_SckPossible(SYS_CLK_PeripheralFrequencyGet(CLK_BUS_PERIPHERAL_1), Frequence);
+}
+
+bool SPI_ChoisitFrequenceDac(uint32_t Frequence) {
+    uint32_t sck = SPI_SckPossible(Frequence);
+
+    if (sck == 0) {
+        return false;
+    }
+    frequenceChoisie = sck;
+    return true;
+}
+
+void SPI_AppliqueFrequenceDac(void) {
+    if (frequenceChoisie != frequenceSpi) {
+        SPI_FinMotDac();
+        frequenceSpi = frequenceChoisie;
+    }
+}
+
+uint32_t SPI_FrequenceDac(void) {
+    return frequenceChoisie;
+}
+
+void SPI_WriteMotDac(uint32_t Mot) {
+    uint64_t debut;
+    uint64_t fin;
+
+    SPI_FinMotDac();
+    debut = SIM_DebutDecalage();
+    fin = debut + SIM_DureeDecalage();
+    spiLibre = fin + SIM_NS(DAC_TEMPS_CS_NS);
+    SIM_FinTrame(Mot, debut, fin);
+}
+
+void SPI_DebutMotDac(uint32_t Mot) {
+    SPI_FinMotDac();
+    debutEnCours = SIM_DebutDecalage();
+    motEnCours = Mot;
+    trameEnCours = true;
+    spiLibre = debutEnCours + SIM_DureeDecalage() + SIM_NS(DAC_TEMPS_CS_NS);
+}
+
+void SPI_FinMotDac(void) {
+    uint64_t fin;
+
+    if (trameEnCours) {
+        // CS remonte  la fin du dcalage, ou maintenant si plus tard
+        fin = debutEnCours + SIM_DureeDecalage();
+        if (SIM_Temps() > fin) {
+            fin = SIM_Temps();
+        }
+        trameEnCours = false;
+        SIM_FinTrame(motEnCours, debutEnCours, fin);
+    }
+}
+
+void SPI_WriteToDac(uint8_t NoCh, uint16_t DacVal) {
+    SPI_WriteMotDac(LTC2604_MOT(NoCh, DacVal));
+}
+
+void SPI_CfgWriteToDac(uint8_t NoCh, uint16_t DacVal) {
+    SPI_AppliqueFrequenceDac();
+    SPI_WriteMotDac(LTC2604_MOT(NoCh, DacVal));
+}
+
+static void SIM_EcritRegistresDac(const uint16_t *pValeurs, uint8_t NbCanaux) {
+    uint8_t canal;
+
+    for (canal = 0; canal < NbCanaux; canal++) {
+        SPI_WriteMotDac(LTC2604_MOT_ECRIT(canal, pValeurs[canal]));
+    }
+}
+
+void SPI_WriteCanauxDac(const uint16_t *pValeurs, uint8_t NbCanaux) {
+    SIM_EcritRegistresDac(pValeurs, NbCanaux);
+    SPI_WriteMotDac(LTC2604_MOT_MAJ_TOUS);
+}
+
+void SPI_DebutCanauxDac(const uint16_t *pValeurs, uint8_t NbCanaux) {
+    SIM_EcritRegistresDac(pValeurs, NbCanaux);
+    SPI_DebutMotDac(LTC2604_MOT_MAJ_TOUS);
+}
@@ -0,0 +1,103 @@
+// SimLcd.c
+// Afficheur 4 x 20 du kit (fonctions de Mc32DriverLcd.h)
+//
+// Le contenu de l'cran est tenu dans un tableau de lignes ; chaque
+// caractre et chaque commande (positionnement, effacement) compte un
+// octet envoy  l'afficheur, comme sur le bus du kit.
+//
+//---------------------------------------------------------------------------
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include "Simulation.h"
+#include "Mc32DriverLcd.h"
+
+static char ecran[SIM_LCD_LIGNES][SIM_LCD_COLONNES + 1];
+static uint8_t ligneCurseur = 0;
+static uint8_t colonneCurseur = 0;
+static bool retroEclairage = false;
+static uint32_t nbOctets = 0;
+
+static void SIM_LcdEfface(void) {
+    uint8_t ligne;
+
+    for (ligne = 0; ligne < SIM_LCD_LIGNES; ligne++) {
+        memset(ecran[ligne], ' ', SIM_LCD_COLONNES);
+        ecran[ligne][SIM_LCD_COLONNES] = '\0';
+    }
+    ligneCurseur = 0;
+    colonneCurseur = 0;
+}
+
+const char *SIM_LcdLigne(uint8_t ligne) {
+    if ((ligne < 1) || (ligne > SIM_LCD_LIGNES)) {
+        return "";
+    }
+    return ecran[ligne - 1];
+}
+
+bool SIM_LcdRetroEclairage(void) {
+    return retroEclairage;
+}
+
+uint32_t SIM_LcdNbOctets(void) {
+    return nbOctets;
+}
+
+void lcd_init(void) {
+    SIM_LcdEfface();
+    nbOctets++;
+}
+
+void lcd_gotoxy(uint8_t x, uint8_t y) {
+    if ((x >= 1) && (x <= SIM_LCD_COLONNES) && (y >= 1) && (y <= SIM_LCD_LIGNES)) {
+        colonneCurseur = x - 1;
+        ligneCurseur = y - 1;
+    }
+    nbOctets++;
+}
+
+void lcd_putc(int8_t c) {
+    nbOctets++;
+    if (c == '\f') {
+        SIM_LcdEfface();
+        return;
+    }
+    // Au-del de la colonne 20 : hors de l'cran (DDRAM non visible)
+    if (colonneCurseur < SIM_LCD_COLONNES) {
+        ecran[ligneCurseur][colonneCurseur] = (char) c;
+    }
+    colonneCurseur++;
+}
+
+void printf_lcd(const char *format, ...) {
+    char texte[SIM_LCD_COLONNES * SIM_LCD_LIGNES + 1];
+    va_list args;
+    char *p;
+
+    va_start(args, format);
+    vsnprintf(texte, sizeof (texte), format, args);
+    va_end(args);
+    for (p = texte; *p != '\0'; p++) {
+        lcd_putc((int8_t) *p);
+    }
+}
+
+void lcd_ClearLine(uint8_t NoLine) {
+    uint8_t colonne;
+
+    lcd_gotoxy(1, NoLine);
+    for (colonne = 0; colonne < SIM_LCD_COLONNES; colonne++) {
+        lcd_putc(' ');
+    }
+    lcd_gotoxy(1, NoLine);
+}
+
+void lcd_bl_on(void) {
+    retroEclairage = true;
+}
+
+void lcd_bl_off(void) {
+    retroEclairage = false;
+}
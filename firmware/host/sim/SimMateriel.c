@@ -0,0 +1,564 @@
+// SimMateriel.c
+// Temps simul, timers, interruptions, capture IC1 et broches du kit
+//
+// Timers : chaque timer compte les fronts de sa source (PBCLK, ou T3CK
+// donne par SIM_HorlogeExterne) diviss par le prdiviseur. L'tat est
+// gard sous forme d'une base (front, reste du prdiviseur, compteur)
+// recalcule  chaque criture d'un registre ; le compteur et la
+// prochaine galit avec la priode s'en dduisent  tout instant. Comme
+// sur le PIC32, l'incrment qui suit TMR == PR remet le compteur  0 et
+// lve le drapeau ; un compteur crit au-dessus de PR va jusqu' 0xFFFF.
+//
+// Interruptions : une galit ou une capture lve le drapeau de la
+// source et, si la source est autorise, programme sa routine 
+// l'instant de l'vnement plus la latence. Les vnements simultans
+// sont traits avant les routines, les routines par priorit
+// dcroissante. Une routine s'excute en temps nul.
+//
+//---------------------------------------------------------------------------
+
+#include <string.h>
+#include <xc.h>
+#include "Simulation.h"
+#include "bsp.h"
+#include "peripheral/tmr/plib_tmr.h"
+#include "system_config.h"
+
+// Routines d'interruption (system_interrupt.c)
+void IntHandlerDrvTmrInstance2(void);
+void IntHandlerDrvTmrInstance1(void);
+#ifdef GENSIG_DECLENCHEMENT_ENABLE
+void IntHandlerDeclenchement(void);
+#endif
+
+// Profondeur de la FIFO de capture IC1
+#define SIM_IC1_FIFO 4
+// Pas de routine programme
+#define SIM_AUCUNE UINT64_MAX
+
+typedef struct {
+    bool On;
+    TMR_CLOCK_SOURCE Source;
+    uint16_t Prescale;      // diviseur
+    uint16_t Periode;       // PR
+    uint64_t FrontBase;     // fronts de la source  la base
+    uint32_t ResteBase;     // fronts dans le prdiviseur  la base
+    uint16_t CompteurBase;  // TMR  la base
+} S_SimTimer;
+
+static uint64_t temps = 0;
+static uint64_t latenceIsr = 0;
+static S_SimTimer timers[TMR_NUMBER_OF_MODULES] = {
+    [0 ... TMR_NUMBER_OF_MODULES - 1] = {false, TMR_CLOCK_SOURCE_PERIPHERAL_CLOCK, 1, 0xFFFF, 0, 0, 0}
+};
+static uint32_t frequenceExterne = 0;
+static uint64_t phaseExterne = 0;
+
+static bool sourceActive[INT_SOURCE_NB];
+static bool drapeau[INT_SOURCE_NB];
+static INT_PRIORITY_LEVEL priorite[INT_VECTOR_NB];
+static uint64_t echeanceIsr[INT_SOURCE_NB] = {
+    [0 ... INT_SOURCE_NB - 1] = SIM_AUCUNE
+};
+static uint32_t nbInterruptions[INT_SOURCE_NB];
+
+// Fronts de dclenchement  venir (tris) et FIFO de capture
+#define SIM_NB_FRONTS 64
+static uint64_t fronts[SIM_NB_FRONTS];
+static uint8_t nbFronts = 0;
+static uint16_t fifoIC1[SIM_IC1_FIFO];
+static uint8_t nbIC1 = 0;
+
+volatile __IC1CONbits_t IC1CONbits;
+// Bas de pile de GesMesure (MESURE_PileUtilisee lit de _splim au haut de
+// pile mmoris, qui reste  _splim sans MESURE_PeintPile)
+uint32_t _splim[1];
+
+// LEDs teintes ( 1), entres au repos (pull-up)
+volatile S_SimBroches SimBroches = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1
+};
+
+// *****************************************************************************
+// Temps
+// *****************************************************************************
+
+uint64_t SIM_Temps(void) {
+    return temps;
+}
+
+uint32_t SIM_CoreTimer(void) {
+    return (uint32_t) ((temps * (SYS_CLK_FREQ / 2)) / SIM_HORLOGE);
+}
+
+void SIM_ChangeLatenceIsr(uint32_t latenceNs) {
+    latenceIsr = SIM_NS(latenceNs);
+}
+
+uint32_t SIM_NbInterruptions(INT_SOURCE source) {
+    return nbInterruptions[source];
+}
+
+// *****************************************************************************
+// Sources d'horloge des timers
+// *****************************************************************************
+
+void SIM_HorlogeExterne(uint32_t frequence, uint64_t phase) {
+    TMR_MODULE_ID id;
+
+    // Compteurs sur l'ancienne horloge figs  l'instant courant
+    for (id = TMR_ID_1; id < TMR_NUMBER_OF_MODULES; id++) {
+        if (timers[id].Source == TMR_CLOCK_SOURCE_EXTERNAL_INPUT_PIN) {
+            PLIB_TMR_Counter16BitSet(id, PLIB_TMR_Counter16BitGet(id));
+        }
+    }
+    frequenceExterne = frequence;
+    phaseExterne = phase;
+    for (id = TMR_ID_1; id < TMR_NUMBER_OF_MODULES; id++) {
+        if (timers[id].Source == TMR_CLOCK_SOURCE_EXTERNAL_INPUT_PIN) {
+            PLIB_TMR_Counter16BitSet(id, timers[id].CompteurBase);
+        }
+    }
+}
+
+// Fronts de la source jusqu' l'instant t compris
+static uint64_t SIM_Fronts(TMR_CLOCK_SOURCE source, uint64_t t) {
+    if (source == TMR_CLOCK_SOURCE_PERIPHERAL_CLOCK) {
+        return t;
+    }
+    if ((frequenceExterne == 0) || (t < phaseExterne)) {
+        return 0;
+    }
+    return (uint64_t) (((unsigned __int128) (t - phaseExterne) * frequenceExterne)
+            / SIM_HORLOGE) + 1;
+}
+
+// Instant du front n (n >= 1)
+static uint64_t SIM_InstantFront(TMR_CLOCK_SOURCE source, uint64_t n) {
+    if (source == TMR_CLOCK_SOURCE_PERIPHERAL_CLOCK) {
+        return n;
+    }
+    if (frequenceExterne == 0) {
+        return SIM_AUCUNE;
+    }
+    return phaseExterne + (uint64_t) ((((unsigned __int128) (n - 1) * SIM_HORLOGE)
+            + frequenceExterne - 1) / frequenceExterne);
+}
+
+// *****************************************************************************
+// Timers
+// *****************************************************************************
+
+// Compteur aprs nb incrments depuis la valeur v
+static uint16_t SIM_Incremente(uint16_t v, uint16_t pr, uint64_t nb) {
+    uint64_t avantRetour;
+
+    if (v > pr) {
+        // Jusqu' 0xFFFF sans galit, puis depuis 0
+        avantRetour = 0x10000u - v;
+        if (nb < avantRetour) {
+            return (uint16_t) (v + nb);
+        }
+        nb -= avantRetour;
+        v = 0;
+    }
+    avantRetour = (uint64_t) pr - v + 1;
+    if (nb < avantRetour) {
+        return (uint16_t) (v + nb);
+    }
+    return (uint16_t) ((nb - avantRetour) % ((uint64_t) pr + 1));
+}
+
+// Nouvelle base  l'instant courant
+static void SIM_Rebase(S_SimTimer *pTimer) {
+    uint64_t fronts;
+    uint64_t total;
+
+    if (!pTimer->On) {
+        return;
+    }
+    fronts = SIM_Fronts(pTimer->Source, temps);
+    total = fronts - pTimer->FrontBase + pTimer->ResteBase;
+    pTimer->CompteurBase = SIM_Incremente(pTimer->CompteurBase, pTimer->Periode,
+            total / pTimer->Prescale);
+    pTimer->ResteBase = (uint32_t) (total % pTimer->Prescale);
+    pTimer->FrontBase = fronts;
+}
+
+// Instant de la prochaine galit (incrment PR -> 0), SIM_AUCUNE si le
+// timer est arrt
+static uint64_t SIM_ProchaineEgalite(const S_SimTimer *pTimer) {
+    uint64_t nb;
+    uint64_t front;
+
+    if (!pTimer->On) {
+        return SIM_AUCUNE;
+    }
+    if (pTimer->CompteurBase <= pTimer->Periode) {
+        nb = (uint64_t) pTimer->Periode - pTimer->CompteurBase + 1;
+    } else {
+        nb = (0x10000u - pTimer->CompteurBase) + (uint64_t) pTimer->Periode + 1;
+    }
+    front = pTimer->FrontBase + (nb * pTimer->Prescale) - pTimer->ResteBase;
+    return SIM_InstantFront(pTimer->Source, front);
+}
+
+void PLIB_TMR_Start(TMR_MODULE_ID index) {
+    S_SimTimer *pTimer = &timers[index];
+
+    if (!pTimer->On) {
+        pTimer->On = true;
+        pTimer->FrontBase = SIM_Fronts(pTimer->Source, temps);
+        pTimer->ResteBase = 0;
+    }
+}
+
+void PLIB_TMR_Stop(TMR_MODULE_ID index) {
+    SIM_Rebase(&timers[index]);
+    timers[index].On = false;
+}
+
+void PLIB_TMR_ClockSourceSelect(TMR_MODULE_ID index, TMR_CLOCK_SOURCE source) {
+    S_SimTimer *pTimer = &timers[index];
+
+    SIM_Rebase(pTimer);
+    pTimer->Source = source;
+    pTimer->FrontBase = SIM_Fronts(source, temps);
+}
+
+void PLIB_TMR_ClockSourceExternalSyncEnable(TMR_MODULE_ID index) {
+    (void) index;
+}
+
+void PLIB_TMR_ClockSourceExternalSyncDisable(TMR_MODULE_ID index) {
+    (void) index;
+}
+
+void PLIB_TMR_PrescaleSelect(TMR_MODULE_ID index, TMR_PRESCALE prescale) {
+    static const uint16_t diviseurs[] = {1, 2, 4, 8, 16, 32, 64, 256};
+
+    SIM_Rebase(&timers[index]);
+    timers[index].Prescale = diviseurs[prescale];
+    timers[index].ResteBase = 0;
+}
+
+uint16_t PLIB_TMR_PrescaleGet(TMR_MODULE_ID index) {
+    return timers[index].Prescale;
+}
+
+void PLIB_TMR_Mode16BitEnable(TMR_MODULE_ID index) {
+    (void) index;
+}
+
+void PLIB_TMR_Counter16BitSet(TMR_MODULE_ID index, uint16_t value) {
+    S_SimTimer *pTimer = &timers[index];
+
+    // L'criture de TMR remet le prdiviseur  zro
+    SIM_Rebase(pTimer);
+    pTimer->CompteurBase = value;
+    pTimer->ResteBase = 0;
+}
+
+uint16_t PLIB_TMR_Counter16BitGet(TMR_MODULE_ID index) {
+    SIM_Rebase(&timers[index]);
+    return timers[index].CompteurBase;
+}
+
+void PLIB_TMR_Counter16BitClear(TMR_MODULE_ID index) {
+    PLIB_TMR_Counter16BitSet(index, 0);
+}
+
+void PLIB_TMR_Period16BitSet(TMR_MODULE_ID index, uint16_t period) {
+    SIM_Rebase(&timers[index]);
+    timers[index].Periode = period;
+}
+
+uint16_t PLIB_TMR_Period16BitGet(TMR_MODULE_ID index) {
+    return timers[index].Periode;
+}
+
+void PLIB_TMR_StopInIdleEnable(TMR_MODULE_ID index) {
+    (void) index;
+}
+
+void PLIB_TMR_StopInIdleDisable(TMR_MODULE_ID index) {
+    (void) index;
+}
+
+bool PLIB_TMR_ExistsClockSource(TMR_MODULE_ID index) {
+    (void) index;
+    return true;
+}
+
+bool PLIB_TMR_ExistsClockSourceSync(TMR_MODULE_ID index) {
+    // Seul le Timer1 (type A) a la synchronisation de l'horloge externe
+    return index == TMR_ID_1;
+}
+
+bool PLIB_TMR_ExistsPrescale(TMR_MODULE_ID index) {
+    (void) index;
+    return true;
+}
+
+// *****************************************************************************
+// Interruptions
+// *****************************************************************************
+
+void PLIB_INT_SourceEnable(INT_MODULE_ID index, INT_SOURCE source) {
+    (void) index;
+    sourceActive[source] = true;
+}
+
+void PLIB_INT_SourceDisable(INT_MODULE_ID index, INT_SOURCE source) {
+    (void) index;
+    sourceActive[source] = false;
+    echeanceIsr[source] = SIM_AUCUNE;
+}
+
+bool PLIB_INT_SourceIsEnabled(INT_MODULE_ID index, INT_SOURCE source) {
+    (void) index;
+    return sourceActive[source];
+}
+
+void PLIB_INT_SourceFlagClear(INT_MODULE_ID index, INT_SOURCE source) {
+    (void) index;
+    drapeau[source] = false;
+}
+
+void PLIB_INT_SourceFlagSet(INT_MODULE_ID index, INT_SOURCE source) {
+    (void) index;
+    drapeau[source] = true;
+}
+
+bool PLIB_INT_SourceFlagGet(INT_MODULE_ID index, INT_SOURCE source) {
+    (void) index;
+    return drapeau[source];
+}
+
+void PLIB_INT_VectorPrioritySet(INT_MODULE_ID index, INT_VECTOR vector,
+        INT_PRIORITY_LEVEL priority) {
+    (void) index;
+    priorite[vector] = priority;
+}
+
+void PLIB_INT_VectorSubPrioritySet(INT_MODULE_ID index, INT_VECTOR vector,
+        INT_SUBPRIORITY_LEVEL subPriority) {
+    (void) index;
+    (void) vector;
+    (void) subPriority;
+}
+
+bool SYS_INT_Disable(void) {
+    return true;
+}
+
+void SYS_INT_Restore(bool state) {
+    (void) state;
+}
+
+void SYS_INT_SourceEnable(INT_SOURCE source) {
+    PLIB_INT_SourceEnable(INT_ID_0, source);
+}
+
+bool SYS_INT_SourceDisable(INT_SOURCE source) {
+    bool actif = sourceActive[source];
+
+    PLIB_INT_SourceDisable(INT_ID_0, source);
+    return actif;
+}
+
+// Drapeau lev : routine programme aprs la latence (une seule en
+// attente par source, comme le drapeau)
+static void SIM_LeveDrapeau(INT_SOURCE source) {
+    drapeau[source] = true;
+    if (sourceActive[source] && (echeanceIsr[source] == SIM_AUCUNE)) {
+        echeanceIsr[source] = temps + latenceIsr;
+    }
+}
+
+static void SIM_ExecuteIsr(INT_SOURCE source) {
+    echeanceIsr[source] = SIM_AUCUNE;
+    nbInterruptions[source]++;
+    switch (source) {
+        case INT_SOURCE_TIMER_1:
+            IntHandlerDrvTmrInstance2();
+            break;
+        case INT_SOURCE_TIMER_3:
+            IntHandlerDrvTmrInstance1();
+            break;
+#ifdef GENSIG_DECLENCHEMENT_ENABLE
+        case INT_SOURCE_INPUT_CAPTURE_1:
+            IntHandlerDeclenchement();
+            break;
+#endif
+        default:
+            drapeau[source] = false;
+            break;
+    }
+}
+
+// *****************************************************************************
+// Capture IC1
+// *****************************************************************************
+
+void SIM_FrontDeclenchement(uint64_t instant) {
+    uint8_t i;
+
+    if ((nbFronts >= SIM_NB_FRONTS) || (instant < temps)) {
+        return;
+    }
+    i = nbFronts;
+    while ((i > 0) && (fronts[i - 1] > instant)) {
+        fronts[i] = fronts[i - 1];
+        i--;
+    }
+    fronts[i] = instant;
+    nbFronts++;
+}
+
+static void SIM_Capture(void) {
+    memmove(&fronts[0], &fronts[1], (nbFronts - 1) * sizeof (fronts[0]));
+    nbFronts--;
+    if (!IC1CONbits.ON || (IC1CONbits.ICM == 0)) {
+        return;
+    }
+    if (nbIC1 < SIM_IC1_FIFO) {
+        fifoIC1[nbIC1++] = PLIB_TMR_Counter16BitGet(TMR_ID_3);
+        IC1CONbits.ICBNE = 1;
+    } else {
+        IC1CONbits.ICOV = 1;
+    }
+    SIM_LeveDrapeau(INT_SOURCE_INPUT_CAPTURE_1);
+}
+
+uint16_t SIM_LitIC1BUF(void) {
+    uint16_t capture;
+
+    if (nbIC1 == 0) {
+        return 0;
+    }
+    capture = fifoIC1[0];
+    nbIC1--;
+    memmove(&fifoIC1[0], &fifoIC1[1], nbIC1 * sizeof (fifoIC1[0]));
+    IC1CONbits.ICBNE = (nbIC1 > 0);
+    return capture;
+}
+
+// *****************************************************************************
+// Avance du temps
+// *****************************************************************************
+
+void SIM_Avance(uint64_t duree) {
+    uint64_t fin = temps + duree;
+
+    while (true) {
+        uint64_t prochain = SIM_AUCUNE;
+        int8_t timer = -1;
+        int8_t isr = -1;
+        bool capture = false;
+        TMR_MODULE_ID id;
+        INT_SOURCE source;
+
+        // Evnement le plus proche : galit, front IC1, puis routine
+        for (id = TMR_ID_1; id < TMR_NUMBER_OF_MODULES; id++) {
+            uint64_t t = SIM_ProchaineEgalite(&timers[id]);
+            if (t < prochain) {
+                prochain = t;
+                timer = (int8_t) id;
+            }
+        }
+        if ((nbFronts > 0) && (fronts[0] < prochain)) {
+            prochain = fronts[0];
+            timer = -1;
+            capture = true;
+        }
+        for (source = 0; source < INT_SOURCE_NB; source++) {
+            uint64_t t = echeanceIsr[source];
+            if ((t < prochain) || ((t == prochain) && (isr >= 0)
+                    && (priorite[source] > priorite[isr]))) {
+                prochain = t;
+                timer = -1;
+                capture = false;
+                isr = (int8_t) source;
+            }
+        }
+        if (prochain > fin) {
+            break;
+        }
+        temps = prochain;
+        if (timer >= 0) {
+            // L'galit a lieu sur ce front : la base passe aprs
+            SIM_Rebase(&timers[timer]);
+            SIM_LeveDrapeau((INT_SOURCE) (INT_SOURCE_TIMER_1 + timer));
+        } else if (capture) {
+            SIM_Capture();
+        } else {
+            SIM_ExecuteIsr((INT_SOURCE) isr);
+        }
+    }
+    temps = fin;
+}
+
+// *****************************************************************************
+// Horloges, verrouillage, LEDs
+// *****************************************************************************
+
+uint32_t SYS_CLK_PeripheralFrequencyGet(CLK_BUSES_PERIPHERAL peripheralBus) {
+    (void) peripheralBus;
+    return SYS_CLK_BUS_PERIPHERAL_1;
+}
+
+uint32_t SYS_CLK_SystemFrequencyGet(void) {
+    return SYS_CLK_FREQ;
+}
+
+void SYS_DEVCON_SystemUnlock(void) {
+}
+
+void SYS_DEVCON_SystemLock(void) {
+}
+
+void PLIB_OSC_OnWaitActionSet(OSC_MODULE_ID index, OSC_OPERATION_ON_WAIT onWaitMode) {
+    (void) index;
+    (void) onWaitMode;
+}
+
+// LEDs actives  0
+static void SIM_EcritLed(BSP_LED led, uint8_t valeur) {
+    switch (led) {
+        case BSP_LED_0: SimBroches.Led0 = valeur; break;
+        case BSP_LED_1: SimBroches.Led1 = valeur; break;
+        case BSP_LED_2: SimBroches.Led2 = valeur; break;
+        case BSP_LED_3: SimBroches.Led3 = valeur; break;
+        case BSP_LED_4: SimBroches.Led4 = valeur; break;
+        case BSP_LED_5: SimBroches.Led5 = valeur; break;
+        case BSP_LED_6: SimBroches.Led6 = valeur; break;
+        case BSP_LED_7: SimBroches.Led7 = valeur; break;
+    }
+}
+
+static uint8_t SIM_LitLed(BSP_LED led) {
+    switch (led) {
+        case BSP_LED_0: return SimBroches.Led0;
+        case BSP_LED_1: return SimBroches.Led1;
+        case BSP_LED_2: return SimBroches.Led2;
+        case BSP_LED_3: return SimBroches.Led3;
+        case BSP_LED_4: return SimBroches.Led4;
+        case BSP_LED_5: return SimBroches.Led5;
+        case BSP_LED_6: return SimBroches.Led6;
+        case BSP_LED_7: return SimBroches.Led7;
+    }
+    return 1;
+}
+
+void BSP_LEDOn(BSP_LED led) {
+    SIM_EcritLed(led, 0);
+}
+
+void BSP_LEDOff(BSP_LED led) {
+    SIM_EcritLed(led, 1);
+}
+
+void BSP_LEDToggle(BSP_LED led) {
+    SIM_EcritLed(led, !SIM_LitLed(led));
+}
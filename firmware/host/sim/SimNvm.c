@@ -0,0 +1,101 @@
+// SimNvm.c
+// Page de flash des paramtres (fonctions de Mc32NVMUtil.h)
+//
+// eedata_addr est dclare const dans Mc32NVMUtil.h (flash, crite par le
+// contrleur NVM) ; elle est dfinie ici sans const, seules les
+// fonctions NVM l'crivent, comme sur la cible. Avec SIM_NvmFichier la
+// page est charge depuis un fichier et rcrite  chaque criture : les
+// paramtres sauvs survivent au redmarrage du simulateur.
+//
+//---------------------------------------------------------------------------
+
+#include <stdio.h>
+#include <string.h>
+#include "Simulation.h"
+
+// Mc32NVMUtil.h n'est pas inclus : eedata_addr y est const
+#define DEVICE_ROW_SIZE_DIVIDED_BY_4 128
+
+uint32_t eedata_addr[DEVICE_ROW_SIZE_DIVIDED_BY_4] = {
+    [0 ... DEVICE_ROW_SIZE_DIVIDED_BY_4 - 1] = 0xFFFFFFFF
+};
+uint32_t databuff[DEVICE_ROW_SIZE_DIVIDED_BY_4];
+
+static const char *pFichier = NULL;
+static uint32_t nbEcritures = 0;
+
+void SIM_NvmFichier(const char *chemin) {
+    FILE *f;
+
+    pFichier = chemin;
+    memset(eedata_addr, 0xFF, sizeof (eedata_addr));
+    if (chemin == NULL) {
+        return;
+    }
+    f = fopen(chemin, "rb");
+    if (f != NULL) {
+        if (fread(eedata_addr, 1, sizeof (eedata_addr), f) != sizeof (eedata_addr)) {
+            memset(eedata_addr, 0xFF, sizeof (eedata_addr));
+        }
+        fclose(f);
+    }
+}
+
+uint32_t SIM_NvmNbEcritures(void) {
+    return nbEcritures;
+}
+
+void Init_DataBuff(void) {
+    int i;
+
+    for (i = 0; i < DEVICE_ROW_SIZE_DIVIDED_BY_4; i++) {
+        databuff[i] = i * 10;
+    }
+}
+
+uint32_t NVM_ArrayRead(uint32_t index) {
+    return eedata_addr[index];
+}
+
+void NVMpageErase(uint32_t address) {
+    (void) address;
+    memset(eedata_addr, 0xFF, sizeof (eedata_addr));
+}
+
+void NVMwriteRow(uint32_t destAddr, uint32_t srcAddr) {
+    FILE *f;
+    int i;
+
+    (void) destAddr;
+    (void) srcAddr;
+    // La flash ne fait passer les bits que de 1  0
+    for (i = 0; i < DEVICE_ROW_SIZE_DIVIDED_BY_4; i++) {
+        eedata_addr[i] &= databuff[i];
+    }
+    nbEcritures++;
+    if (pFichier != NULL) {
+        f = fopen(pFichier, "wb");
+        if (f != NULL) {
+            fwrite(eedata_addr, 1, sizeof (eedata_addr), f);
+            fclose(f);
+        }
+    }
+}
+
+void NVM_ReadBlock(uint32_t *pData, uint32_t DataSize) {
+    uint32_t i;
+
+    for (i = 0; i < (DataSize + 3) / 4; i++) {
+        pData[i] = eedata_addr[i];
+    }
+}
+
+void NVM_WriteBlock(uint32_t *pData, uint32_t DataSize) {
+    uint32_t i;
+
+    NVMpageErase(0);
+    for (i = 0; i < (DataSize + 3) / 4; i++) {
+        databuff[i] = pData[i];
+    }
+    NVMwriteRow(0, 0);
+}
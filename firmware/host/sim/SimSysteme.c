@@ -0,0 +1,77 @@
+// SimSysteme.c
+// Initialisation du systme, tches sans quivalent sur PC et boucle
+// principale de main.c
+//
+// main.c et system_init.c ne sont pas compils : la boucle est rejoue
+// tour par tour par SIM_Tour, dans l'ordre de main.c, le temps d'un tour
+// s'coulant aprs SYS_Tasks. MESURE_PeintPile n'est pas appele (la
+// pile du PC n'est pas celle du PIC32).
+//
+//---------------------------------------------------------------------------
+
+#include "Simulation.h"
+#include "system_config.h"
+#include "system_definitions.h"
+#include "GesMesure.h"
+#include "GesSched.h"
+
+SYSTEM_OBJECTS sysObj;
+
+static uint64_t dureeTour = SIM_NS(SIM_DUREE_TOUR_NS);
+
+void SYS_Initialize(void *data) {
+    (void) data;
+    APP_Initialize();
+    APPGEN_Initialize();
+}
+
+void SYS_TMR_Tasks(SYS_MODULE_OBJ object) {
+    (void) object;
+}
+
+void DRV_MIIM_Tasks(SYS_MODULE_OBJ object) {
+    (void) object;
+}
+
+void DRV_USBFS_Tasks(SYS_MODULE_OBJ object) {
+    (void) object;
+}
+
+void DRV_USBFS_Tasks_ISR(SYS_MODULE_OBJ object) {
+    (void) object;
+}
+
+void USB_DEVICE_Tasks(SYS_MODULE_OBJ object) {
+    (void) object;
+}
+
+void DRV_ETHMAC_Tasks_ISR(SYS_MODULE_OBJ object) {
+    (void) object;
+}
+
+void DRV_TMR_Tasks(SYS_MODULE_OBJ object) {
+    (void) object;
+}
+
+void SIM_ChangeDureeTour(uint32_t dureeNs) {
+    dureeTour = SIM_NS(dureeNs);
+}
+
+void SIM_Tour(void) {
+    MESURE_DEBUT(debutBoucle);
+
+    SYS_Tasks();
+    SIM_Avance(dureeTour);
+
+    MESURE_FIN(&mesureBoucle, debutBoucle);
+
+    SCHED_Attente();
+}
+
+void SIM_Tourne(uint64_t duree) {
+    uint64_t fin = SIM_Temps() + duree;
+
+    while (SIM_Temps() < fin) {
+        SIM_Tour();
+    }
+}
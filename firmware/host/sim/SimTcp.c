@@ -0,0 +1,282 @@
+// SimTcp.c
+// Pile TCP/IP rduite au serveur de app.c (fonctions de tcpip.h)
+//
+// Une interface toujours prte, un socket serveur avec ses FIFO RX et TX
+// de la taille configure dans system_config.h. Le client est soit
+// virtuel (SIM_TcpConnecte, SIM_TcpEnvoie, SIM_TcpRecoit), soit un vrai
+// client TCP du PC accept par SIM_TcpEcoute : TCPIP_STACK_Task fait
+// alors passer les octets entre le socket du PC et les FIFO, comme la
+// pile Harmony entre le MAC et les sockets.
+//
+//---------------------------------------------------------------------------
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include "Simulation.h"
+#include "system_config.h"
+#include "tcpip/tcpip.h"
+
+// Adresse de l'interface (192.168.100.115), octet de poids faible en tte
+#define SIM_ADRESSE_IP 0x7364A8C0u
+
+typedef struct {
+    uint8_t Donnees[512];
+    uint16_t Taille;
+    uint16_t Debut;
+    uint16_t Nb;
+} S_SimFifo;
+
+static S_SimFifo fifoRx = {.Taille = TCPIP_TCP_SOCKET_DEFAULT_RX_SIZE};
+static S_SimFifo fifoTx = {.Taille = TCPIP_TCP_SOCKET_DEFAULT_TX_SIZE};
+
+static bool serveurOuvert = false;
+static bool clientPresent = false;
+
+// Vrai socket du PC
+static int socketEcoute = -1;
+static int socketClient = -1;
+
+// *****************************************************************************
+// FIFO
+// *****************************************************************************
+
+static uint16_t SIM_FifoPlace(const S_SimFifo *pFifo) {
+    return pFifo->Taille - pFifo->Nb;
+}
+
+static uint16_t SIM_FifoEcrit(S_SimFifo *pFifo, const uint8_t *pDonnees, uint16_t longueur) {
+    uint16_t i;
+
+    if (longueur > SIM_FifoPlace(pFifo)) {
+        longueur = SIM_FifoPlace(pFifo);
+    }
+    for (i = 0; i < longueur; i++) {
+        pFifo->Donnees[(pFifo->Debut + pFifo->Nb) % pFifo->Taille] = pDonnees[i];
+        pFifo->Nb++;
+    }
+    return longueur;
+}
+
+static uint16_t SIM_FifoLit(S_SimFifo *pFifo, uint8_t *pTampon, uint16_t taille) {
+    uint16_t i;
+
+    if (taille > pFifo->Nb) {
+        taille = pFifo->Nb;
+    }
+    for (i = 0; i < taille; i++) {
+        pTampon[i] = pFifo->Donnees[pFifo->Debut];
+        pFifo->Debut = (pFifo->Debut + 1) % pFifo->Taille;
+        pFifo->Nb--;
+    }
+    return taille;
+}
+
+static void SIM_FifoVide(S_SimFifo *pFifo) {
+    pFifo->Debut = 0;
+    pFifo->Nb = 0;
+}
+
+// *****************************************************************************
+// Client virtuel et socket du PC
+// *****************************************************************************
+
+void SIM_TcpConnecte(void) {
+    clientPresent = true;
+}
+
+void SIM_TcpDeconnecte(void) {
+    clientPresent = false;
+}
+
+uint16_t SIM_TcpEnvoie(const char *pDonnees, uint16_t longueur) {
+    if (!clientPresent || !serveurOuvert) {
+        return 0;
+    }
+    return SIM_FifoEcrit(&fifoRx, (const uint8_t *) pDonnees, longueur);
+}
+
+uint16_t SIM_TcpRecoit(char *pTampon, uint16_t taille) {
+    return SIM_FifoLit(&fifoTx, (uint8_t *) pTampon, taille);
+}
+
+bool SIM_TcpEcoute(uint16_t port) {
+    struct sockaddr_in adresse;
+    int un = 1;
+
+    socketEcoute = socket(AF_INET, SOCK_STREAM, 0);
+    if (socketEcoute < 0) {
+        return false;
+    }
+    setsockopt(socketEcoute, SOL_SOCKET, SO_REUSEADDR, &un, sizeof (un));
+    memset(&adresse, 0, sizeof (adresse));
+    adresse.sin_family = AF_INET;
+    adresse.sin_addr.s_addr = htonl(INADDR_ANY);
+    adresse.sin_port = htons(port);
+    if ((bind(socketEcoute, (struct sockaddr *) &adresse, sizeof (adresse)) < 0)
+            || (listen(socketEcoute, 1) < 0)) {
+        close(socketEcoute);
+        socketEcoute = -1;
+        return false;
+    }
+    fcntl(socketEcoute, F_SETFL, O_NONBLOCK);
+    return true;
+}
+
+static void SIM_FermeClient(void) {
+    if (socketClient >= 0) {
+        close(socketClient);
+        socketClient = -1;
+    }
+    clientPresent = false;
+}
+
+// Echanges avec le client du PC
+static void SIM_ServiceSocket(void) {
+    uint8_t tampon[512];
+    ssize_t nb;
+    int un = 1;
+
+    if (socketEcoute < 0) {
+        return;
+    }
+    if ((socketClient < 0) && serveurOuvert) {
+        socketClient = accept(socketEcoute, NULL, NULL);
+        if (socketClient >= 0) {
+            fcntl(socketClient, F_SETFL, O_NONBLOCK);
+            setsockopt(socketClient, IPPROTO_TCP, TCP_NODELAY, &un, sizeof (un));
+            clientPresent = true;
+        }
+    }
+    if (socketClient < 0) {
+        return;
+    }
+    if (SIM_FifoPlace(&fifoRx) > 0) {
+        nb = recv(socketClient, tampon, SIM_FifoPlace(&fifoRx), 0);
+        if (nb > 0) {
+            SIM_FifoEcrit(&fifoRx, tampon, (uint16_t) nb);
+        } else if ((nb == 0) || ((errno != EAGAIN) && (errno != EWOULDBLOCK))) {
+            SIM_FermeClient();
+            return;
+        }
+    }
+    while (fifoTx.Nb > 0) {
+        uint16_t longueur = SIM_FifoLit(&fifoTx, tampon, sizeof (tampon));
+        if (send(socketClient, tampon, longueur, MSG_NOSIGNAL) < 0) {
+            SIM_FermeClient();
+            return;
+        }
+    }
+}
+
+// *****************************************************************************
+// Pile et interface
+// *****************************************************************************
+
+SYS_STATUS TCPIP_STACK_Status(SYS_MODULE_OBJ object) {
+    (void) object;
+    return SYS_STATUS_READY;
+}
+
+void TCPIP_STACK_Task(SYS_MODULE_OBJ object) {
+    (void) object;
+    SIM_ServiceSocket();
+}
+
+int TCPIP_STACK_NumberOfNetworksGet(void) {
+    return 1;
+}
+
+TCPIP_NET_HANDLE TCPIP_STACK_IndexToNet(int netIx) {
+    static const int interface = 0;
+
+    return (netIx == 0) ? &interface : NULL;
+}
+
+const char *TCPIP_STACK_NetNameGet(TCPIP_NET_HANDLE netH) {
+    (void) netH;
+    return "PIC32INT";
+}
+
+const char *TCPIP_STACK_NetBIOSName(TCPIP_NET_HANDLE netH) {
+    (void) netH;
+    return "MCHPBOARD_E";
+}
+
+bool TCPIP_STACK_NetIsReady(TCPIP_NET_HANDLE netH) {
+    return netH != NULL;
+}
+
+uint32_t TCPIP_STACK_NetAddress(TCPIP_NET_HANDLE netH) {
+    (void) netH;
+    return SIM_ADRESSE_IP;
+}
+
+// *****************************************************************************
+// Socket serveur
+// *****************************************************************************
+
+TCP_SOCKET TCPIP_TCP_ServerOpen(IP_ADDRESS_TYPE addType, TCP_PORT localPort,
+        IP_MULTI_ADDRESS *localAddress) {
+    (void) addType;
+    (void) localPort;
+    (void) localAddress;
+    if (serveurOuvert) {
+        return INVALID_SOCKET;
+    }
+    serveurOuvert = true;
+    SIM_FifoVide(&fifoRx);
+    SIM_FifoVide(&fifoTx);
+    return 0;
+}
+
+bool TCPIP_TCP_OptionsSet(TCP_SOCKET hTCP, TCP_SOCKET_OPTION option, void *optParam) {
+    (void) option;
+    (void) optParam;
+    return hTCP == 0;
+}
+
+bool TCPIP_TCP_IsConnected(TCP_SOCKET hTCP) {
+    return (hTCP == 0) && serveurOuvert && clientPresent;
+}
+
+uint16_t TCPIP_TCP_GetIsReady(TCP_SOCKET hTCP) {
+    return TCPIP_TCP_IsConnected(hTCP) ? fifoRx.Nb : 0;
+}
+
+uint16_t TCPIP_TCP_PutIsReady(TCP_SOCKET hTCP) {
+    return TCPIP_TCP_IsConnected(hTCP) ? SIM_FifoPlace(&fifoTx) : 0;
+}
+
+uint16_t TCPIP_TCP_ArrayGet(TCP_SOCKET hTCP, uint8_t *buffer, uint16_t count) {
+    if (!TCPIP_TCP_IsConnected(hTCP)) {
+        return 0;
+    }
+    return SIM_FifoLit(&fifoRx, buffer, count);
+}
+
+uint16_t TCPIP_TCP_ArrayPut(TCP_SOCKET hTCP, const uint8_t *Data, uint16_t Len) {
+    if (!TCPIP_TCP_IsConnected(hTCP)) {
+        return 0;
+    }
+    return SIM_FifoEcrit(&fifoTx, Data, Len);
+}
+
+bool TCPIP_TCP_Flush(TCP_SOCKET hTCP) {
+    return TCPIP_TCP_IsConnected(hTCP);
+}
+
+void TCPIP_TCP_Close(TCP_SOCKET hTCP) {
+    if (hTCP != 0) {
+        return;
+    }
+    // Le serveur ferme la connexion : le client du PC est dconnect, le
+    // client virtuel devra se reconnecter
+    SIM_ServiceSocket();
+    SIM_FermeClient();
+    serveurOuvert = false;
+}
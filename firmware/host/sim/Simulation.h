@@ -0,0 +1,170 @@
+#ifndef Simulation_h
+#define Simulation_h
+
+// Simulation.h
+// Simulateur du gnrateur sur PC : matriel du kit autour des modules de
+// ../src compils sans modification
+//
+// Principe : le temps simul compte les priodes de PBCLK (80 MHz,
+//            12.5 ns). Le programme avance par tours de la boucle de
+//            main.c (SIM_Tour) : SYS_Tasks, puis le temps avance d'une
+//            dure de tour fixe pendant laquelle les interruptions
+//            (Timer1, Timer3, capture IC1) sont excutes dans l'ordre de
+//            leurs chances, chacune  son instant exact. La boucle
+//            principale n'est donc jamais interrompue au milieu d'une
+//            instruction : les sections protges (SYS_INT_Disable) n'ont
+//            rien  protger, la chronologie des chantillons du DAC est
+//            exacte.
+//
+//  Matriel :
+//       Timers        compteur, priode, prdiviseur, horloge PBCLK ou
+//                     externe (SIM_HorlogeExterne), interruption  chaque
+//                     galit compteur / priode (SimMateriel.c)
+//       IC1           capture de TMR3 sur un front (SIM_FrontDeclenchement)
+//       Broches       LED0..7, PEC12, S9 (bsp.h, SimBroches)
+//       DAC           mots SPI et mises  jour des sorties du LTC2604
+//                     horodats (SimDac.c)
+//       LCD           cran 4 x 20 (SimLcd.c)
+//       Flash         page des paramtres en mmoire ou dans un fichier
+//                     (SimNvm.c)
+//       TCP           socket serveur aliment par un client virtuel ou
+//                     par un vrai socket du PC (SimTcp.c)
+//       Console       commandes SYS_CMD, tampon d'impression et file
+//                     d'criture USB (SimConsole.c)
+//
+//---------------------------------------------------------------------------
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "SimHarmony.h"
+#include "GesDac.h"
+
+// *****************************************************************************
+// Temps et interruptions (SimMateriel.c)
+// *****************************************************************************
+
+// Horloge du temps simul (PBCLK du PIC32MX)
+#define SIM_HORLOGE 80000000u
+// Conversions temps simul <-> ns / us
+#define SIM_NS(ns) (((uint64_t) (ns) * (SIM_HORLOGE / 1000000u)) / 1000u)
+#define SIM_US(us) ((uint64_t) (us) * (SIM_HORLOGE / 1000000u))
+#define SIM_MS(ms) ((uint64_t) (ms) * (SIM_HORLOGE / 1000u))
+#define SIM_EN_NS(pas) (((uint64_t) (pas) * 1000u) / (SIM_HORLOGE / 1000000u))
+
+// Instant courant (pas de PBCLK)
+uint64_t SIM_Temps(void);
+// Avance le temps en excutant les interruptions chues
+void SIM_Avance(uint64_t duree);
+// Retard d'entre en interruption (ns), 0 par dfaut
+void SIM_ChangeLatenceIsr(uint32_t latenceNs);
+// Nombre d'interruptions excutes par source
+uint32_t SIM_NbInterruptions(INT_SOURCE source);
+
+// Horloge externe du Timer3 (T3CK) : premier front  l'instant phase,
+// puis un front par priode. frequence = 0 : pas d'horloge
+void SIM_HorlogeExterne(uint32_t frequence, uint64_t phase);
+// Front montant sur IC1  l'instant donn (>= SIM_Temps()) : capture de
+// TMR3  cet instant, interruption aprs la latence
+void SIM_FrontDeclenchement(uint64_t instant);
+
+// *****************************************************************************
+// Boucle principale (SimSysteme.c)
+// *****************************************************************************
+
+// Dure d'un tour de boucle (ns), 10 us par dfaut
+#define SIM_DUREE_TOUR_NS 10000
+void SIM_ChangeDureeTour(uint32_t dureeNs);
+// Un tour de la boucle de main.c (SYS_Tasks, temps du tour, SCHED_Attente)
+void SIM_Tour(void);
+// Tours de boucle pendant une dure
+void SIM_Tourne(uint64_t duree);
+
+// *****************************************************************************
+// DAC LTC2604 (SimDac.c)
+// *****************************************************************************
+
+// Mot SPI : dpt dans le FIFO, remonte de CS (fin de trame)
+typedef struct {
+    uint64_t Debut;
+    uint64_t Fin;
+    uint32_t Mot;
+} S_SimMotDac;
+
+// Mise  jour des sorties (front montant de CS d'une commande de mise 
+// jour) et valeurs de toutes les sorties aprs la mise  jour
+typedef struct {
+    uint64_t Temps;
+    uint16_t Valeurs[DAC_NB_CANAUX];
+} S_SimMajDac;
+
+// Capacit des enregistrements, les suivants sont compts et perdus
+#define SIM_DAC_CAPACITE (1u << 18)
+
+void SIM_DacRaz(void);
+uint32_t SIM_DacNbMots(void);
+const S_SimMotDac *SIM_DacMots(void);
+uint32_t SIM_DacNbMaj(void);
+const S_SimMajDac *SIM_DacMaj(void);
+uint32_t SIM_DacNbPerdus(void);
+// Mots dont la trame a commenc avant la fin de la prcdente (SCK trop
+// lente pour la cadence)
+uint32_t SIM_DacNbChevauchements(void);
+uint16_t SIM_DacSortie(uint8_t canal);
+
+// *****************************************************************************
+// LCD (SimLcd.c)
+// *****************************************************************************
+
+#define SIM_LCD_LIGNES 4
+#define SIM_LCD_COLONNES 20
+
+// Contenu d'une ligne (1..4), SIM_LCD_COLONNES caractres
+const char *SIM_LcdLigne(uint8_t ligne);
+bool SIM_LcdRetroEclairage(void);
+// Octets reus par l'afficheur (caractres et commandes)
+uint32_t SIM_LcdNbOctets(void);
+
+// *****************************************************************************
+// Flash des paramtres (SimNvm.c)
+// *****************************************************************************
+
+// Page lue dans le fichier (efface s'il n'existe pas) et rcrite 
+// chaque NVM_WriteBlock. NULL : page en mmoire seulement
+void SIM_NvmFichier(const char *chemin);
+uint32_t SIM_NvmNbEcritures(void);
+
+// *****************************************************************************
+// TCP (SimTcp.c)
+// *****************************************************************************
+
+// Client virtuel : connexion, envoi vers la FIFO RX du serveur, lecture
+// de la FIFO TX. Retournent le nombre d'octets transfrs
+void SIM_TcpConnecte(void);
+void SIM_TcpDeconnecte(void);
+uint16_t SIM_TcpEnvoie(const char *pDonnees, uint16_t longueur);
+uint16_t SIM_TcpRecoit(char *pTampon, uint16_t taille);
+// Vrai socket du PC  la place du client virtuel (un client  la fois)
+bool SIM_TcpEcoute(uint16_t port);
+
+// *****************************************************************************
+// Console (SimConsole.c)
+// *****************************************************************************
+
+// Ligne de commande excute au prochain SYS_CMD_Tasks, le nom du groupe
+// ("gen") est facultatif. false si une commande est dj en attente
+bool SIM_Commande(const char *ligne);
+// Texte sorti par l'USB depuis le dernier appel (consomm)
+uint32_t SIM_ConsoleLit(char *pTampon, uint32_t taille);
+// Recopie du texte sorti sur stdout
+void SIM_ConsoleEcho(bool actif);
+
+typedef struct {
+    uint32_t NbEcritures;   // critures envoyes par l'USB
+    uint32_t NbPerdues;     // file d'criture pleine
+    uint32_t NbEcrasees;    // texte rcrit avant d'tre envoy
+    uint32_t NbTronquees;   // print plus long que le tampon
+} S_SimConsole;
+
+const S_SimConsole *SIM_ConsoleCompteurs(void);
+
+#endif
@@ -19,7 +19,14 @@
 #define MAGIC 0x123455AA 
 
 // Enumration pour les signaux  afficher
-typedef enum  { SignalSinus, SignalTriangle, SignalDentDeScie, SignalCarre } E_FormesSignal;
+// Les formes  partir de SignalBruitBlanc n'ont pas de table, elles sont
+// calcules chantillon par chantillon (GesBruit)
+typedef enum  { SignalSinus, SignalTriangle, SignalDentDeScie, SignalCarre,
+                SignalBruitBlanc, SignalBruitRose, SignalPrbs7, SignalPrbs15,
+                SignalPrbs23 } E_FormesSignal;
+
+// Dernire forme (bornes du menu)
+#define SIGNAL_DERNIERE_FORME SignalPrbs23
 
 // Structure des paramtres du gnrateur
 typedef struct {
@@ -2,23 +2,66 @@
 // Fichier Generateur.C
 // Gestion  du gnrateur
 
-// Prvu pour signal de 40 echantillons
+// Table de GENSIG_LONGUEUR_MIN  GENSIG_LONGUEUR_MAX chantillons selon
+// la frquence, GENSIG_NB_TABLES tables gardes (la moins rcemment
+// utilise est recalcule), change dans l'interruption Timer3
 
 // Migration sur PIC32 30.04.2014 C. Huber
 
 
+#include <stdbool.h>
+#include <stddef.h>
+#include <xc.h>
 #include "Generateur.h"
 #include "DefMenuGen.h"
 #include "Mc32gestSpiDac.h"
 #include "system_config.h"
+#include "system_definitions.h"
 #include "Mc32NVMUtil.h"
-#include "Mc32DriverLcd.h"
-#include <math.h>
-#include "Mc32NVMUtil.h"
+#include "GesSignal.h"
+#include "GesBruit.h"
+#include "GesLatence.h"
+#include "GesTrace.h"
+#include "GesMesure.h"
+#include "bsp.h"
+
+#if (GENSIG_NB_CANAUX < 1) || (GENSIG_NB_CANAUX > DAC_NB_CANAUX)
+#error "GENSIG_NB_CANAUX : 1 a DAC_NB_CANAUX"
+#endif
 
 // Variables globales
 S_ParamGen valeursParamGen;
-int32_t tableauValeursSignal[MAX_ECH];
+// Tables d'chantillons : l'une est envoye au DAC (pTableActive), les
+// autres gardent les signaux prcdents
+static S_TableSignal tablesSignal[GENSIG_NB_TABLES] GENSIG_TABLE_ATTR;
+// Date de la dernire utilisation d'une table (ordre LRU)
+static uint32_t dateTables = 0;
+// Compteurs des tables reprises et calcules
+S_CacheTables cacheTables;
+static S_TableSignal * volatile pTableActive = &tablesSignal[0];
+// Table calcule, pas encore prise par l'interruption (NULL si aucune)
+static S_TableSignal * volatile pTableSuivante = NULL;
+// Priode d'chantillonnage en pas du core timer (pour la mesure de gigue)
+static volatile uint32_t periodeCoreTimer = 0;
+// Derniers paramtres appliqus (recalcul aprs un changement d'horloge SPI)
+static S_ParamGen paramCourant;
+// Phase de la synchronisation (fraction de priode sur 16 bits) et index
+// correspondant dans la table active
+static volatile uint16_t phaseSync = 0;
+static volatile uint16_t indexSync = 0;
+// Horloge du Timer3 (Hz) et source externe (T3CK)
+static uint32_t horlogeTimer = GENSIG_HORLOGE_TIMER;
+static bool horlogeExterne = false;
+// Front de dclenchement reu, index  remettre  0
+static volatile bool declenchement = false;
+static volatile uint32_t nbDeclenchements = 0;
+// Etat des formes calcules  chaque chantillon (bruit, PRBS)
+static S_Bruit bruit;
+// Paramtres en attente de la construction de leur forme (GENSIG_Tasks)
+static S_ParamGen paramEnAttente;
+static bool enAttente = false;
+// paramCourant appliqu au moins une fois
+static bool paramAppliques = false;
 
 //----------------------------------------------------------------------------
 //  GENSIG_Initialize
@@ -26,6 +69,12 @@ int32_t tableauValeursSignal[MAX_ECH];
 //----------------------------------------------------------------------------
 
 void GENSIG_Initialize(S_ParamGen *pParam) {
+    // Quart de sinus de rfrence, seul calcul en virgule flottante
+    SIGNAL_Init();
+    BRUIT_Init(&bruit, 0x2545F491u);
+    // Table active vide (chantillons  0) jusqu'au premier calcul
+    tablesSignal[0].Longueur = GENSIG_LONGUEUR_MIN;
+
     // Lecture du bloc mmoire sauv prcdemment
     NVM_ReadBlock((uint32_t*) & valeursParamGen, sizeof (S_ParamGen));
 
@@ -44,114 +93,467 @@ void GENSIG_Initialize(S_ParamGen *pParam) {
 }
 
 //----------------------------------------------------------------------------
-//  GENSIG_UpdatePeriode
-//  Met  jour la priode d?chantillonnage en fonction de la frquence
+//  GENSIG_ChercheTable
+//  Table dj calcule pour pParam et longueur, sinon la table la moins
+//  rcemment utilise hors table active ( recalculer, pCalcul = true)
+//----------------------------------------------------------------------------
+
+static S_TableSignal *GENSIG_ChercheTable(const S_ParamGen *pParam, uint16_t longueur,
+        bool *pCalcul) {
+    S_TableSignal *pTable;
+    S_TableSignal *pAncienne = NULL;
+    uint8_t i;
+
+    for (i = 0; i < GENSIG_NB_TABLES; i++) {
+        pTable = &tablesSignal[i];
+        if ((pTable->Utilisation != 0) && (pTable->Forme == pParam->Forme)
+                && (pTable->Amplitude == pParam->Amplitude)
+                && (pTable->Offset == pParam->Offset) && (pTable->Longueur == longueur)) {
+            *pCalcul = false;
+            return pTable;
+        }
+        if ((pTable != pTableActive)
+                && ((pAncienne == NULL) || (pTable->Utilisation < pAncienne->Utilisation))) {
+            pAncienne = pTable;
+        }
+    }
+    *pCalcul = true;
+    return pAncienne;
+}
+
+//----------------------------------------------------------------------------
+//  GENSIG_Applique
+//  Calcul ou reprise de la table et publication, sans comparaison avec
+//  les paramtres courants (recalcul aprs un changement d'horloge)
 //----------------------------------------------------------------------------
 
-void GENSIG_UpdatePeriode(S_ParamGen *pParam) {
-    static uint16_t compteurTimer3;
-    // Ajustement du timer en fonction de la frquence
-    compteurTimer3 = (uint16_t) ((TRANSFORMATION_VALEUR_TIMER3 / pParam->Frequence));
-    PLIB_TMR_Period16BitSet(TMR_ID_3, compteurTimer3);
+static void GENSIG_Applique(const S_ParamGen *pParam) {
+    S_TableSignal *pLibre;
+    uint32_t periode;
+    uint16_t longueur;
+    bool calcul;
+    int16_t frequence = pParam->Frequence;
+
+    if (frequence <= 0) {
+        frequence = 1;
+    }
+    paramCourant = *pParam;
+    paramAppliques = true;
+    longueur = SIGNAL_Longueur(frequence, GENSIG_FechMax());
+
+    // Retrait d'une table publie et pas encore prise : aprs cette
+    // criture l'interruption ne change plus de table, toutes celles qui
+    // ne sont pas actives sont libres
+    pTableSuivante = NULL;
+    __asm__ __volatile__("" ::: "memory");
+    pLibre = GENSIG_ChercheTable(pParam, longueur, &calcul);
+
+    // Forme  bande limite pas encore construite : la table active reste
+    // en service, GENSIG_Tasks reprend la mise  jour
+    if (calcul && !SIGNAL_EST_BRUIT(pParam->Forme)
+            && !SIGNAL_FormePrete(pParam->Forme, longueur)) {
+        paramEnAttente = *pParam;
+        enAttente = true;
+        return;
+    }
+    enAttente = false;
+
+    if (calcul) {
+        // Calcul indpendant du matriel (GesSignal)
+        pLibre->Forme = pParam->Forme;
+        pLibre->Amplitude = pParam->Amplitude;
+        pLibre->Offset = pParam->Offset;
+        pLibre->Longueur = longueur;
+        if (SIGNAL_EST_BRUIT(pParam->Forme)) {
+            // Pas de table : valeurs calcules par l'interruption
+            SIGNAL_CalculeEchelle(pParam, &pLibre->Milieu, &pLibre->Gain);
+        } else {
+            SIGNAL_CalculeTable(pParam, pLibre->Echantillons, longueur);
+        }
+        cacheTables.NbCalculs++;
+    } else {
+        cacheTables.NbReprises++;
+    }
+    dateTables++;
+    pLibre->Utilisation = dateTables;
+
+    // Timer3 sans prdiviseur (PR3 = priode - 1), core timer 
+    // SYS_CLK_FREQ / 2
+    periode = (horlogeTimer + ((uint32_t) frequence * pLibre->Longueur) / 2)
+            / ((uint32_t) frequence * pLibre->Longueur);
+    if (periode > 65536) {
+        periode = 65536;
+    }
+    if (periode < 1) {
+        periode = 1;
+    }
+    pLibre->PeriodeTimer = (uint16_t) (periode - 1);
+    pLibre->PeriodeCoreTimer = (uint32_t) (((uint64_t) periode * SYS_CLK_FREQ)
+            / (2 * (uint64_t) horlogeTimer));
+
+    TRACE_Ecrit(TRACE_TABLE, pParam->Forme);
+    // Mesure de latence d'une commande TCP : la table est prte
+    LATENCE_TablePreparee();
+
+    // Publication de la table complte
+    __asm__ __volatile__("" ::: "memory");
+    pTableSuivante = pLibre;
 }
 
 //-------------------------------
-// Mise  jour du signal (forme, amplitude, offset)
+// Mise  jour du signal (forme, frquence, amplitude, offset)
 // Entres : Pointeur sur la structure S_ParamGen : pParam
 // Sortie  : -
+//
+// La longueur de table dpend de la frquence, la priode du Timer3 en
+// dcoule : priode = horloge Timer3 / (Frequence * Longueur). La table
+// et sa priode sont publies ensemble, l'interruption les applique au
+// mme chantillon.
+// Une table dj calcule pour la mme forme, amplitude, offset et
+// longueur est reprise sans calcul, ventuellement la table active
+// elle-mme (seule la priode change).
+// Des paramtres identiques aux derniers appliqus ne changent rien (le
+// mode remote appelle cette fonction  chaque service) : ni change de
+// table ni rechargement de PR3.
 //-------------------------------
 
 void GENSIG_UpdateSignal(S_ParamGen *pParam) {
-    uint8_t nbEchantillon = 0;
-    uint16_t amplitude = 0;
-    int16_t offset = 0;
-
-    // Calcul de l'chelle amplitude et offset
-    amplitude = pParam->Amplitude / 100;
-    offset = pParam->Offset / 2;
-
-    // Parcours de tous les chantillons
-    for (nbEchantillon = 0; nbEchantillon < MAX_ECH; nbEchantillon++) {
-        int32_t valeurBrute = 0; // valeur brute avant crtage et conversion
-
-        switch (pParam->Forme) {
-            case SignalSinus:
-            {
-                // Calcul de l'angle en radians pour nbEchantillon
-                float angle = 2 * (float) M_PI * ((float) nbEchantillon / MAX_ECH);
-
-                // On utilise sin(angle) qui varie entre -1 et +1
-                float sinusFloat = sinf(angle) * MOITIE_ECH;
-
-                // application de l'amplitude
-                int32_t sinusScaled = (int32_t) (sinusFloat) * amplitude;
-
-                valeurBrute = (int32_t) (MOITIE_AMPLITUDE - offset) + sinusScaled;
-            }
-                break;
-
-            case SignalTriangle:
-            {
-                // Monte sur la premire moiti, descente sur la seconde
-                if (nbEchantillon < (MAX_ECH / 2)) {
-                    valeurBrute = (int32_t) (MOITIE_AMPLITUDE - offset)
-                            + (int32_t) (amplitude * (2 * (nbEchantillon - 25)));
-                } else {
-                    valeurBrute = (int32_t) (MOITIE_AMPLITUDE - offset)
-                            + (int32_t) (amplitude * (100 - 2 * (nbEchantillon - 25)));
-                }
-            }
-                break;
-
-            case SignalDentDeScie:
-            {
-                // Valeur linaire sur MAX_ECH points
-                valeurBrute = (int32_t) (MOITIE_AMPLITUDE - offset)
-                        + (int32_t) ((nbEchantillon - 50) * amplitude);
-            }
-                break;
-
-            case SignalCarre:
-            {
-                // Hauteur max sur la premire moiti, hauteur min sur la seconde
-                if (nbEchantillon < (MAX_ECH / 2)) {
-                    valeurBrute = (int32_t) (MOITIE_AMPLITUDE)
-                            + (int32_t) (amplitude / 2 * (float) MAX_ECH)
-                            - (int32_t) offset;
-                } else {
-                    valeurBrute = (int32_t) (MOITIE_AMPLITUDE)
-                            - (int32_t) ((amplitude / 2 * (float) MAX_ECH) + offset);
-                }
-            }
-                break;
-            default:
-                break;
+    if (paramAppliques && (pParam->Forme == paramCourant.Forme)
+            && (pParam->Frequence == paramCourant.Frequence)
+            && (pParam->Amplitude == paramCourant.Amplitude)
+            && (pParam->Offset == paramCourant.Offset)) {
+        // Table dj active, publie ou en construction
+        if (!enAttente) {
+            LATENCE_SansEffet();
         }
+        return;
+    }
+    GENSIG_Applique(pParam);
+}
+
+//----------------------------------------------------------------------------
+//  GENSIG_Tasks
+//  Etapes de la construction en attente jusqu' GENSIG_BUDGET_CYCLES, puis
+//  fin de la mise  jour quand la forme est prte
+//----------------------------------------------------------------------------
+
+bool GENSIG_Tasks(void) {
+    uint32_t debut;
+    bool resteEtapes;
+
+    if (!enAttente) {
+        return false;
+    }
+    debut = MESURE_Lire();
+    do {
+        resteEtapes = SIGNAL_Avance();
+    } while (resteEtapes && ((MESURE_Lire() - debut) < GENSIG_BUDGET_CYCLES));
+
+    if (!resteEtapes) {
+        GENSIG_Applique(&paramEnAttente);
+    }
+    return true;
+}
+
+//----------------------------------------------------------------------------
+//  GENSIG_PeriodeCoreTimer
+//  Priode d'chantillonnage courante en pas du core timer
+//----------------------------------------------------------------------------
+
+uint32_t GENSIG_PeriodeCoreTimer(void) {
+    return periodeCoreTimer;
+}
+
+uint16_t GENSIG_LongueurActive(void) {
+    return pTableActive->Longueur;
+}
+
+//----------------------------------------------------------------------------
+//  GENSIG_FechMaxPour
+//  Frquence d'chantillonnage maximale pour une horloge SPI et une
+//  horloge du Timer3 donnes : limite du DAC (GesDac), du gnrateur et
+//  du Timer3
+//----------------------------------------------------------------------------
+
+static uint32_t GENSIG_FechMaxPour(uint32_t sck, uint32_t horloge) {
+    uint32_t fechMax = DAC_FechMax(sck, GENSIG_NB_CANAUX);
+
+    if (fechMax > GENSIG_FECH_MAX) {
+        fechMax = GENSIG_FECH_MAX;
+    }
+    if (fechMax > (horloge / GENSIG_PERIODE_MIN)) {
+        fechMax = horloge / GENSIG_PERIODE_MIN;
+    }
+    return fechMax;
+}
+
+uint32_t GENSIG_FechMax(void) {
+    return GENSIG_FechMaxPour(SPI_FrequenceDac(), horlogeTimer);
+}
+
+int16_t GENSIG_FrequenceMax(void) {
+    return (int16_t) (GENSIG_FechMax() / GENSIG_LONGUEUR_MIN);
+}
+
+//----------------------------------------------------------------------------
+//  GENSIG_ChoisitHorlogeSpi
+//  La nouvelle horloge est applique par l'interruption  l'change de
+//  table : une horloge plus lente n'est jamais utilise avec la cadence
+//  de l'ancienne table
+//----------------------------------------------------------------------------
+
+bool GENSIG_ChoisitHorlogeSpi(uint32_t frequence) {
+    uint32_t sck = SPI_SckPossible(frequence);
+
+    if (sck == 0) {
+        return false;
+    }
+    if (((uint32_t) paramCourant.Frequence * GENSIG_LONGUEUR_MIN)
+            > GENSIG_FechMaxPour(sck, horlogeTimer)) {
+        return false;
+    }
+    // Retrait de la table en attente avant le changement : l'interruption
+    // garde la table active jusqu'au recalcul
+    pTableSuivante = NULL;
+    SPI_ChoisitFrequenceDac(frequence);
+    GENSIG_Applique(&paramCourant);
+    return true;
+}
 
-        // crtage : borne la valeur entre 0 et MAX_AMPLITUDE
-        if (valeurBrute > MAX_AMPLITUDE) {
-            valeurBrute = MAX_AMPLITUDE;
-        } else if (valeurBrute < 0) {
-            valeurBrute = 0;
+//----------------------------------------------------------------------------
+//  GENSIG_ChoisitHorlogeTimer
+//  Le Timer3 est arrt pendant le changement de source. La priode de la
+//  table recalcule est charge avant le redmarrage, l'interruption
+//  prend la table au premier chantillon. Si la forme est en construction
+//  (GENSIG_Tasks), la table active repart avec sa priode jusqu' la fin
+//  de la construction.
+//----------------------------------------------------------------------------
+
+bool GENSIG_ChoisitHorlogeTimer(uint32_t frequenceExterne) {
+    uint32_t horloge = GENSIG_HORLOGE_TIMER;
+
+    if (frequenceExterne != 0) {
+        if ((frequenceExterne < GENSIG_HORLOGE_EXT_MIN)
+                || (frequenceExterne > GENSIG_HORLOGE_EXT_MAX)) {
+            return false;
         }
+        horloge = frequenceExterne;
+    }
+    if (((uint32_t) paramCourant.Frequence * GENSIG_LONGUEUR_MIN)
+            > GENSIG_FechMaxPour(SPI_FrequenceDac(), horloge)) {
+        return false;
+    }
+
+    pTableSuivante = NULL;
+    PLIB_TMR_Stop(TMR_ID_3);
+    // Plus d'chance en attente : la table publie reste en attente
+    PLIB_INT_SourceFlagClear(INT_ID_0, INT_SOURCE_TIMER_3);
+    PLIB_TMR_ClockSourceSelect(TMR_ID_3, (frequenceExterne != 0) ?
+            TMR_CLOCK_SOURCE_EXTERNAL_INPUT_PIN : TMR_CLOCK_SOURCE_PERIPHERAL_CLOCK);
+    horlogeTimer = horloge;
+    horlogeExterne = (frequenceExterne != 0);
+    GENSIG_Applique(&paramCourant);
+    PLIB_TMR_Counter16BitClear(TMR_ID_3);
+    PLIB_TMR_Period16BitSet(TMR_ID_3, (pTableSuivante != NULL) ?
+            pTableSuivante->PeriodeTimer : pTableActive->PeriodeTimer);
+    PLIB_TMR_Start(TMR_ID_3);
+    return true;
+}
+
+uint32_t GENSIG_HorlogeTimer(void) {
+    return horlogeTimer;
+}
+
+bool GENSIG_HorlogeExterne(void) {
+    return horlogeExterne;
+}
 
-        // Mise  l'chelle finale 0..10000 => 0..VAL_MAX_PAS
-        tableauValeursSignal[nbEchantillon] =
-                (int64_t) ((VAL_MAX_PAS * valeurBrute) / 10000);
+//----------------------------------------------------------------------------
+//  GENSIG_InitDeclenchement
+//  Capture IC1 sur chaque front montant, base de temps Timer3, mme
+//  priorit que le Timer3 : les deux interruptions ne s'interrompent pas
+//----------------------------------------------------------------------------
+
+void GENSIG_InitDeclenchement(void) {
+#ifdef GENSIG_DECLENCHEMENT_ENABLE
+    IC1CON = 0;
+    IC1CONbits.ICTMR = 0;   // base de temps Timer3
+    IC1CONbits.ICI = 0;     // interruption  chaque capture
+    IC1CONbits.ICM = 3;     // capture sur chaque front montant
+    PLIB_INT_VectorPrioritySet(INT_ID_0, INT_VECTOR_IC1, INT_PRIORITY_LEVEL7);
+    PLIB_INT_VectorSubPrioritySet(INT_ID_0, INT_VECTOR_IC1, INT_SUBPRIORITY_LEVEL0);
+    PLIB_INT_SourceFlagClear(INT_ID_0, INT_SOURCE_INPUT_CAPTURE_1);
+    PLIB_INT_SourceEnable(INT_ID_0, INT_SOURCE_INPUT_CAPTURE_1);
+    IC1CONbits.ON = 1;
+#endif
+}
+
+//----------------------------------------------------------------------------
+//  GENSIG_Declenche
+//  TMR3 reprend le temps coul depuis le front (modulo la priode, TMR3
+//  a pu reboucler entre le front et l'interruption) : l'chance suivante
+//  tombe une priode aprs le front, pourvu que l'interruption arrive
+//  moins d'une priode aprs lui. Un chantillon en attente (TMR3 a
+//  reboucl aprs le front) appartient  l'ancienne phase et est
+//  abandonn. Le temps entre la lecture et l'criture de TMR3 (quelques
+//  instructions) est le mme sur toutes les cartes.
+//  La priode est lue dans PR3 : une table reprise du cache peut tre la
+//  table active elle-mme, avec la priode de la configuration suivante
+//  dj crite mais pas encore applique.
+//----------------------------------------------------------------------------
+
+void GENSIG_Declenche(uint16_t capture) {
+    uint32_t periode = (uint32_t) PLIB_TMR_Period16BitGet(TMR_ID_3) + 1;
+    uint32_t compteur = PLIB_TMR_Counter16BitGet(TMR_ID_3);
+
+    PLIB_TMR_Counter16BitSet(TMR_ID_3, (uint16_t) ((compteur + periode - capture) % periode));
+    PLIB_INT_SourceFlagClear(INT_ID_0, INT_SOURCE_TIMER_3);
+    declenchement = true;
+    nbDeclenchements++;
+}
+
+uint32_t GENSIG_NbDeclenchements(void) {
+    return nbDeclenchements;
+}
+
+//----------------------------------------------------------------------------
+//  GENSIG_ChoisitPhaseSync
+//  L'index est recalcul ici pour la table active et par l'interruption 
+//  chaque change de table
+//----------------------------------------------------------------------------
+
+void GENSIG_ChoisitPhaseSync(uint16_t degres) {
+    phaseSync = (uint16_t) ((((uint32_t) (degres % 360)) << 16) / 360);
+    indexSync = (uint16_t) (((uint32_t) phaseSync * pTableActive->Longueur) >> 16);
+}
+
+uint16_t GENSIG_PhaseSync(void) {
+    return (uint16_t) ((((uint32_t) phaseSync * 360) + 0x8000) >> 16);
+}
+
+//----------------------------------------------------------------------------
+//  GENSIG_EchantillonBruit
+//  Echantillon suivant d'une forme sans table, mis  l'chelle du DAC
+//----------------------------------------------------------------------------
+
+static inline uint16_t GENSIG_EchantillonBruit(const S_TableSignal *pTable) {
+    int32_t code = (pTable->Milieu
+            + ((int32_t) BRUIT_Suivant(&bruit, pTable->Forme) * pTable->Gain)
+            + (1 << 13)) >> 14;
+
+    if (code > VAL_MAX_PAS) {
+        code = VAL_MAX_PAS;
+    } else if (code < 0) {
+        code = 0;
     }
+    return (uint16_t) code;
 }
 
 //----------------------------------------------------------------------------
 //  GENSIG_Execute
 //  Envoie cycliquement chaque chantillon au DAC
+//  Une table publie par GENSIG_UpdateSignal est prise immdiatement :
+//  l'index est mis  l'chelle de la nouvelle longueur pour conserver la
+//  phase, puis la priode du Timer3 est change. TMR3 vient de repartir
+//  de 0 et la plus petite priode (GENSIG_FECH_MAX) reste bien au-dessus
+//  du retard d'entre en interruption : TMR3 ne dpasse pas la nouvelle
+//  valeur de PR3.
+//  Avec DAC_NON_BLOQUANT, l'chantillon est dpos dans le FIFO du SPI
+//  et appliqu (CS remont)  l'entre de l'interruption suivante.
+//  La sortie de synchronisation est crite juste aprs la mise  jour du
+//  DAC de l'chantillon qu'elle marque, dans les deux modes.
+//  Les formes sans table (bruit, PRBS) sont calcules ici, une valeur par
+//  chantillon ; l'index avance quand mme (synchronisation tous les
+//  Longueur chantillons).
 //----------------------------------------------------------------------------
 
 void GENSIG_Execute(void) {
     static uint16_t EchNb = 0;
+#ifdef GENSIG_SYNC_ENABLE
+    // L'chantillon envoy est celui de la phase de synchronisation
+    static bool syncEnvoye = false;
+#endif
+    S_TableSignal *pTable = pTableActive;
+    S_TableSignal *pSuivante = pTableSuivante;
+    uint16_t echantillon;
+#if GENSIG_NB_CANAUX > 1
+    uint16_t valeurs[GENSIG_NB_CANAUX];
+    uint16_t dephasage;
+    uint8_t canal;
+#endif
+
+#ifdef DAC_NON_BLOQUANT
+    // Mise  jour du DAC avec l'chantillon envoy  la priode prcdente
+    SPI_FinMotDac();
+#ifdef GENSIG_SYNC_ENABLE
+    GENSIG_SYNC_W = syncEnvoye;
+#endif
+#endif
+
+    if (pSuivante != NULL) {
+        // Longueurs en puissances de 2 : la mise  l'chelle est exacte
+        // dans le sens de l'allongement
+        EchNb = (uint16_t) (((uint32_t) EchNb * pSuivante->Longueur) / pTable->Longueur);
+        pTable = pSuivante;
+        pTableActive = pSuivante;
+        pTableSuivante = NULL;
+        // Changement d'horloge SPI demand (GENSIG_ChoisitHorlogeSpi),
+        // appliqu avec la table calcule pour la nouvelle cadence
+        SPI_AppliqueFrequenceDac();
+        PLIB_TMR_Period16BitSet(TMR_ID_3, pTable->PeriodeTimer);
+        periodeCoreTimer = pTable->PeriodeCoreTimer;
+#ifdef GENSIG_SYNC_ENABLE
+        indexSync = (uint16_t) (((uint32_t) phaseSync * pTable->Longueur) >> 16);
+#endif
+        // Premire sortie d'une table recalcule : fin de la mesure de latence
+        LATENCE_TableActive();
+    }
+
+#ifdef GENSIG_DECLENCHEMENT_ENABLE
+    // Premire chance aprs un front de dclenchement : dbut de priode
+    if (declenchement) {
+        declenchement = false;
+        EchNb = 0;
+    }
+#endif
+
+    if (SIGNAL_EST_BRUIT(pTable->Forme)) {
+        echantillon = GENSIG_EchantillonBruit(pTable);
+    } else {
+        echantillon = pTable->Echantillons[EchNb];
+    }
 
     // criture sur le DAC du prochain chantillon
-    SPI_WriteToDac(0, tableauValeursSignal[EchNb]);
+#if GENSIG_NB_CANAUX > 1
+    // Un chantillon dphas par canal, sorties mises  jour ensemble
+    // (bruit : mme valeur sur tous les canaux)
+    dephasage = pTable->Longueur / GENSIG_NB_CANAUX;
+    valeurs[0] = echantillon;
+    for (canal = 1; canal < GENSIG_NB_CANAUX; canal++) {
+        valeurs[canal] = SIGNAL_EST_BRUIT(pTable->Forme) ? echantillon
+                : pTable->Echantillons[(EchNb + (canal * dephasage)) & (pTable->Longueur - 1)];
+    }
+#ifdef DAC_NON_BLOQUANT
+    SPI_DebutCanauxDac(valeurs, GENSIG_NB_CANAUX);
+#else
+    SPI_WriteCanauxDac(valeurs, GENSIG_NB_CANAUX);
+#endif
+#else
+#ifdef DAC_NON_BLOQUANT
+    SPI_DebutMotDac(LTC2604_MOT(0, echantillon));
+#else
+    SPI_WriteMotDac(LTC2604_MOT(0, echantillon));
+#endif
+#endif
+
+#ifdef GENSIG_SYNC_ENABLE
+    syncEnvoye = (EchNb == indexSync);
+#ifndef DAC_NON_BLOQUANT
+    // DAC dj mis  jour (criture bloquante)
+    GENSIG_SYNC_W = syncEnvoye;
+#endif
+#endif
 
     // Passage  l'chantillon suivant et gestion du dbordement
-    EchNb = (uint16_t) ((EchNb + 1) % MAX_ECH);
+    EchNb = (uint16_t) ((EchNb + 1) & (pTable->Longueur - 1));
 }
@@ -10,29 +10,183 @@
 // Section: Type Definitions
 // *****************************************************************************
 #include <math.h>
+#include <stdbool.h>
 #include <stdint.h>
 #include "DefMenuGen.h"
 
 // Dfinition des constantes
-#define MAX_ECH 100 // Nombre d'chantillons
-#define MOITIE_ECH 50 //Moiti des chantillons
 #define VAL_MAX_PAS 65535   // Nombre de pas maximum de convertion
-#define TRANSFORMATION_VALEUR_TIMER3 800000 // Valeur de frquence du timer 3
 #define MAX_AMPLITUDE 10000 // Amplitude maximum
 #define MOITIE_AMPLITUDE 5000   // Moitier de l'amplitude maximum
 
+// Longueur de la table d'chantillons : puissance de 2 choisie selon la
+// frquence (SIGNAL_Longueur), la plus grande qui garde la frquence
+// d'chantillonnage sous GENSIG_FechMax : GENSIG_FECH_MAX ou moins si
+// l'horloge SPI choisie ne permet pas cette cadence. 200 kS/s est la cadence de
+// l'ancienne table fixe de 100 points  2 kHz, dj tenue par le SPI
+// et l'interruption Timer3 (20 Hz -> 4096 points, 2 kHz -> 64 points).
+#define GENSIG_LONGUEUR_MIN 64
+#define GENSIG_LONGUEUR_MAX 4096
+#define GENSIG_FECH_MAX 200000
+// Canaux du DAC crits  chaque chantillon (1  DAC_NB_CANAUX). Le canal
+// k sort le mme signal dphas de k / GENSIG_NB_CANAUX priode ; au-del
+// d'un canal, les sorties sont mises  jour ensemble (commande "update
+// all" du LTC2604) au prix de GENSIG_NB_CANAUX + 1 trames SPI par
+// chantillon, ce qui abaisse GENSIG_FechMax
+#ifndef GENSIG_NB_CANAUX
+#define GENSIG_NB_CANAUX 1
+#endif
+
+// Sortie de synchronisation pour l'oscilloscope (commenter pour la
+// retirer, sans aucun cot dans l'interruption) : GENSIG_SYNC_W passe  1
+// pendant une priode d'chantillonnage, le front montant suit la mise 
+// jour du DAC (front montant de CS_DAC, RD4) de l'chantillon de phase
+// GENSIG_PhaseSync. Ecart CS_DAC -> broche : retour de SPI_FinMotDac ou
+// SPI_WriteMotDac et une criture de LAT, une dizaine d'instructions
+// (~150 ns  80 MHz), constant d'une priode  l'autre ;  contrler 
+// l'oscilloscope entre RD4 et la broche. La gigue du front par rapport 
+// l'chance est celle de l'interruption Timer3 (commande "gigue"), la
+// sortie analogique s'tablit ensuite en ~10 us (LTC2604).
+// Sans la synchro, LED0 indique la dure de l'interruption Timer3.
+#define GENSIG_SYNC_ENABLE
+// Broche de synchronisation (LED0 du kit)
+#define GENSIG_SYNC_W LED0_W
+
+// Horloge externe et dclenchement, pour verrouiller plusieurs
+// gnrateurs en phase (commenter pour retirer le dclenchement) :
+//  - horloge : le Timer3 compte les fronts de l'entre T3CK (RC2 sur le
+//    PIC32MX795) au lieu de PBCLK (GENSIG_ChoisitHorlogeTimer). Des
+//    cartes qui reoivent la mme horloge ont exactement la mme cadence
+//    d'chantillonnage, sans drive entre elles ;
+//  - dclenchement : un front montant sur IC1 (RD8) est horodat dans
+//    TMR3 par le module de capture. L'interruption remet TMR3 au temps
+//    coul depuis le front et l'index de table  0 : la priode
+//    suivante commence au front lui-mme, quel que soit le retard de
+//    l'interruption. Avec la mme horloge et les mmes paramtres, toutes
+//    les cartes sortent l'chantillon 0 au mme front d'horloge.
+//  Sans horloge sur T3CK le Timer3 s'arrte et la sortie reste fige.
+//  Retir par dfaut : le cblage de RC2 et RD8 sur le connecteur du kit
+//  n'est pas encore vrifi (une entre flottante sur RD8 dclencherait
+//  des remises  0 parasites).
+//#define GENSIG_DECLENCHEMENT_ENABLE
+// Horloge externe admise (Hz) : synchronise sur PBCLK, elle doit rester
+// bien en dessous de PBCLK / 2
+#define GENSIG_HORLOGE_EXT_MIN 100000
+#define GENSIG_HORLOGE_EXT_MAX 20000000
+// Priode minimale du Timer3 en pas de son horloge (rsolution de la
+// frquence avec une horloge externe lente)
+#define GENSIG_PERIODE_MIN 16
+
+// Nombre de tables en mmoire (au moins 2), 8 Ko chacune : l'une est
+// envoye au DAC, les autres gardent les derniers signaux calculs
+#define GENSIG_NB_TABLES 3
+
+// Temps maximum par appel de GENSIG_Tasks (pas du core timer, 25 ns) :
+// 300 us, plus une tape de SIGNAL_Avance commence (estime  300 us
+// au plus pour 4096 points)
+#define GENSIG_BUDGET_CYCLES 12000
+
+// Table d'chantillons et cadence associe. La boucle principale calcule
+// une table qui n'est pas envoye, l'interruption Timer3 la prend au vol
+// (GENSIG_Execute) avec sa priode. Forme, Amplitude, Offset et Longueur
+// identifient le contenu : une table dj calcule est reprise telle
+// quelle (seule la priode change avec la frquence).
+typedef struct {
+    uint16_t Echantillons[GENSIG_LONGUEUR_MAX];   // 0..VAL_MAX_PAS
+    uint16_t Longueur;          // nombre d'chantillons (puissance de 2)
+    uint16_t PeriodeTimer;      // valeur de PR3
+    uint32_t PeriodeCoreTimer;  // priode d'chantillonnage (core timer)
+    E_FormesSignal Forme;
+    int16_t Amplitude;
+    int16_t Offset;
+    int32_t Milieu;             // forme sans table (bruit, PRBS) : milieu
+    int32_t Gain;               // et gain Q14 (SIGNAL_CalculeEchelle)
+    uint32_t Utilisation;       // date de dernire utilisation, 0 : vide
+} S_TableSignal;
+
+// Compteurs des tables reprises et calcules (GENSIG_UpdateSignal)
+typedef struct {
+    uint32_t NbReprises;        // table trouve parmi les GENSIG_NB_TABLES
+    uint32_t NbCalculs;         // table calcule (la moins rcente remplace)
+} S_CacheTables;
+
+extern S_CacheTables cacheTables;
+
+// Dpendances de la cible (PIC32MX795 du kit ou PIC32MZ EF)
+//  GENSIG_HORLOGE_TIMER  horloge interne du Timer3 (sans prdiviseur) :
+//                        PBCLK sur MX (80 MHz), PBCLK3 sur MZ (100 MHz)
+//  GENSIG_TABLE_ATTR     placement de la table d'chantillons : sur MZ la
+//                        RAM est vue  travers le cache de donnes, la
+//                        table est place en mmoire non cache (KSEG1)
+//                        pour pouvoir tre lue par un DMA sans vidage du
+//                        cache. Le MX n'a pas de cache de donnes.
+#if defined(__PIC32MZ__)
+#define GENSIG_HORLOGE_TIMER SYS_CLK_BUS_PERIPHERAL_3
+#define GENSIG_TABLE_ATTR __attribute__((coherent, aligned(16)))
+#else
+#define GENSIG_HORLOGE_TIMER SYS_CLK_BUS_PERIPHERAL_1
+#define GENSIG_TABLE_ATTR
+#endif
+
 
 // Initialisation du  gnrateur
 void  GENSIG_Initialize(S_ParamGen *pParam);
 
-// Mise  jour de la periode d'chantillonage
-void  GENSIG_UpdatePeriode(S_ParamGen *pParam);
-
-// Mise  jour du signal (forme, amplitude, offset)
+// Mise  jour du signal (forme, frquence, amplitude, offset) : calcul de
+// la table libre et de sa priode, puis change au prochain chantillon.
+// Si la forme  bande limite n'est pas encore construite, la table
+// active reste en service et GENSIG_Tasks termine la mise  jour
 void  GENSIG_UpdateSignal(S_ParamGen *pParam);
 
+// Construction par tapes de la forme en attente (boucle principale, 
+// chaque tour), au plus GENSIG_BUDGET_CYCLES par appel. Retourne true si
+// une construction tait en cours
+bool GENSIG_Tasks(void);
+
 // Execution du gnrateur en envoient les valeurs calcules au dac
 void  GENSIG_Execute(void);
 
+// Priode d'chantillonnage courante en pas du core timer (SYS_CLK_FREQ / 2)
+uint32_t GENSIG_PeriodeCoreTimer(void);
+
+// Nombre d'chantillons de la table en cours d'envoi
+uint16_t GENSIG_LongueurActive(void);
+
+// Frquence d'chantillonnage maximale : GENSIG_FECH_MAX ou la cadence
+// des mises  jour du DAC  l'horloge SPI courante si elle est plus faible
+uint32_t GENSIG_FechMax(void);
+
+// Frquence maximale (Hz) : GENSIG_FechMax sur GENSIG_LONGUEUR_MIN points.
+// Toutes les formes descendent  GENSIG_LONGUEUR_MIN points et la cadence
+// du DAC ne dpend pas de la forme : la limite est la mme pour toutes
+int16_t GENSIG_FrequenceMax(void);
+
+// Choix de l'horloge du Timer3 : 0 pour PBCLK, sinon frquence (Hz) de
+// l'horloge externe sur T3CK. Refus (false) hors de
+// GENSIG_HORLOGE_EXT_MIN..MAX ou si la frquence en cours n'est plus
+// possible, sinon les tables sont recalcules pour la nouvelle horloge
+bool GENSIG_ChoisitHorlogeTimer(uint32_t frequenceExterne);
+// Horloge courante du Timer3 (Hz) et source
+uint32_t GENSIG_HorlogeTimer(void);
+bool GENSIG_HorlogeExterne(void);
+
+// Dclenchement : configuration de la capture IC1 (aprs l'init du
+// Timer3), traitement d'un front (interruption de capture, capture :
+// valeur de TMR3 au front) et nombre de fronts reus
+void GENSIG_InitDeclenchement(void);
+void GENSIG_Declenche(uint16_t capture);
+uint32_t GENSIG_NbDeclenchements(void);
+
+// Phase de la synchronisation en degrs (0 : dbut de priode, passage de
+// l'index par 0) et phase courante. Sans GENSIG_SYNC_ENABLE, la phase est
+// mmorise mais sans effet
+void GENSIG_ChoisitPhaseSync(uint16_t degres);
+uint16_t GENSIG_PhaseSync(void);
+
+// Changement de l'horloge SPI du DAC (Hz). Refus (false) si elle est
+// hors limites ou trop lente pour la frquence en cours, sinon les
+// tables sont recalcules pour la nouvelle cadence maximale
+bool GENSIG_ChoisitHorlogeSpi(uint32_t frequence);
+
 
 #endif
\ No newline at end of file
@@ -0,0 +1,22 @@
+// GesBruit.c
+// Bruit et squences pseudo-alatoires du gnrateur
+//
+// Les gnrateurs eux-mmes sont en inline dans GesBruit.h (appels depuis
+// l'interruption Timer3), seule l'initialisation est ici.
+//
+//---------------------------------------------------------------------------
+
+#include "GesBruit.h"
+
+void BRUIT_Init(S_Bruit *pBruit, uint32_t graine) {
+    uint8_t i;
+
+    // xorshift32 : l'tat 0 est un point fixe
+    pBruit->Blanc = (graine != 0) ? graine : 1;
+    pBruit->Lfsr = 1;
+    pBruit->Compteur = 0;
+    pBruit->Somme = 0;
+    for (i = 0; i < BRUIT_NB_RANGEES; i++) {
+        pBruit->Rangees[i] = 0;
+    }
+}
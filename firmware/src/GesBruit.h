@@ -0,0 +1,140 @@
+#ifndef GesBruit_h
+#define GesBruit_h
+
+// GesBruit.h
+// Bruit et squences pseudo-alatoires du gnrateur
+//
+// Principe : ces formes n'ont pas de table, l'interruption Timer3 calcule
+//            chaque chantillon (BRUIT_Suivant) en entiers, sans boucle :
+//            le cot par chantillon est born (quelques dizaines
+//            d'instructions au plus, bruit rose). Les valeurs sont au
+//            format des formes normalises (Q14, -SIGNAL_CRETE ..
+//            +SIGNAL_CRETE), l'amplitude et l'offset s'appliquent de la
+//            mme faon. Un chantillon par priode du Timer3 : la
+//            frquence choisie fixe la cadence (Frequence * longueur de
+//            table), donc la bande du bruit et le dbit des PRBS.
+//            Ce module n'utilise ni Harmony ni les registres du PIC32.
+//
+//  Formes :
+//       SignalBruitBlanc  xorshift32 (dcalages 13, 17, 5), priode
+//                         2^32 - 1, distribution uniforme
+//       SignalBruitRose   Voss-McCartney : BRUIT_NB_RANGEES valeurs
+//                         blanches, la range k renouvele tous les
+//                         2^(k+1) chantillons, plus une valeur blanche
+//                         par chantillon : pente de -3 dB par octave
+//       SignalPrbs7       x^7 + x^6 + 1, priode 127 bits
+//       SignalPrbs15      x^15 + x^14 + 1, priode 32767 bits
+//       SignalPrbs23      x^23 + x^18 + 1, priode 8388607 bits
+//                         (polynmes de l'ITU-T O.150), un bit par
+//                         chantillon : +crte pour 1, -crte pour 0
+//
+//  Fonctions  disposition :
+//       BRUIT_Init        initialisation des registres (graine non nulle)
+//       BRUIT_Suivant     chantillon suivant d'une forme (inline)
+//
+//---------------------------------------------------------------------------
+
+// *****************************************************************************
+// Section: Type Definitions
+// *****************************************************************************
+#include <stdint.h>
+#include "DefMenuGen.h"
+#include "GesSignal.h"
+
+// Nombre de ranges du bruit rose : la plus lente est renouvele tous les
+// 2^BRUIT_NB_RANGEES chantillons, la pente tient sur autant d'octaves
+#define BRUIT_NB_RANGEES 15
+// Ranges et valeur blanche (16 sources) divises par 16 : la somme ne
+// dpasse jamais la crte
+#define BRUIT_DECALAGE_ROSE 4
+
+// Etat des gnrateurs
+typedef struct {
+    uint32_t Blanc;         // registre xorshift32, jamais 0
+    uint32_t Lfsr;          // registre des PRBS, jamais 0
+    uint32_t Compteur;      // chantillons du bruit rose
+    int32_t Somme;          // somme des ranges du bruit rose
+    int16_t Rangees[BRUIT_NB_RANGEES];
+} S_Bruit;
+
+// Initialisation, graine du bruit blanc (0 remplac par 1)
+void BRUIT_Init(S_Bruit *pBruit, uint32_t graine);
+
+//----------------------------------------------------------------------------
+//  BRUIT_Blanc
+//  Pas du xorshift32, les 15 bits de poids fort signs : -16384..16383
+//----------------------------------------------------------------------------
+
+static inline int16_t BRUIT_Blanc(S_Bruit *pBruit) {
+    uint32_t x = pBruit->Blanc;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    pBruit->Blanc = x;
+    return (int16_t) ((int32_t) x >> 17);
+}
+
+//----------------------------------------------------------------------------
+//  BRUIT_Rose
+//  Une range renouvele par chantillon (celle du nombre de zros de
+//  poids faible du compteur), somme tenue  jour par diffrence
+//----------------------------------------------------------------------------
+
+static inline int16_t BRUIT_Rose(S_Bruit *pBruit) {
+    uint32_t compteur = ++pBruit->Compteur;
+    uint32_t rangee;
+    int16_t nouveau;
+
+    // Tous les 2^BRUIT_NB_RANGEES chantillons, aucune range
+    if ((compteur & ((1u << BRUIT_NB_RANGEES) - 1)) != 0) {
+        rangee = (uint32_t) __builtin_ctz(compteur);
+        nouveau = (int16_t) (BRUIT_Blanc(pBruit) >> BRUIT_DECALAGE_ROSE);
+        pBruit->Somme += nouveau - pBruit->Rangees[rangee];
+        pBruit->Rangees[rangee] = nouveau;
+    }
+    return (int16_t) (pBruit->Somme + (BRUIT_Blanc(pBruit) >> BRUIT_DECALAGE_ROSE));
+}
+
+//----------------------------------------------------------------------------
+//  BRUIT_Prbs
+//  LFSR de Fibonacci x^ordre + x^prise + 1. Le registre est commun aux
+//  trois squences : aprs un changement d'ordre il est masqu, et relanc
+//   1 s'il est devenu nul
+//----------------------------------------------------------------------------
+
+static inline int16_t BRUIT_Prbs(S_Bruit *pBruit, uint8_t ordre, uint8_t prise) {
+    uint32_t lfsr = pBruit->Lfsr & ((1u << ordre) - 1);
+    uint32_t bit;
+
+    if (lfsr == 0) {
+        lfsr = 1;
+    }
+    bit = ((lfsr >> (ordre - 1)) ^ (lfsr >> (prise - 1))) & 1;
+    pBruit->Lfsr = (lfsr << 1) | bit;
+    return bit ? SIGNAL_CRETE : -SIGNAL_CRETE;
+}
+
+//----------------------------------------------------------------------------
+//  BRUIT_Suivant
+//  Echantillon suivant de la forme (0 pour une forme  table)
+//----------------------------------------------------------------------------
+
+static inline int16_t BRUIT_Suivant(S_Bruit *pBruit, E_FormesSignal forme) {
+    switch (forme) {
+        case SignalBruitBlanc:
+            return BRUIT_Blanc(pBruit);
+        case SignalBruitRose:
+            return BRUIT_Rose(pBruit);
+        case SignalPrbs7:
+            return BRUIT_Prbs(pBruit, 7, 6);
+        case SignalPrbs15:
+            return BRUIT_Prbs(pBruit, 15, 14);
+        case SignalPrbs23:
+            return BRUIT_Prbs(pBruit, 23, 18);
+        default:
+            return 0;
+    }
+}
+
+#endif
@@ -0,0 +1,421 @@
+// GesConsole.c
+// Commandes du gnrateur sur la console (SYS_CMD, USB CDC)
+//
+// Chaque commande reoit argc / argv comme un main() et crit sa rponse
+// avec la fonction print de la console qui l'a appele. msg ne transmet
+// qu'un pointeur  la console USB (criture diffre) : il est rserv
+// aux textes constants, les lignes formates dans un tampon local passent
+// par print qui les recopie dans le tampon circulaire de SYS_CMD
+// (SYS_CMD_PRINT_BUFFER_SIZE).
+//
+// Les rponses de plusieurs lignes (prof, rapports de gigue, latence et
+// sched) peuvent dpasser ce tampon : elles ne sont pas crites par la
+// commande mais envoyes par CONSOLE_Tasks, une ligne par appel, comme le
+// vidage de GesTrace.
+//
+//---------------------------------------------------------------------------
+
+#include <stdlib.h>
+#include <string.h>
+#include "GesConsole.h"
+#include "GesMesure.h"
+#include "GesLatence.h"
+#include "GesSched.h"
+#include "GesLog.h"
+#include "GesEvent.h"
+#include "GesLcd.h"
+#include "MenuGen.h"
+#include "Generateur.h"
+#include "Mc32NVMUtil.h"
+#include "appgen.h"
+#include "GesTrace.h"
+#include "Mc32gestSpiDac.h"
+#include "system_definitions.h"
+
+// Longueur maximale d'une ligne de rponse
+#define CONSOLE_LONGUEUR_LIGNE 200
+// Longueur maximale d'un rapport de plusieurs lignes
+#define CONSOLE_LONGUEUR_RAPPORT 512
+
+// Envoi de "prof" par CONSOLE_Tasks : point en cours, ligne suivante
+// (statistiques ou histogramme du point)
+static bool profEnCours = false;
+static bool profAvecHisto = false;
+static bool profLigneHisto = false;
+static uint8_t profIndex;
+// Rapport format par une commande et dbut de sa ligne suivante 
+// envoyer (NULL : rien  envoyer)
+static char rapport[CONSOLE_LONGUEUR_RAPPORT];
+static const char *pRapport = NULL;
+
+static int CONSOLE_CmdProf(SYS_CMD_DEVICE_NODE *pCmdIO, int argc, char **argv);
+static int CONSOLE_CmdGigue(SYS_CMD_DEVICE_NODE *pCmdIO, int argc, char **argv);
+static int CONSOLE_CmdLatence(SYS_CMD_DEVICE_NODE *pCmdIO, int argc, char **argv);
+static int CONSOLE_CmdSched(SYS_CMD_DEVICE_NODE *pCmdIO, int argc, char **argv);
+static int CONSOLE_CmdIdle(SYS_CMD_DEVICE_NODE *pCmdIO, int argc, char **argv);
+static int CONSOLE_CmdParam(SYS_CMD_DEVICE_NODE *pCmdIO, int argc, char **argv);
+static int CONSOLE_CmdCompteurs(SYS_CMD_DEVICE_NODE *pCmdIO, int argc, char **argv);
+static int CONSOLE_CmdPile(SYS_CMD_DEVICE_NODE *pCmdIO, int argc, char **argv);
+static int CONSOLE_CmdNvm(SYS_CMD_DEVICE_NODE *pCmdIO, int argc, char **argv);
+static int CONSOLE_CmdLog(SYS_CMD_DEVICE_NODE *pCmdIO, int argc, char **argv);
+static int CONSOLE_CmdTrace(SYS_CMD_DEVICE_NODE *pCmdIO, int argc, char **argv);
+static int CONSOLE_CmdSpi(SYS_CMD_DEVICE_NODE *pCmdIO, int argc, char **argv);
+static int CONSOLE_CmdSync(SYS_CMD_DEVICE_NODE *pCmdIO, int argc, char **argv);
+static int CONSOLE_CmdHorloge(SYS_CMD_DEVICE_NODE *pCmdIO, int argc, char **argv);
+static void CONSOLE_AfficheRapport(void);
+
+// Table des commandes du groupe "gen"
+static const SYS_CMD_DESCRIPTOR tableCommandes[] = {
+    {"prof", CONSOLE_CmdProf, ": temps des interruptions et des taches (prof [histo|raz])"},
+    {"gigue", CONSOLE_CmdGigue, ": retard et gigue des echantillons du generateur"},
+    {"latence", CONSOLE_CmdLatence, ": debit et latence des commandes TCP (latence [raz])"},
+    {"sched", CONSOLE_CmdSched, ": utilisation des taches et temps inactif (sched [raz])"},
+    {"idle", CONSOLE_CmdIdle, ": mise en Idle du CPU dans les tours inactifs (idle on|off)"},
+    {"param", CONSOLE_CmdParam, ": parametres du generateur"},
+    {"compteurs", CONSOLE_CmdCompteurs, ": pertes et erreurs"},
+    {"pile", CONSOLE_CmdPile, ": utilisation de la pile"},
+    {"nvm", CONSOLE_CmdNvm, ": parametres sauves en flash"},
+    {"log", CONSOLE_CmdLog, ": niveau du journal (log [0..4])"},
+    {"trace", CONSOLE_CmdTrace, ": trace des evenements (trace [dump|raz|masque <hex>])"},
+    {"spi", CONSOLE_CmdSpi, ": horloge SPI du DAC et cadence maximale (spi [Hz])"},
+    {"sync", CONSOLE_CmdSync, ": phase de la sortie de synchronisation (sync [degres])"},
+    {"horloge", CONSOLE_CmdHorloge, ": horloge du Timer3 et declenchement (horloge [int|Hz])"},
+};
+
+bool CONSOLE_Init(void) {
+    return SYS_CMD_ADDGRP(tableCommandes,
+            sizeof (tableCommandes) / sizeof (tableCommandes[0]),
+            "gen", ": commandes du generateur");
+}
+
+//----------------------------------------------------------------------------
+//  CONSOLE_CmdProf
+//  Ecrit l'en-tte et lance l'envoi d'une ligne par point de mesure, et de
+//  son histogramme si demand (CONSOLE_Tasks)
+//----------------------------------------------------------------------------
+
+static int CONSOLE_CmdProf(SYS_CMD_DEVICE_NODE *pCmdIO, int argc, char **argv) {
+    const void *cmdIoParam = pCmdIO->cmdIoParam;
+    bool avecHisto = false;
+
+    if (argc > 1) {
+        if (strcmp(argv[1], "raz") == 0) {
+            MESURE_RazTout();
+            (*pCmdIO->pCmdApi->msg)(cmdIoParam, "statistiques remises a zero\r\n");
+            return 0;
+        }
+        avecHisto = (strcmp(argv[1], "histo") == 0);
+    }
+
+#ifndef MESURE_ENABLE
+    (*pCmdIO->pCmdApi->msg)(cmdIoParam, "instrumentation desactivee (MESURE_ENABLE)\r\n");
+#endif
+    (*pCmdIO->pCmdApi->msg)(cmdIoParam, "point    nb min moy max [ns]\r\n");
+    profIndex = 0;
+    profAvecHisto = avecHisto;
+    profLigneHisto = false;
+    profEnCours = true;
+    return 0;
+}
+
+//----------------------------------------------------------------------------
+//  CONSOLE_CmdGigue
+//  Rapport de gigue du gnrateur (mme texte que la requte TCP ?JIT#)
+//----------------------------------------------------------------------------
+
+static int CONSOLE_CmdGigue(SYS_CMD_DEVICE_NODE *pCmdIO, int argc, char **argv) {
+    MESURE_FormatGigue(rapport, sizeof (rapport));
+    CONSOLE_AfficheRapport();
+    return 0;
+}
+
+//----------------------------------------------------------------------------
+//  CONSOLE_CmdLatence
+//  Dbit et latence des commandes TCP (mme texte que la requte ?LAT#)
+//----------------------------------------------------------------------------
+
+static int CONSOLE_CmdLatence(SYS_CMD_DEVICE_NODE *pCmdIO, int argc, char **argv) {
+    if ((argc > 1) && (strcmp(argv[1], "raz") == 0)) {
+        LATENCE_Raz();
+        (*pCmdIO->pCmdApi->msg)(pCmdIO->cmdIoParam, "latences remises a zero\r\n");
+        return 0;
+    }
+    LATENCE_Format(rapport, sizeof (rapport));
+    CONSOLE_AfficheRapport();
+    return 0;
+}
+
+//----------------------------------------------------------------------------
+//  CONSOLE_CmdSched
+//  Statistiques de l'ordonnanceur de APPGEN
+//----------------------------------------------------------------------------
+
+static int CONSOLE_CmdSched(SYS_CMD_DEVICE_NODE *pCmdIO, int argc, char **argv) {
+    if ((argc > 1) && (strcmp(argv[1], "raz") == 0)) {
+        SCHED_Raz();
+        (*pCmdIO->pCmdApi->msg)(pCmdIO->cmdIoParam, "ordonnanceur remis a zero\r\n");
+        return 0;
+    }
+    SCHED_Format(rapport, sizeof (rapport));
+    CONSOLE_AfficheRapport();
+    return 0;
+}
+
+//----------------------------------------------------------------------------
+//  CONSOLE_CmdIdle
+//  Mise en Idle du CPU, les statistiques sont remises  zro pour comparer
+//  les deux modes sur des fentres propres
+//----------------------------------------------------------------------------
+
+static int CONSOLE_CmdIdle(SYS_CMD_DEVICE_NODE *pCmdIO, int argc, char **argv) {
+    if (argc < 2) {
+        (*pCmdIO->pCmdApi->msg)(pCmdIO->cmdIoParam, "usage : idle on|off\r\n");
+        return 0;
+    }
+#ifdef SCHED_ATTENTE_ENABLE
+    SCHED_AttenteActive(strcmp(argv[1], "on") == 0);
+    SCHED_Raz();
+    MESURE_RazTout();
+    (*pCmdIO->pCmdApi->msg)(pCmdIO->cmdIoParam, "statistiques remises a zero\r\n");
+#else
+    (*pCmdIO->pCmdApi->msg)(pCmdIO->cmdIoParam, "mise en Idle desactivee (SCHED_ATTENTE_ENABLE)\r\n");
+#endif
+    return 0;
+}
+
+//----------------------------------------------------------------------------
+//  CONSOLE_AfficheParam
+//  Une ligne de paramtres du gnrateur
+//----------------------------------------------------------------------------
+
+static void CONSOLE_AfficheParam(SYS_CMD_DEVICE_NODE *pCmdIO, const char *pNom,
+        const S_ParamGen *pParam) {
+    const char *pForme = "?";
+
+    if ((uint32_t) pParam->Forme < (sizeof (MenuFormes) / sizeof (MenuFormes[0]))) {
+        pForme = MenuFormes[pParam->Forme];
+    }
+    (*pCmdIO->pCmdApi->print)(pCmdIO->cmdIoParam,
+            "%-7s %s F=%d Hz A=%d mV O=%d mV\r\n", pNom, pForme,
+            pParam->Frequence, pParam->Amplitude, pParam->Offset);
+}
+
+static int CONSOLE_CmdParam(SYS_CMD_DEVICE_NODE *pCmdIO, int argc, char **argv) {
+    CONSOLE_AfficheParam(pCmdIO, "local", &LocalParamGen);
+    CONSOLE_AfficheParam(pCmdIO, "remote", &RemoteParamGen);
+    (*pCmdIO->pCmdApi->print)(pCmdIO->cmdIoParam, "table   %u points, %lu ns/echantillon\r\n",
+            (unsigned) GENSIG_LongueurActive(),
+            (unsigned long) MESURE_EnNs(GENSIG_PeriodeCoreTimer()));
+    (*pCmdIO->pCmdApi->print)(pCmdIO->cmdIoParam, "tables  %u en memoire, %lu reprises, %lu calculs\r\n",
+            (unsigned) GENSIG_NB_TABLES, (unsigned long) cacheTables.NbReprises,
+            (unsigned long) cacheTables.NbCalculs);
+    (*pCmdIO->pCmdApi->msg)(pCmdIO->cmdIoParam, appRJ45Status.rj45Stat ?
+            "mode remote (TCP)\r\n" : "mode local (PEC12)\r\n");
+    return 0;
+}
+
+//----------------------------------------------------------------------------
+//  CONSOLE_CmdCompteurs
+//  Compteurs de pertes et d'erreurs des diffrents modules
+//----------------------------------------------------------------------------
+
+static int CONSOLE_CmdCompteurs(SYS_CMD_DEVICE_NODE *pCmdIO, int argc, char **argv) {
+    const void *cmdIoParam = pCmdIO->cmdIoParam;
+
+    (*pCmdIO->pCmdApi->print)(cmdIoParam, "evenements perdus   %u\r\n",
+            (unsigned) EventQueue.NbPerdus);
+    (*pCmdIO->pCmdApi->print)(cmdIoParam, "echantillons perdus %u retard max %u ms\r\n",
+            (unsigned) EventQueue.NbEchPerdus, (unsigned) EventQueue.RemplissageEch);
+    (*pCmdIO->pCmdApi->print)(cmdIoParam, "lcd perdus %u remplissage max %u redessins %u\r\n",
+            (unsigned) LcdQueue.NbPerdus, (unsigned) LcdQueue.Remplissage,
+            (unsigned) LcdQueue.NbRedessins);
+    (*pCmdIO->pCmdApi->print)(cmdIoParam, "t3 en retard %lu sautes %lu\r\n",
+            (unsigned long) retardsT3.NbRetards, (unsigned long) retardsT3.NbManques);
+    (*pCmdIO->pCmdApi->print)(cmdIoParam, "trames rejetees %lu\r\n",
+            (unsigned long) latenceCommandes.NbRejetees);
+    (*pCmdIO->pCmdApi->print)(cmdIoParam, "journal refuses %lu\r\n",
+            (unsigned long) LOG_NbPerdus());
+    return 0;
+}
+
+static int CONSOLE_CmdPile(SYS_CMD_DEVICE_NODE *pCmdIO, int argc, char **argv) {
+    uint32_t taille = MESURE_PileTaille();
+    uint32_t libre = MESURE_PileLibre();
+
+    (*pCmdIO->pCmdApi->print)(pCmdIO->cmdIoParam,
+            "pile %lu octets, max utilise %lu, jamais utilise %lu\r\n",
+            (unsigned long) taille, (unsigned long) (taille - libre),
+            (unsigned long) libre);
+    return 0;
+}
+
+//----------------------------------------------------------------------------
+//  CONSOLE_CmdNvm
+//  Relit le bloc sauv en flash et vrifie sa signature (MAGIC)
+//----------------------------------------------------------------------------
+
+static int CONSOLE_CmdNvm(SYS_CMD_DEVICE_NODE *pCmdIO, int argc, char **argv) {
+    S_ParamGen sauvegarde;
+
+    NVM_ReadBlock((uint32_t*) &sauvegarde, sizeof (S_ParamGen));
+    (*pCmdIO->pCmdApi->print)(pCmdIO->cmdIoParam, "page 0x%08lx magic 0x%08lx %s\r\n",
+            (unsigned long) NVM_PROGRAM_PAGE, (unsigned long) sauvegarde.Magic,
+            (sauvegarde.Magic == MAGIC) ? "valide" : "invalide (valeurs par defaut)");
+    if (sauvegarde.Magic == MAGIC) {
+        CONSOLE_AfficheParam(pCmdIO, "sauve", &sauvegarde);
+    }
+    return 0;
+}
+
+static int CONSOLE_CmdLog(SYS_CMD_DEVICE_NODE *pCmdIO, int argc, char **argv) {
+    if (argc > 1) {
+        LOG_ChangeNiveau((E_LogNiveau) atoi(argv[1]));
+    }
+    (*pCmdIO->pCmdApi->print)(pCmdIO->cmdIoParam, "journal niveau %d, %lu refuses\r\n",
+            (int) LOG_Niveau(), (unsigned long) LOG_NbPerdus());
+    return 0;
+}
+
+//----------------------------------------------------------------------------
+//  CONSOLE_CmdTrace
+//  Etat, vidage et masque de la trace. Le vidage lui-mme est fait par la
+//  tche TRACE_Tasks, une ligne  la fois.
+//----------------------------------------------------------------------------
+
+static int CONSOLE_CmdTrace(SYS_CMD_DEVICE_NODE *pCmdIO, int argc, char **argv) {
+    if (argc > 1) {
+        if (strcmp(argv[1], "dump") == 0) {
+            TRACE_Vide();
+            return 0;
+        }
+        if (strcmp(argv[1], "raz") == 0) {
+            TRACE_Raz();
+        } else if ((strcmp(argv[1], "masque") == 0) && (argc > 2)) {
+            TRACE_Masque(strtoul(argv[2], NULL, 16));
+        }
+    }
+#ifdef TRACE_ENABLE
+    (*pCmdIO->pCmdApi->print)(pCmdIO->cmdIoParam,
+            "trace %lu evenements, masque 0x%08lx, cout %lu ns/evenement\r\n",
+            (unsigned long) Trace.Nb, (unsigned long) Trace.Masque,
+            (unsigned long) MESURE_EnNs(Trace.Cout));
+#else
+    (*pCmdIO->pCmdApi->msg)(pCmdIO->cmdIoParam, "trace desactivee (TRACE_ENABLE)\r\n");
+#endif
+    return 0;
+}
+
+//----------------------------------------------------------------------------
+//  CONSOLE_CmdSpi
+//  Horloge SPI du DAC, dure d'une mise  jour et limites qui en dcoulent.
+//  Une nouvelle horloge trop lente pour la frquence en cours est refuse.
+//----------------------------------------------------------------------------
+
+static int CONSOLE_CmdSpi(SYS_CMD_DEVICE_NODE *pCmdIO, int argc, char **argv) {
+    uint32_t sck;
+
+    if ((argc > 1) && !GENSIG_ChoisitHorlogeSpi(strtoul(argv[1], NULL, 10))) {
+        (*pCmdIO->pCmdApi->msg)(pCmdIO->cmdIoParam,
+                "refuse : hors limites ou trop lent pour la frequence en cours\r\n");
+    }
+    sck = SPI_FrequenceDac();
+    (*pCmdIO->pCmdApi->print)(pCmdIO->cmdIoParam,
+            "sck %lu Hz, %u canaux %u trames, mise a jour %lu ns, fech max %lu S/s, f max %d Hz\r\n",
+            (unsigned long) sck, (unsigned) GENSIG_NB_CANAUX,
+            (unsigned) DAC_MOTS_PAR_MAJ(GENSIG_NB_CANAUX),
+            (unsigned long) DAC_TempsMotsNs(sck, DAC_MOTS_PAR_MAJ(GENSIG_NB_CANAUX)),
+            (unsigned long) GENSIG_FechMax(), (int) GENSIG_FrequenceMax());
+    return 0;
+}
+
+static int CONSOLE_CmdSync(SYS_CMD_DEVICE_NODE *pCmdIO, int argc, char **argv) {
+    if (argc > 1) {
+        GENSIG_ChoisitPhaseSync((uint16_t) strtoul(argv[1], NULL, 10));
+    }
+#ifdef GENSIG_SYNC_ENABLE
+    (*pCmdIO->pCmdApi->print)(pCmdIO->cmdIoParam, "sync phase %u degres\r\n",
+            (unsigned) GENSIG_PhaseSync());
+#else
+    (*pCmdIO->pCmdApi->msg)(pCmdIO->cmdIoParam, "sync desactivee (GENSIG_SYNC_ENABLE)\r\n");
+#endif
+    return 0;
+}
+
+//----------------------------------------------------------------------------
+//  CONSOLE_CmdHorloge
+//  Source de l'horloge d'chantillonnage : "int" pour PBCLK, sinon
+//  frquence de l'horloge externe sur T3CK
+//----------------------------------------------------------------------------
+
+static int CONSOLE_CmdHorloge(SYS_CMD_DEVICE_NODE *pCmdIO, int argc, char **argv) {
+    uint32_t frequence;
+
+    if (argc > 1) {
+        frequence = (strcmp(argv[1], "int") == 0) ? 0 : strtoul(argv[1], NULL, 10);
+        if (!GENSIG_ChoisitHorlogeTimer(frequence)) {
+            (*pCmdIO->pCmdApi->msg)(pCmdIO->cmdIoParam,
+                    "refuse : hors limites ou trop lent pour la frequence en cours\r\n");
+        }
+    }
+    (*pCmdIO->pCmdApi->print)(pCmdIO->cmdIoParam,
+            "horloge %s %lu Hz, fech max %lu S/s, %lu declenchements\r\n",
+            GENSIG_HorlogeExterne() ? "externe" : "interne",
+            (unsigned long) GENSIG_HorlogeTimer(), (unsigned long) GENSIG_FechMax(),
+            (unsigned long) GENSIG_NbDeclenchements());
+    return 0;
+}
+
+//----------------------------------------------------------------------------
+//  CONSOLE_Tasks
+//  Envoie la ligne suivante du rapport en cours, sinon de "prof" :
+//  statistiques d'un point, puis son histogramme au passage suivant (s'il
+//  est demand et non vide)
+//----------------------------------------------------------------------------
+
+bool CONSOLE_Tasks(void) {
+    char ligne[CONSOLE_LONGUEUR_LIGNE];
+    const char *pFin;
+
+    if (pRapport != NULL) {
+        pFin = strchr(pRapport, '\n');
+        if (pFin == NULL) {
+            pFin = pRapport + strlen(pRapport) - 1;
+        }
+        SYS_CONSOLE_PRINT("%.*s", (int) (pFin - pRapport + 1), pRapport);
+        pRapport = (pFin[1] != '\0') ? (pFin + 1) : NULL;
+        return true;
+    }
+
+    if (!profEnCours) {
+        return false;
+    }
+    if (profIndex >= MESURE_NbPoints()) {
+        profEnCours = false;
+        return false;
+    }
+
+    if (!profLigneHisto) {
+        MESURE_FormatPoint(profIndex, ligne, sizeof (ligne));
+        SYS_CONSOLE_PRINT("%s", ligne);
+        profLigneHisto = profAvecHisto;
+    } else {
+        if (MESURE_FormatHisto(profIndex, ligne, sizeof (ligne)) > 0) {
+            SYS_CONSOLE_PRINT("        %s\r\n", ligne);
+        }
+        profLigneHisto = false;
+    }
+    if (!profLigneHisto) {
+        profIndex++;
+    }
+    return true;
+}
+
+//----------------------------------------------------------------------------
+//  CONSOLE_AfficheRapport
+//  Lance l'envoi du rapport format dans rapport, une ligne par appel de
+//  CONSOLE_Tasks (un rapport prcdent pas encore envoy est abandonn)
+//----------------------------------------------------------------------------
+
+static void CONSOLE_AfficheRapport(void) {
+    pRapport = (rapport[0] != '\0') ? rapport : NULL;
+}
@@ -0,0 +1,69 @@
+#ifndef GesConsole_h
+#define GesConsole_h
+
+// GesConsole.h
+// Commandes du gnrateur sur la console (SYS_CMD, USB CDC)
+//
+// Principe : les commandes sont regroupes dans le groupe "gen" du
+//            service SYS_CMD de Harmony ; elles s'excutent dans
+//            SYS_CMD_Tasks (boucle principale). Taper "help" sur la
+//            console pour la liste. Les rponses de plusieurs lignes
+//            (prof, gigue, latence, sched) sont envoyes ensuite par la
+//            tche CONSOLE_Tasks, une ligne par appel, pour ne pas
+//            dborder le tampon d'impression de SYS_CMD.
+//
+//  Commandes  disposition :
+//       prof              statistiques des interruptions et des tches
+//                         (nb, min, moy, max en ns)
+//       prof histo        idem avec les histogrammes
+//       prof raz          remise  zro des statistiques
+//       gigue             retard des chantillons du gnrateur sur leur
+//                         chance, gigue, chantillons en retard / sauts
+//       latence           dbit des trames TCP et latence commande -> DAC
+//       latence raz       remise  zro des statistiques de latence
+//       sched             utilisation, dpassements de budget et chances
+//                         manques des tches de APPGEN, temps inactif
+//       sched raz         remise  zro des statistiques de l'ordonnanceur
+//       idle on|off       autorise / interdit la mise en Idle du CPU dans
+//                         les tours inactifs (comparer "gigue" dans les
+//                         deux cas : retard_t3 / ret_idle)
+//       param             paramtres local / remote et mode actif
+//       compteurs         pertes des files, chantillons en retard, trames
+//                         rejetes, messages du journal refuss
+//       pile              taille de la pile et maximum utilis
+//       nvm               contenu et validit du bloc sauv en flash
+//       log [niveau]      niveau du journal (0 aucun, 1 erreur,
+//                         2 attention, 3 info, 4 debug)
+//       trace             tat de la trace (nombre, masque, cot)
+//       trace dump        envoi de la trace (format dans GesTrace.h)
+//       trace raz         vidage de la trace
+//       trace masque <hex>  id enregistrs (bit n : id n)
+//       spi [Hz]          horloge SPI du DAC, canaux et trames SPI par
+//                         chantillon, dure d'une mise  jour,
+//                         frquences d'chantillonnage et de signal
+//                         maximales ; avec Hz, change l'horloge (refus
+//                         si trop lente pour la frquence en cours)
+//       sync [degres]     phase de la sortie de synchronisation
+//                         (GENSIG_SYNC_W), 0 : dbut de priode
+//       horloge [int|Hz]  horloge d'chantillonnage : interne (PBCLK) ou
+//                         externe sur T3CK  la frquence donne, nombre
+//                         de fronts de dclenchement reus (IC1)
+//
+//  Fonctions  disposition :
+//       CONSOLE_Init      enregistrement des commandes auprs de SYS_CMD
+//       CONSOLE_Tasks     envoi par lignes (tche de l'ordonnanceur)
+//
+//---------------------------------------------------------------------------
+
+// *****************************************************************************
+// Section: Type Definitions
+// *****************************************************************************
+#include <stdbool.h>
+
+// Enregistrement des commandes, false si SYS_CMD refuse le groupe
+bool CONSOLE_Init(void);
+
+// Envoi d'une ligne de rponse en attente, true si une ligne est partie
+bool CONSOLE_Tasks(void);
+
+#endif
@@ -0,0 +1,51 @@
+// GesDac.c
+// Modle de temps des mises  jour du DAC LTC2604
+//
+// Arrondis du ct sr : SCK arrondie vers le bas (BRG vers le haut),
+// dure d'une trame arrondie vers le haut. Une cadence annonce possible
+// l'est donc toujours sur la cible.
+//
+//---------------------------------------------------------------------------
+
+#include "GesDac.h"
+
+//----------------------------------------------------------------------------
+//  DAC_SckPossible
+//  Diviseur 2 * (BRG + 1) arrondi vers le haut
+//----------------------------------------------------------------------------
+
+uint32_t DAC_SckPossible(uint32_t horlogeBus, uint32_t frequence) {
+    uint32_t diviseur;
+
+    if ((frequence < DAC_FREQ_SPI_MIN) || (frequence > DAC_FREQ_SPI_MAX)) {
+        return 0;
+    }
+    // diviseur = BRG + 1
+    diviseur = (horlogeBus + (2 * frequence) - 1) / (2 * frequence);
+    if (diviseur == 0) {
+        diviseur = 1;
+    }
+    return horlogeBus / (2 * diviseur);
+}
+
+//----------------------------------------------------------------------------
+//  DAC_TempsMotsNs
+//  Dcalage des DAC_BITS_PAR_MOT bits plus DAC_TEMPS_CS_NS par mot
+//----------------------------------------------------------------------------
+
+uint32_t DAC_TempsMotsNs(uint32_t sck, uint8_t nbMots) {
+    uint32_t decalage;
+
+    if (sck == 0) {
+        return UINT32_MAX;
+    }
+    decalage = (uint32_t) ((((uint64_t) DAC_BITS_PAR_MOT * 1000000000u) + sck - 1) / sck);
+    return nbMots * (decalage + DAC_TEMPS_CS_NS);
+}
+
+uint32_t DAC_FechMax(uint32_t sck, uint8_t nbCanaux) {
+    if (sck == 0) {
+        return 0;
+    }
+    return 1000000000u / DAC_TempsMotsNs(sck, DAC_MOTS_PAR_MAJ(nbCanaux));
+}
@@ -0,0 +1,58 @@
+#ifndef GesDac_h
+#define GesDac_h
+
+// GesDac.h
+// Modle de temps des mises  jour du DAC LTC2604
+//
+// Principe : la cadence maximale du gnrateur dpend de l'horloge SPI
+//            rellement obtenue (diviseur du SPI) et du nombre de trames
+//            par chantillon. Ces calculs ne dpendent que de leurs
+//            paramtres (horloge du bus du SPI, nombre de canaux) : ce
+//            module n'utilise ni Harmony ni les registres du PIC32, il se
+//            compile tel quel sur PC pour vrifier les limites des deux
+//            cibles (MX : PBCLK 80 MHz, MZ : PBCLK2 100 MHz).
+//            Mc32gestSPiDac fournit l'horloge du bus de la cible.
+//
+//  Fonctions  disposition :
+//       DAC_SckPossible   SCK obtenue pour une demande et une horloge de bus
+//       DAC_TempsMotsNs   dure minimale de nbMots trames  une SCK
+//       DAC_FechMax       cadence maximale des mises  jour de nbCanaux
+//                         canaux  une SCK (limite du DAC seul)
+//
+//---------------------------------------------------------------------------
+
+// *****************************************************************************
+// Section: Type Definitions
+// *****************************************************************************
+#include <stdint.h>
+
+// Canaux du LTC2604
+#define DAC_NB_CANAUX 4
+// Trames par mise  jour de nbCanaux canaux : une seule (criture et mise
+//  jour) pour un canal, une par canal plus la mise  jour au-del
+#define DAC_MOTS_PAR_MAJ(nbCanaux) (((nbCanaux) > 1) ? ((nbCanaux) + 1) : 1)
+
+// Horloge SPI (SCK) admise : le LTC2604 accepte jusqu' 50 MHz, en
+// dessous de 1 MHz une mise  jour dpasse 32 us
+#define DAC_FREQ_SPI_MIN 1000000
+#define DAC_FREQ_SPI_MAX 50000000
+// Bits par mise  jour d'un canal (mode 32 bits)
+#define DAC_BITS_PAR_MOT 32
+// Temps hors dcalage par mot : CS haut (LTC2604 : 10 ns min), remonte
+// de CS et dpt du mot suivant, avec marge
+#define DAC_TEMPS_CS_NS 100
+
+// SCK obtenue (Hz) pour une demande avec un SPI cadenc  horlogeBus :
+// SCK = horlogeBus / (2 * (BRG + 1)), jamais au-dessus de la demande.
+// 0 si la demande est hors de DAC_FREQ_SPI_MIN..DAC_FREQ_SPI_MAX
+uint32_t DAC_SckPossible(uint32_t horlogeBus, uint32_t frequence);
+
+// Dure minimale (ns) de nbMots trames  l'horloge sck, UINT32_MAX si
+// sck est nulle
+uint32_t DAC_TempsMotsNs(uint32_t sck, uint8_t nbMots);
+
+// Mises  jour par seconde de nbCanaux canaux (DAC_MOTS_PAR_MAJ trames
+// chacune)  l'horloge sck, 0 si sck est nulle
+uint32_t DAC_FechMax(uint32_t sck, uint8_t nbCanaux);
+
+#endif
@@ -0,0 +1,154 @@
+// GesEvent.c
+// File d'vnements des entres (PEC12 et S9)
+//
+// File circulaire  un producteur et un consommateur. Une case reste
+// toujours libre pour distinguer file pleine et file vide. L'vnement
+// est crit avant la publication de l'index d'criture, le consommateur
+// ne voit donc jamais un vnement incomplet.
+//
+//---------------------------------------------------------------------------
+
+#include "GesEvent.h"
+
+#define EVT_MASQUE (EVT_TAILLE - 1)
+#define EVT_MASQUE_ECH (EVT_TAILLE_ECH - 1)
+
+// File des vnements d'entre
+S_EventQueue EventQueue;
+
+// Horloge ms (interruption Timer1)
+static volatile uint32_t evtTick = 0;
+// Date de l'chantillon en cours de traitement, horodatage des vnements
+static uint32_t evtDateEch = 0;
+
+void EVT_Init(void) {
+    EventQueue.IndexEcriture = 0;
+    EventQueue.IndexLecture = 0;
+    EventQueue.NbPerdus = 0;
+    EventQueue.IndexEcritureEch = 0;
+    EventQueue.IndexLectureEch = 0;
+    EventQueue.NbEchPerdus = 0;
+    EventQueue.RemplissageEch = 0;
+}
+
+void EVT_Tick(void) {
+    evtTick++;
+}
+
+uint32_t EVT_GetTick(void) {
+    return evtTick;
+}
+
+//----------------------------------------------------------------------------
+//  EVT_Push
+//  Dpt d'un vnement horodat (ct producteur)
+//----------------------------------------------------------------------------
+
+bool EVT_Push(E_EventType type) {
+    uint8_t ecriture = EventQueue.IndexEcriture;
+    uint8_t suivant = (ecriture + 1) & EVT_MASQUE;
+
+    // File pleine : l'vnement est perdu
+    if (suivant == EventQueue.IndexLecture) {
+        EventQueue.NbPerdus++;
+        return false;
+    }
+
+    EventQueue.Evenements[ecriture].Type = type;
+    EventQueue.Evenements[ecriture].Timestamp = evtDateEch;
+    // Publication de l'vnement complet
+    __asm__ __volatile__("" ::: "memory");
+    EventQueue.IndexEcriture = suivant;
+    return true;
+}
+
+//----------------------------------------------------------------------------
+//  EVT_Peek
+//  Lecture du prochain vnement sans le retirer (ct consommateur)
+//----------------------------------------------------------------------------
+
+bool EVT_Peek(S_Event *pEvt) {
+    uint8_t lecture = EventQueue.IndexLecture;
+
+    if (lecture == EventQueue.IndexEcriture) {
+        return false;
+    }
+    __asm__ __volatile__("" ::: "memory");
+    *pEvt = EventQueue.Evenements[lecture];
+    return true;
+}
+
+//----------------------------------------------------------------------------
+//  EVT_Pop
+//  Retrait du prochain vnement (ct consommateur)
+//----------------------------------------------------------------------------
+
+bool EVT_Pop(S_Event *pEvt) {
+    if (!EVT_Peek(pEvt)) {
+        return false;
+    }
+    __asm__ __volatile__("" ::: "memory");
+    EventQueue.IndexLecture = (EventQueue.IndexLecture + 1) & EVT_MASQUE;
+    return true;
+}
+
+void EVT_Vide(void) {
+    EventQueue.IndexLecture = EventQueue.IndexEcriture;
+}
+
+//----------------------------------------------------------------------------
+//  EVT_DeposeEchantillon
+//  Dpt d'un chantillon brut des entres (ct interruption Timer1)
+//----------------------------------------------------------------------------
+
+void EVT_DeposeEchantillon(uint8_t entrees) {
+    uint8_t ecriture = EventQueue.IndexEcritureEch;
+    uint8_t suivant = (ecriture + 1) & EVT_MASQUE_ECH;
+
+    if (suivant == EventQueue.IndexLectureEch) {
+        EventQueue.NbEchPerdus++;
+        return;
+    }
+    EventQueue.Echantillons[ecriture] = entrees;
+    __asm__ __volatile__("" ::: "memory");
+    EventQueue.IndexEcritureEch = suivant;
+}
+
+//----------------------------------------------------------------------------
+//  EVT_RetireEchantillon
+//  Retrait du prochain chantillon brut (ct boucle principale)
+//  La date de l'chantillon est dduite de l'horloge ms : le dernier
+//  chantillon dpos porte la date evtTick, les prcdents une ms de
+//  moins chacun. L'horloge et l'index d'criture sont relus ensemble
+//  (l'interruption modifie les deux).
+//----------------------------------------------------------------------------
+
+bool EVT_RetireEchantillon(uint8_t *pEntrees) {
+    uint8_t lecture = EventQueue.IndexLectureEch;
+    uint8_t ecriture;
+    uint8_t enAttente;
+    uint32_t tick;
+
+    do {
+        tick = evtTick;
+        ecriture = EventQueue.IndexEcritureEch;
+    } while (tick != evtTick);
+
+    if (lecture == ecriture) {
+        return false;
+    }
+    enAttente = (ecriture - lecture) & EVT_MASQUE_ECH;
+    if (enAttente > EventQueue.RemplissageEch) {
+        EventQueue.RemplissageEch = enAttente;
+    }
+    evtDateEch = tick - (enAttente - 1);
+    __asm__ __volatile__("" ::: "memory");
+    *pEntrees = EventQueue.Echantillons[lecture];
+    __asm__ __volatile__("" ::: "memory");
+    EventQueue.IndexLectureEch = (lecture + 1) & EVT_MASQUE_ECH;
+    return true;
+}
+
+bool EVT_EchantillonEnAttente(void) {
+    return (EventQueue.IndexLectureEch != EventQueue.IndexEcritureEch);
+}
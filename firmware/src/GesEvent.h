@@ -0,0 +1,112 @@
+#ifndef GesEvent_h
+#define GesEvent_h
+
+// GesEvent.h
+// File d'vnements des entres (PEC12 et S9)
+//
+// Principe : ScanPec12 et ScanS9 (producteur unique, traitement des ticks
+//            1 ms) dposent chaque vnement dans une file circulaire avec
+//            son horodatage en ms. Le menu (consommateur unique, boucle
+//            principale) les retire un par un : un cran de l'encodeur
+//            n'est plus perdu si deux crans arrivent entre deux passages
+//            du menu.
+//
+//            La file est sans verrou : seul le producteur crit
+//            IndexEcriture, seul le consommateur crit IndexLecture.
+//
+//  Fonctions  disposition :
+//       EVT_Init          initialisation de la file
+//       EVT_Tick          avance de l'horloge ms (interruption Timer1)
+//       EVT_GetTick       lecture de l'horloge ms
+//       EVT_Push          dpt d'un vnement (producteur)
+//       EVT_Peek          lecture sans retrait du prochain vnement
+//       EVT_Pop           retrait du prochain vnement (consommateur)
+//       EVT_Vide          abandon des vnements en attente (consommateur)
+//       EVT_EchantillonEnAttente  tick 1 ms pas encore trait
+//
+// La file contient aussi les chantillons bruts des entres : l'interruption
+// Timer1 avance l'horloge ms, lit les entres et les dpose
+// (EVT_DeposeEchantillon), l'anti-rebond et le reste du traitement se font
+// dans la boucle principale (EVT_RetireEchantillon). L'horloge ms avance
+// donc mme quand la boucle principale est bloque ; les vnements sont
+// horodats  la date de leur chantillon et non  celle du traitement.
+//
+// La file des chantillons couvre EVT_TAILLE_ECH ms de blocage de la
+// boucle principale. Le plus long blocage restant est l'effacement d'une
+// page NVM lors de la sauvegarde (20 ms typique, datasheet PIC32MX) : les
+// formes  bande limite sont construites par tapes (GENSIG_Tasks).
+// RemplissageEch mmorise le retard maximum observ (commande console
+// "compteurs").
+//
+//---------------------------------------------------------------------------
+
+// *****************************************************************************
+// Section: Type Definitions
+// *****************************************************************************
+#include <stdbool.h>
+#include <stdint.h>
+
+// Taille de la file (puissance de 2)
+#define EVT_TAILLE 32
+// Taille de la file des chantillons bruts (puissance de 2), soit 64 ms
+#define EVT_TAILLE_ECH 64
+
+// Types d'vnements
+typedef enum {
+    EVT_PEC12_INC,
+    EVT_PEC12_DEC,
+    EVT_PEC12_OK,
+    EVT_PEC12_ESC,
+    EVT_S9_OK,
+    EVT_S9_ESC
+} E_EventType;
+
+// Evnement horodat
+typedef struct {
+    E_EventType Type;
+    uint32_t Timestamp;     // horloge ms (EVT_GetTick) au moment du dpt
+} S_Event;
+
+// Structure de la file
+typedef struct {
+    S_Event Evenements[EVT_TAILLE];
+    volatile uint8_t IndexEcriture; // modifi par le producteur seulement
+    volatile uint8_t IndexLecture;  // modifi par le consommateur seulement
+    volatile uint16_t NbPerdus;     // vnements perdus (file pleine)
+    // Echantillons bruts des entres (producteur : interruption Timer1)
+    uint8_t Echantillons[EVT_TAILLE_ECH];
+    volatile uint8_t IndexEcritureEch;
+    volatile uint8_t IndexLectureEch;
+    volatile uint16_t NbEchPerdus;  // chantillons perdus (boucle en retard)
+    uint8_t RemplissageEch;         // retard maximum observ (ms)
+} S_EventQueue;
+
+// File des vnements d'entre
+extern S_EventQueue EventQueue;
+
+void EVT_Init(void);
+
+// Avance de l'horloge ms,  appeler toutes les 1 ms (interruption Timer1)
+void EVT_Tick(void);
+uint32_t EVT_GetTick(void);
+
+// Dpt d'un vnement, false si la file est pleine
+bool EVT_Push(E_EventType type);
+
+// Lecture / retrait du prochain vnement, false si la file est vide
+bool EVT_Peek(S_Event *pEvt);
+bool EVT_Pop(S_Event *pEvt);
+
+// Abandon de tous les vnements en attente
+void EVT_Vide(void);
+
+// Dpt d'un chantillon brut des entres (interruption Timer1)
+void EVT_DeposeEchantillon(uint8_t entrees);
+
+// Retrait du prochain chantillon brut, false si aucun tick en attente
+bool EVT_RetireEchantillon(uint8_t *pEntrees);
+
+// true si au moins un chantillon brut attend son traitement
+bool EVT_EchantillonEnAttente(void);
+
+#endif
@@ -0,0 +1,201 @@
+// GesLatence.c
+// Latence et dbit des commandes TCP du gnrateur
+//
+// Deux horodatages en attente :
+//  - debutCommande : crit et lu dans la boucle principale uniquement
+//    (APP_Tasks puis GENSIG_UpdateSignal) ;
+//  - debutTable / tableEnAttente : crits par la boucle principale, lus
+//    et acquitts par l'interruption Timer3. L'horodatage est crit avant
+//    le drapeau, l'interruption ne voit jamais un horodatage incomplet.
+//
+//---------------------------------------------------------------------------
+
+#include <stdio.h>
+#include "GesLatence.h"
+#include "GesMesure.h"
+#include "GesEvent.h"
+#include "system_definitions.h"
+
+// Largeur d'une classe en pas du core timer
+#define LATENCE_PAS ((LATENCE_PAS_US * (MESURE_FREQ_CORE_TIMER / 1000)) / 1000)
+
+// Statistiques des commandes
+S_Latence latenceCommandes;
+
+// Trame reue pas encore reprise par GENSIG_UpdateSignal
+static bool commandeEnAttente = false;
+static uint32_t debutCommande;
+
+// Table calcule pas encore envoye au DAC
+static volatile bool tableEnAttente = false;
+static volatile uint32_t debutTable;
+
+//----------------------------------------------------------------------------
+//  LATENCE_CommandeRecue
+//  Horodatage de l'arrive d'une trame. Si la prcdente n'a pas encore
+//  t applique, la plus ancienne est conserve : c'est elle qui attend
+//  le plus longtemps.
+//----------------------------------------------------------------------------
+
+void LATENCE_CommandeRecue(bool valide) {
+    if (!valide) {
+        latenceCommandes.NbRejetees++;
+        return;
+    }
+    if (latenceCommandes.NbCommandes == 0) {
+        latenceCommandes.TickPremiere = EVT_GetTick();
+    }
+    latenceCommandes.TickDerniere = EVT_GetTick();
+    latenceCommandes.NbCommandes++;
+
+    if (!commandeEnAttente) {
+        debutCommande = MESURE_Lire();
+        commandeEnAttente = true;
+    }
+}
+
+//----------------------------------------------------------------------------
+//  LATENCE_TablePreparee
+//  Transmet l'horodatage de la trame  la table qui vient d'tre calcule
+//----------------------------------------------------------------------------
+
+void LATENCE_TablePreparee(void) {
+    if (commandeEnAttente && !tableEnAttente) {
+        debutTable = debutCommande;
+        __asm__ __volatile__("" ::: "memory");
+        tableEnAttente = true;
+        commandeEnAttente = false;
+    }
+}
+
+//----------------------------------------------------------------------------
+//  LATENCE_SansEffet
+//  La trame en attente ne change pas les paramtres : son horodatage est
+//  abandonn, il ne doit pas tre attribu  la prochaine table
+//----------------------------------------------------------------------------
+
+void LATENCE_SansEffet(void) {
+    commandeEnAttente = false;
+}
+
+//----------------------------------------------------------------------------
+//  LATENCE_TableActive
+//  Appele par GENSIG_Execute au premier chantillon d'une nouvelle table
+//----------------------------------------------------------------------------
+
+void LATENCE_TableActive(void) {
+    uint32_t latence;
+    uint32_t classe;
+
+    if (!tableEnAttente) {
+        return;
+    }
+    latence = MESURE_Lire() - debutTable;
+    classe = latence / LATENCE_PAS;
+    if (classe >= LATENCE_NB_CLASSES) {
+        classe = LATENCE_NB_CLASSES - 1;
+    }
+    latenceCommandes.Classes[classe]++;
+    if (latence > latenceCommandes.Max) {
+        latenceCommandes.Max = latence;
+    }
+    latenceCommandes.NbAppliquees++;
+    tableEnAttente = false;
+}
+
+void LATENCE_Raz(void) {
+    uint8_t i;
+    bool etatInt = SYS_INT_Disable();
+
+    latenceCommandes.NbCommandes = 0;
+    latenceCommandes.NbRejetees = 0;
+    latenceCommandes.NbAppliquees = 0;
+    latenceCommandes.Max = 0;
+    for (i = 0; i < LATENCE_NB_CLASSES; i++) {
+        latenceCommandes.Classes[i] = 0;
+    }
+    commandeEnAttente = false;
+    tableEnAttente = false;
+    SYS_INT_Restore(etatInt);
+}
+
+//----------------------------------------------------------------------------
+//  LATENCE_Centile
+//  Borne suprieure (us) de la classe qui contient le centile demand
+//----------------------------------------------------------------------------
+
+static uint32_t LATENCE_Centile(uint8_t centile) {
+    uint32_t seuil;
+    uint32_t cumul = 0;
+    uint8_t i;
+
+    if (latenceCommandes.NbAppliquees == 0) {
+        return 0;
+    }
+    // Rang arrondi vers le haut, au moins 1
+    seuil = ((latenceCommandes.NbAppliquees * centile) + 99) / 100;
+    for (i = 0; i < LATENCE_NB_CLASSES; i++) {
+        cumul += latenceCommandes.Classes[i];
+        if (cumul >= seuil) {
+            break;
+        }
+    }
+    if (i >= (LATENCE_NB_CLASSES - 1)) {
+        // Classe de dbordement : seul le maximum est connu
+        return MESURE_EnNs(latenceCommandes.Max) / 1000;
+    }
+    return (uint32_t) (i + 1) * LATENCE_PAS_US;
+}
+
+//----------------------------------------------------------------------------
+//  LATENCE_Format
+//  Dbit en trames par seconde (x100) sur la fentre premire - dernire
+//  trame, centiles et classes non vides de l'histogramme
+//----------------------------------------------------------------------------
+
+uint16_t LATENCE_Format(char *pTexte, uint16_t taille) {
+    uint32_t duree = latenceCommandes.TickDerniere - latenceCommandes.TickPremiere;
+    uint32_t debit = 0;
+    uint16_t longueur;
+    uint8_t i;
+    int n;
+
+    if ((latenceCommandes.NbCommandes > 1) && (duree > 0)) {
+        debit = (uint32_t) (((uint64_t) (latenceCommandes.NbCommandes - 1) * 100000ull) / duree);
+    }
+    n = snprintf(pTexte, taille,
+            "trames %lu\r\nrejetees %lu\r\nappliquees %lu\r\n"
+            "debit %lu.%02lu/s\r\np50 %lu us\r\np99 %lu us\r\nmax %lu us\r\n",
+            (unsigned long) latenceCommandes.NbCommandes,
+            (unsigned long) latenceCommandes.NbRejetees,
+            (unsigned long) latenceCommandes.NbAppliquees,
+            (unsigned long) (debit / 100), (unsigned long) (debit % 100),
+            (unsigned long) LATENCE_Centile(50),
+            (unsigned long) LATENCE_Centile(99),
+            (unsigned long) (MESURE_EnNs(latenceCommandes.Max) / 1000));
+    if ((n < 0) || (n >= taille)) {
+        return 0;
+    }
+    longueur = n;
+
+    // Classes non vides "<borne us:nombre"
+    for (i = 0; i < LATENCE_NB_CLASSES; i++) {
+        if (latenceCommandes.Classes[i] == 0) {
+            continue;
+        }
+        n = snprintf(&pTexte[longueur], taille - longueur, "%c%lu:%lu ",
+                (i < (LATENCE_NB_CLASSES - 1)) ? '<' : '>',
+                (unsigned long) ((i < (LATENCE_NB_CLASSES - 1)) ? (i + 1) : i) * LATENCE_PAS_US,
+                (unsigned long) latenceCommandes.Classes[i]);
+        if ((n < 0) || (n >= (taille - longueur))) {
+            return longueur;
+        }
+        longueur += n;
+    }
+    if ((taille - longueur) > 2) {
+        pTexte[longueur++] = '\r';
+        pTexte[longueur++] = '\n';
+        pTexte[longueur] = '\0';
+    }
+    return longueur;
+}
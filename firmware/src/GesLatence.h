@@ -0,0 +1,71 @@
+#ifndef GesLatence_h
+#define GesLatence_h
+
+// GesLatence.h
+// Latence et dbit des commandes TCP du gnrateur
+//
+// Principe : l'arrive d'une trame !S=..# est horodate dans APP_Tasks
+//            (core timer). Le prochain GENSIG_UpdateSignal reprend cet
+//            horodatage pour la table qu'il calcule, et le premier
+//            GENSIG_Execute qui envoie un chantillon de cette table
+//            (interruption Timer3) mesure la latence commande -> sortie.
+//            Les latences sont classes dans un histogramme linaire
+//            (pas de LATENCE_PAS_US) d'o sont tirs p50 et p99.
+//
+//            Le mode remote n'applique que les derniers paramtres reus :
+//            plusieurs trames reues entre deux mises  jour du signal ne
+//            donnent qu'une mesure (NbAppliquees < NbCommandes).
+//
+//  Fonctions  disposition :
+//       LATENCE_CommandeRecue  horodatage d'une trame (APP_Tasks)
+//       LATENCE_TablePreparee  table recalcule (GENSIG_UpdateSignal)
+//       LATENCE_SansEffet      trame sans changement, aucune table
+//       LATENCE_TableActive    premier chantillon de la table (ISR Timer3)
+//       LATENCE_Raz            remise  zro des statistiques
+//       LATENCE_Format         rapport (dbit, p50, p99, histogramme)
+//
+//---------------------------------------------------------------------------
+
+// *****************************************************************************
+// Section: Type Definitions
+// *****************************************************************************
+#include <stdbool.h>
+#include <stdint.h>
+
+// Largeur d'une classe de l'histogramme (us)
+#define LATENCE_PAS_US 250
+// Nombre de classes, la dernire compte tout ce qui dpasse (20 ms)
+#define LATENCE_NB_CLASSES 80
+
+// Statistiques des commandes
+typedef struct {
+    uint32_t NbCommandes;       // trames valides reues
+    uint32_t NbRejetees;        // trames mal formes
+    uint32_t NbAppliquees;      // latences mesures
+    uint32_t TickPremiere;      // horloge ms de la premire trame
+    uint32_t TickDerniere;      // horloge ms de la dernire trame
+    uint32_t Max;               // latence maximale (pas du core timer)
+    uint32_t Classes[LATENCE_NB_CLASSES];
+} S_Latence;
+
+// Statistiques des commandes
+extern S_Latence latenceCommandes;
+
+// Horodatage d'une trame reue, valide ou non (GetMessage)
+void LATENCE_CommandeRecue(bool valide);
+
+// Table recalcule dans la boucle principale
+void LATENCE_TablePreparee(void);
+
+// Paramtres inchangs : aucune table ne suit la trame en attente
+void LATENCE_SansEffet(void);
+
+// Premier chantillon d'une nouvelle table envoy au DAC (interruption)
+void LATENCE_TableActive(void);
+
+void LATENCE_Raz(void);
+
+// Rapport texte, retourne la longueur crite
+uint16_t LATENCE_Format(char *pTexte, uint16_t taille);
+
+#endif
@@ -0,0 +1,301 @@
+// GesLcd.c
+// File d'attente des critures sur le LCD
+//
+// Format du tampon : les caractres sont stocks tels quels, les
+// commandes sont prcdes de l'octet d'chappement LCDQ_ESC (voir
+// GesLcd.h), un caractre gal  LCDQ_ESC est doubl.
+//
+// Une commande ou un texte est toujours dpos en entier. Si la place
+// manque il est abandonn et compt dans NbPerdus, et le tampon passe en
+// dbordement : les dpts suivants sont abandonns eux aussi (une mise 
+// jour de l'cran est faite de plusieurs commandes, en perdre une au
+// milieu laisserait un texte au mauvais endroit). Toutes les critures,
+// dposes ou non, sont reportes dans une image de l'cran ; une fois
+// le tampon vide, LCDQ_Tasks redessine l'cran entier depuis l'image et
+// les dpts reprennent.
+//
+// Le producteur (APPGEN_Tasks, APP_Tasks) et le consommateur (LCDQ_Tasks)
+// tournent tous deux dans la boucle principale, aucune protection
+// contre les interruptions n'est ncessaire.
+//
+//---------------------------------------------------------------------------
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include "GesLcd.h"
+#include "GesMesure.h"
+#include "Mc32DriverLcd.h"
+
+#define LCDQ_MASQUE (LCDQ_TAILLE - 1)
+
+// File d'attente LCD
+S_LcdQueue LcdQueue;
+
+// Image de l'cran et curseur, tenus au dpt
+static uint8_t ecran[LCDQ_LIGNES][LCDQ_COLONNES];
+static uint8_t ligneImage = 0;
+static uint8_t colonneImage = 0;
+
+//----------------------------------------------------------------------------
+//  LCDQ_Occupation
+//  Nombre d'octets en attente dans le tampon
+//----------------------------------------------------------------------------
+
+static uint16_t LCDQ_Occupation(void) {
+    return (uint16_t) ((LcdQueue.IndexEcriture - LcdQueue.IndexLecture) & LCDQ_MASQUE);
+}
+
+//----------------------------------------------------------------------------
+//  LCDQ_ImageEfface / LCDQ_ImageTexte
+//  Report dans l'image de l'effacement de l'cran et d'un texte, comme le
+//  fait le LCD : '\f' efface, les caractres au-del de la dernire
+//  colonne ne sont pas visibles
+//----------------------------------------------------------------------------
+
+static void LCDQ_ImageEfface(void) {
+    memset(ecran, ' ', sizeof (ecran));
+    ligneImage = 0;
+    colonneImage = 0;
+}
+
+static void LCDQ_ImageTexte(const uint8_t *pTexte, uint16_t nb) {
+    uint16_t i;
+
+    for (i = 0; i < nb; i++) {
+        if (pTexte[i] == '\f') {
+            LCDQ_ImageEfface();
+        } else if (colonneImage < LCDQ_COLONNES) {
+            ecran[ligneImage][colonneImage] = pTexte[i];
+            colonneImage++;
+        }
+    }
+}
+
+//----------------------------------------------------------------------------
+//  LCDQ_Depose
+//  Dpose une commande complte (nb octets) dans le tampon, sauf en
+//  dbordement
+//----------------------------------------------------------------------------
+
+static void LCDQ_Depose(const uint8_t *pOctets, uint16_t nb) {
+    uint16_t i;
+    uint16_t occupation = LCDQ_Occupation();
+
+    // Une case reste toujours libre pour distinguer plein et vide
+    if (LcdQueue.Deborde || ((occupation + nb) > (LCDQ_TAILLE - 1))) {
+        LcdQueue.Deborde = true;
+        LcdQueue.NbPerdus++;
+        return;
+    }
+
+    for (i = 0; i < nb; i++) {
+        LcdQueue.Tampon[LcdQueue.IndexEcriture] = pOctets[i];
+        LcdQueue.IndexEcriture = (LcdQueue.IndexEcriture + 1) & LCDQ_MASQUE;
+    }
+
+    if ((occupation + nb) > LcdQueue.Remplissage) {
+        LcdQueue.Remplissage = occupation + nb;
+    }
+}
+
+//----------------------------------------------------------------------------
+//  LCDQ_DeposeTexte
+//  Dpose un texte complet (nb caractres), LCDQ_ESC doubl, sauf en
+//  dbordement
+//----------------------------------------------------------------------------
+
+static void LCDQ_DeposeTexte(const uint8_t *pTexte, uint16_t nb) {
+    uint16_t i;
+    uint16_t nbOctets = nb;
+    uint16_t occupation = LCDQ_Occupation();
+
+    for (i = 0; i < nb; i++) {
+        if (pTexte[i] == LCDQ_ESC) {
+            nbOctets++;
+        }
+    }
+    if (LcdQueue.Deborde || ((occupation + nbOctets) > (LCDQ_TAILLE - 1))) {
+        LcdQueue.Deborde = true;
+        LcdQueue.NbPerdus++;
+        return;
+    }
+
+    for (i = 0; i < nb; i++) {
+        if (pTexte[i] == LCDQ_ESC) {
+            LcdQueue.Tampon[LcdQueue.IndexEcriture] = LCDQ_ESC;
+            LcdQueue.IndexEcriture = (LcdQueue.IndexEcriture + 1) & LCDQ_MASQUE;
+        }
+        LcdQueue.Tampon[LcdQueue.IndexEcriture] = pTexte[i];
+        LcdQueue.IndexEcriture = (LcdQueue.IndexEcriture + 1) & LCDQ_MASQUE;
+    }
+
+    if ((occupation + nbOctets) > LcdQueue.Remplissage) {
+        LcdQueue.Remplissage = occupation + nbOctets;
+    }
+}
+
+//----------------------------------------------------------------------------
+//  LCDQ_Lit
+//  Lit l'octet suivant du tampon (le tampon ne doit pas tre vide)
+//----------------------------------------------------------------------------
+
+static uint8_t LCDQ_Lit(void) {
+    uint8_t octet = LcdQueue.Tampon[LcdQueue.IndexLecture];
+    LcdQueue.IndexLecture = (LcdQueue.IndexLecture + 1) & LCDQ_MASQUE;
+    return octet;
+}
+
+//----------------------------------------------------------------------------
+//  LCDQ_Redessine
+//  Fin d'un dbordement (tampon vide) : chaque ligne de l'image rcrite
+//  en entier, celle du curseur en dernier, puis le curseur replac (s'il
+//  est au-del de la dernire colonne, la rcriture l'y a laiss)
+//----------------------------------------------------------------------------
+
+static void LCDQ_Redessine(void) {
+    uint8_t commande[4] = {LCDQ_ESC, LCDQ_CMD_GOTO, 1, 1};
+    uint8_t i;
+
+    LcdQueue.Deborde = false;
+    LcdQueue.NbRedessins++;
+    for (i = 1; i <= LCDQ_LIGNES; i++) {
+        uint8_t ligne = (uint8_t) ((ligneImage + i) % LCDQ_LIGNES);
+        commande[2] = 1;
+        commande[3] = ligne + 1;
+        LCDQ_Depose(commande, sizeof (commande));
+        LCDQ_DeposeTexte(ecran[ligne], LCDQ_COLONNES);
+    }
+    if (colonneImage < LCDQ_COLONNES) {
+        commande[2] = colonneImage + 1;
+        commande[3] = ligneImage + 1;
+        LCDQ_Depose(commande, sizeof (commande));
+    }
+}
+
+void LCDQ_Init(void) {
+    LcdQueue.IndexEcriture = 0;
+    LcdQueue.IndexLecture = 0;
+    LcdQueue.NbPerdus = 0;
+    LcdQueue.Remplissage = 0;
+    LcdQueue.NbRedessins = 0;
+    LcdQueue.Deborde = false;
+    // lcd_init vient d'effacer l'cran
+    LCDQ_ImageEfface();
+    LcdQueue.Actif = true;
+}
+
+void LCDQ_Gotoxy(uint8_t x, uint8_t y) {
+#ifdef LCDQ_ENABLE
+    uint8_t commande[4] = {LCDQ_ESC, LCDQ_CMD_GOTO, x, y};
+
+    // Position hors de l'cran ignore par le LCD
+    if ((x >= 1) && (x <= LCDQ_COLONNES) && (y >= 1) && (y <= LCDQ_LIGNES)) {
+        colonneImage = x - 1;
+        ligneImage = y - 1;
+    }
+    LCDQ_Depose(commande, sizeof (commande));
+#else
+    lcd_gotoxy(x, y);
+#endif
+}
+
+void LCDQ_Printf(const char *format, ...) {
+    char texte[LCDQ_LONGUEUR_TEXTE];
+    int longueur;
+    va_list args;
+
+    va_start(args, format);
+    longueur = vsnprintf(texte, sizeof (texte), format, args);
+    va_end(args);
+
+    if (longueur <= 0) {
+        return;
+    }
+    // Texte tronqu  la taille du tampon local
+    if (longueur >= (int) sizeof (texte)) {
+        longueur = sizeof (texte) - 1;
+    }
+#ifdef LCDQ_ENABLE
+    LCDQ_ImageTexte((const uint8_t *) texte, (uint16_t) longueur);
+    LCDQ_DeposeTexte((const uint8_t *) texte, (uint16_t) longueur);
+#else
+    printf_lcd("%s", texte);
+#endif
+}
+
+void LCDQ_Putc(char c) {
+#ifdef LCDQ_ENABLE
+    LCDQ_ImageTexte((const uint8_t *) &c, 1);
+    LCDQ_DeposeTexte((const uint8_t *) &c, 1);
+#else
+    lcd_putc(c);
+#endif
+}
+
+void LCDQ_ClearLine(uint8_t ligne) {
+#ifdef LCDQ_ENABLE
+    uint8_t commande[3] = {LCDQ_ESC, LCDQ_CMD_CLEAR, ligne};
+
+    // Ligne efface, curseur en dbut de ligne (lcd_ClearLine)
+    if ((ligne >= 1) && (ligne <= LCDQ_LIGNES)) {
+        memset(ecran[ligne - 1], ' ', LCDQ_COLONNES);
+        colonneImage = 0;
+        ligneImage = ligne - 1;
+    }
+    LCDQ_Depose(commande, sizeof (commande));
+#else
+    lcd_ClearLine(ligne);
+#endif
+}
+
+//----------------------------------------------------------------------------
+//  LCDQ_Tasks
+//  Envoie au LCD au plus LCDQ_OCTETS_PAR_TOUR octets, et s'arrte ds que
+//  LCDQ_BUDGET_CYCLES est dpass. Une commande commence est toujours
+//  termine (ses paramtres sont dans le tampon). Aprs un dbordement,
+//  le tampon une fois vide, l'cran est redessin (LCDQ_Redessine).
+//  Retourne true si au moins un octet a t envoy.
+//----------------------------------------------------------------------------
+
+bool LCDQ_Tasks(void) {
+    uint32_t debut;
+    uint8_t nbEnvoyes = 0;
+    uint8_t octet;
+    uint8_t x;
+    uint8_t y;
+
+    if (!LcdQueue.Actif) {
+        return false;
+    }
+    if (LcdQueue.Deborde && (LCDQ_Occupation() == 0)) {
+        LCDQ_Redessine();
+    }
+
+    debut = MESURE_Lire();
+    while ((LCDQ_Occupation() > 0) && (nbEnvoyes < LCDQ_OCTETS_PAR_TOUR)
+            && ((MESURE_Lire() - debut) < LCDQ_BUDGET_CYCLES)) {
+        octet = LCDQ_Lit();
+        if (octet != LCDQ_ESC) {
+            lcd_putc(octet);
+        } else {
+            octet = LCDQ_Lit();
+            switch (octet) {
+                case LCDQ_CMD_GOTO:
+                    x = LCDQ_Lit();
+                    y = LCDQ_Lit();
+                    lcd_gotoxy(x, y);
+                    break;
+                case LCDQ_CMD_CLEAR:
+                    lcd_ClearLine(LCDQ_Lit());
+                    break;
+                default:
+                    // LCDQ_ESC doubl : caractre LCDQ_ESC
+                    lcd_putc(octet);
+                    break;
+            }
+        }
+        nbEnvoyes++;
+    }
+    return (nbEnvoyes > 0);
+}
@@ -0,0 +1,92 @@
+#ifndef GesLcd_h
+#define GesLcd_h
+
+// GesLcd.h
+// File d'attente des critures sur le LCD
+//
+// Principe : les fonctions LCDQ_xxx ne pilotent pas directement le LCD,
+//            elles dposent des commandes dans un tampon circulaire.
+//            LCDQ_Tasks, appele  chaque tour de la boucle principale,
+//            vide le tampon par petits morceaux : au plus
+//            LCDQ_OCTETS_PAR_TOUR octets et au plus LCDQ_BUDGET_CYCLES
+//            pas du core timer par appel. Les attentes du LCD ne
+//            s'additionnent ainsi plus au temps de APPGEN_Tasks.
+//            Une image de l'cran est tenue au dpt : si le tampon
+//            dborde, plus rien n'est dpos jusqu' ce qu'il soit vide,
+//            puis l'cran entier est redessin depuis l'image (jamais
+//            une mise  jour  moiti affiche).
+//
+//  Fonctions  disposition (mmes paramtres que Mc32DriverLcd) :
+//       LCDQ_Gotoxy       positionnement du curseur
+//       LCDQ_Printf       criture formate
+//       LCDQ_Putc         criture d'un caractre ('\f' efface l'cran)
+//       LCDQ_ClearLine    effacement d'une ligne
+//       LCDQ_Tasks        vidage partiel du tampon vers le LCD
+//
+//  Sans LCDQ_ENABLE, les fonctions crivent directement sur le LCD
+//  (comportement d'origine), pour comparer les temps de boucle
+//  (voir mesureBoucle dans GesMesure.h).
+//
+//---------------------------------------------------------------------------
+
+// *****************************************************************************
+// Section: Type Definitions
+// *****************************************************************************
+#include <stdbool.h>
+#include <stdint.h>
+
+// Mise en file des critures LCD (commenter pour criture directe)
+#define LCDQ_ENABLE
+
+// Taille du tampon circulaire (puissance de 2)
+#define LCDQ_TAILLE 512
+// Nombre maximum d'octets envoys au LCD par appel de LCDQ_Tasks
+#define LCDQ_OCTETS_PAR_TOUR 4
+// Temps maximum par appel de LCDQ_Tasks (pas du core timer, 25 ns) : 50 us
+#define LCDQ_BUDGET_CYCLES 2000
+// Longueur maximale d'une chane formate par LCDQ_Printf
+#define LCDQ_LONGUEUR_TEXTE 32
+// Dimensions de l'cran (image redessine aprs un dbordement)
+#define LCDQ_LIGNES 4
+#define LCDQ_COLONNES 20
+
+// Codage des commandes dans le tampon : octet d'chappement LCDQ_ESC suivi
+// d'un octet de commande et de ses paramtres. Tous les codes 0x00-0xFF
+// restent affichables (0x00-0x07 : caractres CGRAM du HD44780), un octet
+// de texte gal  LCDQ_ESC est doubl au dpt.
+//      LCDQ_ESC LCDQ_CMD_GOTO  x  y    -> lcd_gotoxy(x, y)
+//      LCDQ_ESC LCDQ_CMD_CLEAR ligne   -> lcd_ClearLine(ligne)
+//      LCDQ_ESC LCDQ_ESC               -> lcd_putc(LCDQ_ESC)
+#define LCDQ_ESC 0x1B
+#define LCDQ_CMD_GOTO 0x01
+#define LCDQ_CMD_CLEAR 0x02
+
+// Structure de la file d'attente LCD
+typedef struct {
+    uint8_t Tampon[LCDQ_TAILLE];
+    uint16_t IndexEcriture;     // prochaine case  crire
+    uint16_t IndexLecture;      // prochaine case  envoyer au LCD
+    uint16_t NbPerdus;          // commandes perdues (tampon plein)
+    uint16_t Remplissage;       // remplissage maximum observ
+    uint16_t NbRedessins;       // crans redessins aprs un dbordement
+    bool Deborde;               // dpts suspendus, cran  redessiner
+    bool Actif;                 // LCD initialis, vidage autoris
+} S_LcdQueue;
+
+// File d'attente LCD
+extern S_LcdQueue LcdQueue;
+
+// Autorise le vidage du tampon ( appeler aprs lcd_init)
+void LCDQ_Init(void);
+
+// Equivalents en file de lcd_gotoxy, printf_lcd, lcd_putc, lcd_ClearLine
+void LCDQ_Gotoxy(uint8_t x, uint8_t y);
+void LCDQ_Printf(const char *format, ...);
+void LCDQ_Putc(char c);
+void LCDQ_ClearLine(uint8_t ligne);
+
+// Vidage partiel du tampon, appel  chaque tour de la boucle principale.
+// Retourne true si des octets ont t envoys au LCD
+bool LCDQ_Tasks(void);
+
+#endif
@@ -0,0 +1,81 @@
+// GesLog.c
+// Journal sur la console (USB CDC) par niveaux,  dbit limit
+//
+// Le seau  jetons est rempli  partir de l'horloge ms (EVT_GetTick) :
+// un jeton toutes les 1000 / LOG_DEBIT ms, au plus LOG_RAFALE jetons.
+// Le message est prfix de l'horloge ms et d'une lettre de niveau
+// (E, A, I, D).
+//
+//---------------------------------------------------------------------------
+
+#include <stdarg.h>
+#include <stdio.h>
+#include "GesLog.h"
+#include "GesEvent.h"
+#include "system_definitions.h"
+
+// Intervalle entre deux jetons (ms)
+#define LOG_INTERVALLE (1000 / LOG_DEBIT)
+
+E_LogNiveau logNiveau = LOG_NIVEAU_DEFAUT;
+
+static uint8_t jetons = LOG_RAFALE;
+static uint32_t tickJeton = 0;
+static uint32_t nbPerdus = 0;
+
+//----------------------------------------------------------------------------
+//  LOG_PrendJeton
+//  Remplit le seau selon le temps coul puis prend un jeton si possible
+//----------------------------------------------------------------------------
+
+static bool LOG_PrendJeton(void) {
+    uint32_t tick = EVT_GetTick();
+    uint32_t nouveaux = (tick - tickJeton) / LOG_INTERVALLE;
+
+    if (nouveaux > 0) {
+        tickJeton += nouveaux * LOG_INTERVALLE;
+        if ((jetons + nouveaux) >= LOG_RAFALE) {
+            jetons = LOG_RAFALE;
+        } else {
+            jetons += nouveaux;
+        }
+    }
+    if (jetons == 0) {
+        return false;
+    }
+    jetons--;
+    return true;
+}
+
+void LOG_Ecrit(E_LogNiveau niveau, const char *format, ...) {
+    static const char lettres[] = "-EAID";
+    char texte[LOG_LONGUEUR];
+    va_list args;
+
+    if (!LOG_PrendJeton()) {
+        nbPerdus++;
+        return;
+    }
+
+    va_start(args, format);
+    vsnprintf(texte, sizeof (texte), format, args);
+    va_end(args);
+
+    SYS_CONSOLE_PRINT("%lu %c %s\r\n", (unsigned long) EVT_GetTick(),
+            lettres[niveau], texte);
+}
+
+E_LogNiveau LOG_Niveau(void) {
+    return logNiveau;
+}
+
+void LOG_ChangeNiveau(E_LogNiveau niveau) {
+    if (niveau > LOG_DEBUG) {
+        niveau = LOG_DEBUG;
+    }
+    logNiveau = niveau;
+}
+
+uint32_t LOG_NbPerdus(void) {
+    return nbPerdus;
+}
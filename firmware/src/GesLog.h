@@ -0,0 +1,66 @@
+#ifndef GesLog_h
+#define GesLog_h
+
+// GesLog.h
+// Journal sur la console (USB CDC) par niveaux,  dbit limit
+//
+// Principe : LOG(niveau, format, ...) ne fait rien d'autre qu'une
+//            comparaison tant que le niveau est au-dessus du niveau courant
+//            (logNiveau) : aucun formatage sur le chemin critique lorsque
+//            le journal est coup ou limit aux erreurs. Les messages
+//            retenus passent par un seau  jetons : au plus LOG_RAFALE
+//            messages d'affile, puis LOG_DEBIT messages par seconde. Les
+//            messages refuss sont compts (LOG_NbPerdus).
+//
+//            A utiliser depuis la boucle principale seulement (pas depuis
+//            une interruption : voir GesTrace pour les vnements des ISR).
+//
+//  Fonctions  disposition :
+//       LOG               criture d'un message (macro)
+//       LOG_Niveau        lecture du niveau courant
+//       LOG_ChangeNiveau  changement du niveau (commande console "log")
+//       LOG_NbPerdus      messages refuss par la limite de dbit
+//
+//---------------------------------------------------------------------------
+
+// *****************************************************************************
+// Section: Type Definitions
+// *****************************************************************************
+#include <stdint.h>
+
+// Niveaux du journal, LOG_AUCUN coupe tout
+typedef enum {
+    LOG_AUCUN = 0,
+    LOG_ERREUR,
+    LOG_ATTENTION,
+    LOG_INFO,
+    LOG_DEBUG
+} E_LogNiveau;
+
+// Niveau au dmarrage
+#define LOG_NIVEAU_DEFAUT LOG_INFO
+// Messages par seconde en rgime permanent
+#define LOG_DEBIT 20
+// Messages accepts d'affile
+#define LOG_RAFALE 10
+// Longueur maximale d'un message
+#define LOG_LONGUEUR 96
+
+// Niveau courant (lu par la macro LOG)
+extern E_LogNiveau logNiveau;
+
+#define LOG(niveau, ...) \
+    do { \
+        if ((niveau) <= logNiveau) { \
+            LOG_Ecrit((niveau), __VA_ARGS__); \
+        } \
+    } while (0)
+
+// Formatage et envoi d'un message (appel via la macro LOG)
+void LOG_Ecrit(E_LogNiveau niveau, const char *format, ...);
+
+E_LogNiveau LOG_Niveau(void);
+void LOG_ChangeNiveau(E_LogNiveau niveau);
+uint32_t LOG_NbPerdus(void);
+
+#endif
@@ -0,0 +1,377 @@
+// GesMesure.c
+// Mesure de dures d'excution avec le core timer (registre CP0 Count)
+//
+// Les dures sont exprimes en pas du core timer (25 ns  80 MHz).
+// Les diffrences sont calcules en uint32_t, le dbordement du
+// compteur est donc transparent tant que la dure reste < 107 s.
+//
+// Chaque descripteur n'est mis  jour que par un seul contexte (son
+// interruption ou la boucle principale). La lecture pour l'affichage
+// peut voir une mise  jour en cours : un compte peut tre dcal d'une
+// unit, sans consquence pour des statistiques.
+//
+//---------------------------------------------------------------------------
+
+#include <stdio.h>
+#include "GesMesure.h"
+#include "Generateur.h"
+#include "system_definitions.h"
+
+// Nombre de paires DEBUT / FIN pour la calibration
+#define MESURE_NB_CALIBRATION 64
+// Motif de la pile libre
+#define MESURE_MOTIF_PILE 0xA5A5A5A5u
+// Marge laisse sous la trame de MESURE_PeintPile (mots)
+#define MESURE_MARGE_PILE 16
+
+// Limite basse de la pile, fournie par le script de liaison XC32
+extern uint32_t _splim[];
+// Haut de la pile au moment de la peinture (trame de main)
+static uint32_t *pHautPile = _splim;
+
+// Dure d'un tour de la boucle principale (SYS_Tasks)
+S_Mesure mesureBoucle = MESURE_VIDE;
+// Dure de l'interruption Timer1 (scan des entres, 1 ms)
+S_Mesure mesureIsrT1 = MESURE_VIDE;
+// Dure de l'interruption Timer3 (calcul et envoi d'un chantillon)
+S_Mesure mesureIsrT3 = MESURE_VIDE;
+// Gigue de l'interruption Timer3 (chantillons du gnrateur)
+S_Mesure mesureGigueT3 = MESURE_VIDE;
+// Retard de l'interruption Timer3 sur l'chance idale
+S_Mesure mesureRetardT3 = MESURE_VIDE;
+S_Mesure mesureRetardT3Attente = MESURE_VIDE;
+// CPU en mode Idle
+volatile bool mesureCpuEnAttente = false;
+// Echantillons en retard ou sauts
+S_RetardsT3 retardsT3 = {0, 0};
+// Dure de l'interruption Ethernet
+S_Mesure mesureIsrEth = MESURE_VIDE;
+// Dure de APP_Tasks et de APPGEN_Tasks
+S_Mesure mesureApp = MESURE_VIDE;
+S_Mesure mesureAppGen = MESURE_VIDE;
+// Cot d'une paire MESURE_DEBUT / MESURE_FIN
+S_Mesure mesureInstrument = MESURE_VIDE;
+
+// Points de mesure prsents par la console et la requte TCP
+typedef struct {
+    const char *Nom;
+    S_Mesure *pMes;
+} S_PointMesure;
+
+static const S_PointMesure pointsMesure[] = {
+    {"isr_t3", &mesureIsrT3},
+    {"gigue_t3", &mesureGigueT3},
+    {"retard_t3", &mesureRetardT3},
+    {"ret_idle", &mesureRetardT3Attente},
+    {"isr_eth", &mesureIsrEth},
+    {"isr_t1", &mesureIsrT1},
+    {"app", &mesureApp},
+    {"appgen", &mesureAppGen},
+    {"boucle", &mesureBoucle},
+    {"instrum", &mesureInstrument},
+};
+
+#define MESURE_NB_POINTS (sizeof (pointsMesure) / sizeof (pointsMesure[0]))
+
+//----------------------------------------------------------------------------
+//  MESURE_Init
+//  Remise  zro d'un descripteur
+//----------------------------------------------------------------------------
+
+void MESURE_Init(S_Mesure *pMes) {
+    uint8_t i;
+
+    pMes->Min = UINT32_MAX;
+    pMes->Max = 0;
+    pMes->Somme = 0;
+    pMes->Nb = 0;
+    for (i = 0; i < MESURE_NB_CLASSES; i++) {
+        pMes->Histo[i] = 0;
+    }
+}
+
+//----------------------------------------------------------------------------
+//  MESURE_Ajoute
+//  Ajoute une dure au descripteur et met  jour min / max et histogramme
+//  (classe = rang du bit de poids fort, instruction clz du MIPS)
+//----------------------------------------------------------------------------
+
+void MESURE_Ajoute(S_Mesure *pMes, uint32_t duree) {
+    uint32_t classe = 0;
+
+    if (duree > 1) {
+        classe = 31 - __builtin_clz(duree);
+        if (classe >= MESURE_NB_CLASSES) {
+            classe = MESURE_NB_CLASSES - 1;
+        }
+    }
+    pMes->Histo[classe]++;
+    if (duree < pMes->Min) {
+        pMes->Min = duree;
+    }
+    if (duree > pMes->Max) {
+        pMes->Max = duree;
+    }
+    pMes->Somme += duree;
+    pMes->Nb++;
+}
+
+//----------------------------------------------------------------------------
+//  MESURE_AjouteEcart
+//  Ajoute l'cart absolu entre une dure mesure et la dure attendue
+//----------------------------------------------------------------------------
+
+void MESURE_AjouteEcart(S_Mesure *pMes, uint32_t duree, uint32_t attendue) {
+    if (duree >= attendue) {
+        MESURE_Ajoute(pMes, duree - attendue);
+    } else {
+        MESURE_Ajoute(pMes, attendue - duree);
+    }
+}
+
+//----------------------------------------------------------------------------
+//  MESURE_Moyenne
+//  Dure moyenne en pas du core timer
+//----------------------------------------------------------------------------
+
+uint32_t MESURE_Moyenne(S_Mesure *pMes) {
+    if (pMes->Nb == 0) {
+        return 0;
+    }
+    return (uint32_t) (pMes->Somme / pMes->Nb);
+}
+
+//----------------------------------------------------------------------------
+//  MESURE_EnNs
+//  Conversion pas du core timer -> ns
+//----------------------------------------------------------------------------
+
+uint32_t MESURE_EnNs(uint32_t duree) {
+    return (uint32_t) (((uint64_t) duree * 1000000000ull) / MESURE_FREQ_CORE_TIMER);
+}
+
+//----------------------------------------------------------------------------
+//  MESURE_Calibre
+//  Mesure une paire MESURE_DEBUT / MESURE_FIN vide : c'est la part de
+//  l'instrumentation comprise dans chaque dure mesure. Appele 
+//  l'initialisation, interruptions du gnrateur pas encore actives.
+//----------------------------------------------------------------------------
+
+void MESURE_Calibre(void) {
+#ifdef MESURE_ENABLE
+    uint8_t i;
+
+    MESURE_Init(&mesureInstrument);
+    for (i = 0; i < MESURE_NB_CALIBRATION; i++) {
+        MESURE_DEBUT(debut);
+        MESURE_FIN(&mesureInstrument, debut);
+    }
+#endif
+}
+
+//----------------------------------------------------------------------------
+//  MESURE_RazTout
+//  Remise  zro de tous les points sauf la calibration. Interruptions
+//  bloques pour ne pas mlanger une mesure en cours avec la remise  zro.
+//----------------------------------------------------------------------------
+
+void MESURE_RazTout(void) {
+    uint8_t i;
+    bool etatInt;
+
+    for (i = 0; i < MESURE_NB_POINTS; i++) {
+        if (pointsMesure[i].pMes != &mesureInstrument) {
+            etatInt = SYS_INT_Disable();
+            MESURE_Init(pointsMesure[i].pMes);
+            SYS_INT_Restore(etatInt);
+        }
+    }
+    etatInt = SYS_INT_Disable();
+    retardsT3.NbRetards = 0;
+    retardsT3.NbManques = 0;
+    SYS_INT_Restore(etatInt);
+}
+
+uint8_t MESURE_NbPoints(void) {
+    return MESURE_NB_POINTS;
+}
+
+//----------------------------------------------------------------------------
+//  MESURE_FormatPoint
+//  Texte "nom nb min moy max" (dures en ns) du point index
+//----------------------------------------------------------------------------
+
+uint16_t MESURE_FormatPoint(uint8_t index, char *pTexte, uint16_t taille) {
+    S_Mesure *pMes;
+    int longueur;
+
+    if ((index >= MESURE_NB_POINTS) || (taille == 0)) {
+        return 0;
+    }
+    pMes = pointsMesure[index].pMes;
+    if (pMes->Nb == 0) {
+        longueur = snprintf(pTexte, taille, "%-8s 0\r\n", pointsMesure[index].Nom);
+    } else {
+        longueur = snprintf(pTexte, taille, "%-8s %lu %lu %lu %lu\r\n",
+                pointsMesure[index].Nom, (unsigned long) pMes->Nb,
+                (unsigned long) MESURE_EnNs(pMes->Min),
+                (unsigned long) MESURE_EnNs(MESURE_Moyenne(pMes)),
+                (unsigned long) MESURE_EnNs(pMes->Max));
+    }
+    if (longueur < 0) {
+        return 0;
+    }
+    return (longueur >= taille) ? (taille - 1) : (uint16_t) longueur;
+}
+
+//----------------------------------------------------------------------------
+//  MESURE_FormatHisto
+//  Classes non vides du point index, "<borne:nombre" avec la borne
+//  suprieure de la classe en ns ('>' pour la dernire classe)
+//----------------------------------------------------------------------------
+
+uint16_t MESURE_FormatHisto(uint8_t index, char *pTexte, uint16_t taille) {
+    S_Mesure *pMes;
+    uint16_t longueur = 0;
+    uint8_t i;
+    int n;
+
+    if ((index >= MESURE_NB_POINTS) || (taille == 0)) {
+        return 0;
+    }
+    pMes = pointsMesure[index].pMes;
+    pTexte[0] = '\0';
+    for (i = 0; i < MESURE_NB_CLASSES; i++) {
+        if (pMes->Histo[i] == 0) {
+            continue;
+        }
+        if (i < (MESURE_NB_CLASSES - 1)) {
+            n = snprintf(&pTexte[longueur], taille - longueur, " <%lu:%lu",
+                    (unsigned long) MESURE_EnNs(2ul << i),
+                    (unsigned long) pMes->Histo[i]);
+        } else {
+            n = snprintf(&pTexte[longueur], taille - longueur, " >%lu:%lu",
+                    (unsigned long) MESURE_EnNs(1ul << i),
+                    (unsigned long) pMes->Histo[i]);
+        }
+        if ((n < 0) || (n >= (taille - longueur))) {
+            return taille - 1;
+        }
+        longueur += n;
+    }
+    return longueur;
+}
+
+//----------------------------------------------------------------------------
+//  MESURE_EchantillonT3
+//  Timer3 repart de 0  chaque chance et lve son flag au mme instant :
+//  la valeur de TMR3 lue en tte d'interruption est donc directement le
+//  retard sur l'chance idale, sans drive cumule. Il est compt en
+//  pas de l'horloge priphrique et converti en pas du core timer.
+//  L'intervalle entre deux entres donne la gigue et les chantillons
+//  sauts (retard suprieur  une priode, TMR3 a alors reboucl).
+//  Le retard d'une interruption qui rveille le CPU du mode Idle est
+//  class  part (ret_idle) pour mesurer l'effet de SCHED_Attente.
+//----------------------------------------------------------------------------
+
+void MESURE_EchantillonT3(uint32_t entree, uint16_t compteurTimer, uint32_t periode) {
+    static uint32_t entreePrecedente = 0;
+    static uint32_t periodePrecedente = 0;
+    uint32_t retard;
+    uint32_t intervalle;
+
+    retard = ((uint32_t) compteurTimer * (MESURE_FREQ_CORE_TIMER / 1000))
+            / (GENSIG_HorlogeTimer() / 1000);
+    if (mesureCpuEnAttente) {
+        mesureCpuEnAttente = false;
+        MESURE_Ajoute(&mesureRetardT3Attente, retard);
+    } else {
+        MESURE_Ajoute(&mesureRetardT3, retard);
+    }
+    if (retard > MESURE_SEUIL_RETARD) {
+        retardsT3.NbRetards++;
+    }
+
+    // Pas de mesure d'intervalle sur l'chantillon qui suit un changement
+    // de priode
+    if (periode == periodePrecedente) {
+        intervalle = entree - entreePrecedente;
+        MESURE_AjouteEcart(&mesureGigueT3, intervalle, periode);
+        if (intervalle > (periode + (periode / 2))) {
+            retardsT3.NbManques++;
+        }
+    }
+    entreePrecedente = entree;
+    periodePrecedente = periode;
+}
+
+//----------------------------------------------------------------------------
+//  MESURE_FormatGigue
+//  Rapport complet de la gigue du gnrateur (requte TCP ?JIT#)
+//----------------------------------------------------------------------------
+
+uint16_t MESURE_FormatGigue(char *pTexte, uint16_t taille) {
+    static const S_Mesure * const pointsGigue[] = {
+        &mesureRetardT3, &mesureRetardT3Attente, &mesureGigueT3
+    };
+    uint16_t longueur;
+    uint8_t i;
+    uint8_t j;
+    int n;
+
+    n = snprintf(pTexte, taille, "seuil %lu\r\nretards %lu\r\nmanques %lu\r\n",
+            (unsigned long) MESURE_SEUIL_RETARD_NS,
+            (unsigned long) retardsT3.NbRetards,
+            (unsigned long) retardsT3.NbManques);
+    if ((n < 0) || (n >= taille)) {
+        return 0;
+    }
+    longueur = n;
+
+    for (i = 0; i < (sizeof (pointsGigue) / sizeof (pointsGigue[0])); i++) {
+        for (j = 0; j < MESURE_NB_POINTS; j++) {
+            if (pointsMesure[j].pMes != pointsGigue[i]) {
+                continue;
+            }
+            longueur += MESURE_FormatPoint(j, &pTexte[longueur], taille - longueur);
+            longueur += MESURE_FormatHisto(j, &pTexte[longueur], taille - longueur);
+            if ((taille - longueur) > 2) {
+                pTexte[longueur++] = '\r';
+                pTexte[longueur++] = '\n';
+                pTexte[longueur] = '\0';
+            }
+        }
+    }
+    return longueur;
+}
+
+//----------------------------------------------------------------------------
+//  MESURE_PeintPile
+//  La pile descend du haut de la RAM vers _splim. Tout ce qui est sous la
+//  trame courante (moins une marge) est rempli par le motif ; la partie
+//  o le motif est rest intact n'a jamais t utilise.
+//----------------------------------------------------------------------------
+
+void MESURE_PeintPile(void) {
+    uint32_t *p = _splim;
+    uint32_t *pFin;
+
+    pHautPile = (uint32_t *) __builtin_frame_address(0);
+    pFin = pHautPile - MESURE_MARGE_PILE;
+    while (p < pFin) {
+        *p++ = MESURE_MOTIF_PILE;
+    }
+}
+
+uint32_t MESURE_PileTaille(void) {
+    return (uint32_t) (pHautPile - _splim) * sizeof (uint32_t);
+}
+
+uint32_t MESURE_PileLibre(void) {
+    uint32_t *p = _splim;
+
+    while ((p < pHautPile) && (*p == MESURE_MOTIF_PILE)) {
+        p++;
+    }
+    return (uint32_t) (p - _splim) * sizeof (uint32_t);
+}
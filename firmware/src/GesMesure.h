@@ -0,0 +1,166 @@
+#ifndef GesMesure_h
+#define GesMesure_h
+
+// GesMesure.h
+// Mesure de dures d'excution avec le core timer (registre CP0 Count)
+//
+// Principe : le core timer du PIC32MX s'incrmente  SYS_CLK_FREQ / 2,
+//            soit 40 MHz (25 ns par pas). On lit le compteur au dbut et
+//             la fin d'une portion de code et on accumule la diffrence
+//            dans un descripteur S_Mesure (min, max, somme, nombre et
+//            histogramme en classes de puissances de 2).
+//
+//  Fonctions  disposition :
+//       MESURE_Lire       lecture du core timer
+//       MESURE_Init       remise  zro d'un descripteur
+//       MESURE_Ajoute     ajoute une dure (en pas du core timer)
+//       MESURE_AjouteEcart ajoute l'cart absolu entre une dure et la
+//                         dure attendue (gigue)
+//       MESURE_Moyenne    dure moyenne en pas du core timer
+//       MESURE_EnNs       conversion pas du core timer -> ns
+//       MESURE_Calibre    mesure du cot de l'instrumentation elle-mme
+//       MESURE_RazTout    remise  zro de tous les points de mesure
+//       MESURE_NbPoints   nombre de points de mesure enregistrs
+//       MESURE_FormatPoint / MESURE_FormatHisto
+//                         mise en texte d'un point (console et TCP)
+//       MESURE_EchantillonT3 horodatage d'un chantillon du gnrateur
+//                         (retard sur l'chance idale, gigue, pertes)
+//       MESURE_FormatGigue rapport de gigue du gnrateur
+//       MESURE_PeintPile  remplissage de la pile libre par un motif (main)
+//       MESURE_PileTaille / MESURE_PileLibre
+//                         taille de la pile et partie jamais utilise
+//
+//  Instrumentation : MESURE_DEBUT(debut) et MESURE_FIN(&mesureXxx, debut)
+//  encadrent la portion mesure. Sans MESURE_ENABLE, ces macros sont vides
+//  et l'instrumentation ne cote rien.
+//
+//---------------------------------------------------------------------------
+
+// *****************************************************************************
+// Section: Type Definitions
+// *****************************************************************************
+#include <stdbool.h>
+#include <stdint.h>
+#include <xc.h>
+#include "system_config.h"
+
+// Frquence du core timer (moiti de l'horloge systme)
+#define MESURE_FREQ_CORE_TIMER (SYS_CLK_FREQ / 2)
+
+// Instrumentation des interruptions et des tches (commenter pour la retirer)
+#define MESURE_ENABLE
+
+// Nombre de classes de l'histogramme : la classe k compte les dures
+// comprises entre 2^k et 2^(k+1) - 1 pas, la dernire tout ce qui dpasse
+// (2^15 pas = 819 us)
+#define MESURE_NB_CLASSES 16
+
+// Descripteur d'une mesure
+typedef struct {
+    uint32_t Min;       // dure minimale
+    uint32_t Max;       // dure maximale
+    uint64_t Somme;     // somme des dures (pour la moyenne)
+    uint32_t Nb;        // nombre de mesures
+    uint32_t Histo[MESURE_NB_CLASSES];  // rpartition des dures
+} S_Mesure;
+
+// Valeur initiale d'un descripteur
+#define MESURE_VIDE {UINT32_MAX, 0, 0, 0, {0}}
+
+// Dure d'un tour de la boucle principale (SYS_Tasks)
+extern S_Mesure mesureBoucle;
+// Dure de l'interruption Timer1 (scan des entres, 1 ms)
+extern S_Mesure mesureIsrT1;
+// Dure de l'interruption Timer3 (calcul et envoi d'un chantillon)
+extern S_Mesure mesureIsrT3;
+// Gigue de l'interruption Timer3 (chantillons du gnrateur)
+extern S_Mesure mesureGigueT3;
+// Retard de l'interruption Timer3 sur l'chance idale (fin de priode)
+extern S_Mesure mesureRetardT3;
+// Idem lorsque l'interruption rveille le CPU en mode Idle (SCHED_Attente)
+extern S_Mesure mesureRetardT3Attente;
+// CPU en mode Idle (instruction wait), positionn par SCHED_Attente
+extern volatile bool mesureCpuEnAttente;
+// Dure de l'interruption Ethernet
+extern S_Mesure mesureIsrEth;
+// Dure de APP_Tasks (TCP) et de APPGEN_Tasks (menu, LCD)
+extern S_Mesure mesureApp;
+extern S_Mesure mesureAppGen;
+// Cot d'une paire MESURE_DEBUT / MESURE_FIN (MESURE_Calibre)
+extern S_Mesure mesureInstrument;
+
+// Seuil au-del duquel un chantillon du gnrateur compte comme en
+// retard (ns), la latence d'entre en interruption seule est < 1 us
+#define MESURE_SEUIL_RETARD_NS 2000
+#define MESURE_SEUIL_RETARD \
+    ((MESURE_SEUIL_RETARD_NS * (MESURE_FREQ_CORE_TIMER / 1000000)) / 1000)
+
+// Compteurs des chantillons du gnrateur hors tolrance
+typedef struct {
+    uint32_t NbRetards;     // retard > MESURE_SEUIL_RETARD
+    uint32_t NbManques;     // intervalle > 1,5 priode : chantillon saut
+} S_RetardsT3;
+
+extern S_RetardsT3 retardsT3;
+
+// Lecture du core timer
+static inline uint32_t MESURE_Lire(void) {
+    return _CP0_GET_COUNT();
+}
+
+#ifdef MESURE_ENABLE
+#define MESURE_DEBUT(debut)     uint32_t debut = MESURE_Lire()
+#define MESURE_FIN(pMes, debut) MESURE_Ajoute((pMes), MESURE_Lire() - (debut))
+#else
+#define MESURE_DEBUT(debut)
+#define MESURE_FIN(pMes, debut)
+#endif
+
+// Remise  zro d'un descripteur
+void MESURE_Init(S_Mesure *pMes);
+
+// Ajoute une dure (pas du core timer) au descripteur
+void MESURE_Ajoute(S_Mesure *pMes, uint32_t duree);
+
+// Ajoute l'cart |duree - attendue| au descripteur
+void MESURE_AjouteEcart(S_Mesure *pMes, uint32_t duree, uint32_t attendue);
+
+// Dure moyenne (pas du core timer), 0 si aucune mesure
+uint32_t MESURE_Moyenne(S_Mesure *pMes);
+
+// Conversion pas du core timer -> ns
+uint32_t MESURE_EnNs(uint32_t duree);
+
+// Mesure du cot de l'instrumentation (dans mesureInstrument)
+void MESURE_Calibre(void);
+
+// Remise  zro de tous les points de mesure
+void MESURE_RazTout(void);
+
+// Nombre de points de mesure
+uint8_t MESURE_NbPoints(void);
+
+// Une ligne "nom nb min moy max" (ns) pour le point index,
+// retourne la longueur crite
+uint16_t MESURE_FormatPoint(uint8_t index, char *pTexte, uint16_t taille);
+
+// Classes non vides de l'histogramme du point index ("<borne ns:nombre")
+uint16_t MESURE_FormatHisto(uint8_t index, char *pTexte, uint16_t taille);
+
+// Horodatage d'un chantillon, appel en tte de l'interruption Timer3
+// entree : core timer  l'entre, compteurTimer : valeur de TMR3 (temps
+// coul depuis l'chance), periode : priode attendue (core timer)
+void MESURE_EchantillonT3(uint32_t entree, uint16_t compteurTimer, uint32_t periode);
+
+// Rapport de gigue : seuil, compteurs, retard et gigue avec histogrammes
+uint16_t MESURE_FormatGigue(char *pTexte, uint16_t taille);
+
+// Remplissage de la pile libre par un motif,  appeler au dbut de main
+void MESURE_PeintPile(void);
+
+// Taille de la pile depuis main et octets jamais utiliss depuis le
+// dmarrage (interruptions comprises, elles utilisent la mme pile)
+uint32_t MESURE_PileTaille(void);
+uint32_t MESURE_PileLibre(void);
+
+#endif
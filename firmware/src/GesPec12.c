@@ -5,7 +5,8 @@
 //
 //
 // Principe : Il est ncessaire d'appeler cycliquement la fonction ScanPec12
-//            avec un cycle de 1 ms
+//            avec un cycle de 1 ms (via ScanEntrees, qui fait l'anti-rebond
+//            de toutes les entres en une fois)
 //
 //  Pour la gestion du Pec12, il y a 9 fonctions  disposition :
 //       Pec12IsPlus       true indique un nouveau incrment
@@ -13,6 +14,8 @@
 //       Pec12IsOK         true indique action OK
 //       Pec12IsESC        true indique action ESC
 //       Pec12NoActivity   true indique abscence d'activit sur PEC12
+//       Pec12NbPas        nombre de crans regroups dans l'vnement courant
+//       Pec12Pas          incrment acclr selon la vitesse de rotation
 //  Fonctions pour quittance des indications
 //       Pec12ClearPlus    annule indication d'incrment
 //       Pec12ClearMinus   annule indication de dcrment
@@ -29,11 +32,10 @@
 #include "Mc32Debounce.h"
 #include "Mc32DriverLcd.h"
 #include "appgen.h"
+#include "GesEvent.h"
 
-// Descripteur des sinaux
-S_SwitchDescriptor DescrA;
-S_SwitchDescriptor DescrB;
-S_SwitchDescriptor DescrPB;
+// Descripteur d'anti-rebond des signaux A, B, PB du PEC12 et de S9
+S_VerticalDebounce DescrEntrees;
 
 // Structure pour les traitements du Pec12
 S_Pec12_Descriptor Pec12;
@@ -69,11 +71,17 @@ S_Pec12_Descriptor Pec12;
 //     __________                       __________________
 // A:            |_____________________|        
 
+void ScanEntrees(uint8_t Entrees) {
+    // Traitement antirebond de toutes les entres en parallle
+    DoDebounceVertical(&DescrEntrees, Entrees);
+
+    ScanPec12((Entrees & ENTREE_PEC12_A) != 0, (Entrees & ENTREE_PEC12_B) != 0,
+            (Entrees & ENTREE_PEC12_PB) != 0);
+    ScanS9((Entrees & ENTREE_S9) != 0);
+} // ScanEntrees
+
 void ScanPec12(bool ValA, bool ValB, bool ValPB) {
-    // Traitement antirebond sur A, B et PB
-    DoDebounce(&DescrA, ValA);
-    DoDebounce(&DescrB, ValB);
-    DoDebounce(&DescrPB, ValPB);
+    // L'antirebond sur A, B et PB est fait par ScanEntrees
 
 
     // Traitement du PushButton
@@ -82,39 +90,33 @@ void ScanPec12(bool ValA, bool ValB, bool ValPB) {
         Pec12.PressDuration++;
         Pec12.NoActivity = 0;
     }// Relachement du bouton
-    else if (DebounceIsReleased(&DescrPB)) {
+    else if (VDebounceIsReleased(&DescrEntrees, ENTREE_PEC12_PB)) {
         // Appui long
         if (Pec12.PressDuration >= PRESSION_LONGUE) {
-            Pec12.OK = 0;
-            Pec12.ESC = 1;
+            EVT_Push(EVT_PEC12_ESC);
         }// Appui court
         else {
-            Pec12.ESC = 0;
-            Pec12.OK = 1;
+            EVT_Push(EVT_PEC12_OK);
         }
         // Remise  0 du compteur de dure de l'appui
         Pec12.PressDuration = 0;
         Pec12.NoActivity = 0;
     }// Dtection incrment / dcrment
         // Incrmentation
-    else if (DebounceIsPressed(&DescrB) && (DebounceGetInput(&DescrA) == 0)) {
-        Pec12.Dec = 1;
-        Pec12.Inc = 0;
+    else if (VDebounceIsPressed(&DescrEntrees, ENTREE_PEC12_B)
+            && (VDebounceGetInput(&DescrEntrees, ENTREE_PEC12_A) == 0)) {
+        EVT_Push(EVT_PEC12_DEC);
         Pec12.NoActivity = 0;
     }// Dcrmentation
-    else if (DebounceIsPressed(&DescrB) && (DebounceGetInput(&DescrA) == 1)) {
-        Pec12.Inc = 1;
-        Pec12.Dec = 0;
+    else if (VDebounceIsPressed(&DescrEntrees, ENTREE_PEC12_B)
+            && (VDebounceGetInput(&DescrEntrees, ENTREE_PEC12_A) == 1)) {
+        EVT_Push(EVT_PEC12_INC);
         Pec12.NoActivity = 0;
     }
 
-    // Clear les flag d'appui et de relachement de l'encodeur (partie B)
-    DebounceClearPressed(&DescrB);
-    DebounceClearReleased(&DescrB);
-
-    // Clear les flag d'appui et de relachement du bouton
-    DebounceClearPressed(&DescrPB);
-    DebounceClearReleased(&DescrPB);
+    // Clear les flag d'appui et de relachement de l'encodeur (partie B) et du bouton
+    VDebounceClearPressed(&DescrEntrees, ENTREE_PEC12_B | ENTREE_PEC12_PB);
+    VDebounceClearReleased(&DescrEntrees, ENTREE_PEC12_B | ENTREE_PEC12_PB);
 
 
     // Gestion inactivit
@@ -139,10 +141,8 @@ void ScanPec12(bool ValA, bool ValB, bool ValPB) {
 } // ScanPec12
 
 void Pec12Init(void) {
-    // Initialisation des descripteurs de touches Pec12
-    DebounceInit(&DescrA);
-    DebounceInit(&DescrB);
-    DebounceInit(&DescrPB);
+    // Initialisation du descripteur des entres (PEC12 et S9)
+    VDebounceInit(&DescrEntrees);
 
     // Init de la structure PEc12
     Pec12.Inc = 0; // vnement incrment  
@@ -152,6 +152,9 @@ void Pec12Init(void) {
     Pec12.NoActivity = 0; // Indication d'activit
     Pec12.PressDuration = 0; // Pour dure pression du P.B.
     Pec12.InactivityDuration = 0; // Dure inactivit
+    Pec12.NbPas = 0; // Nombre de crans de l'vnement courant
+    Pec12.IntervalleCran = UINT16_MAX; // Pas d'acclration au dpart
+    Pec12.DernierCran = 0;
 
 } // Pec12Init
 
@@ -169,6 +172,43 @@ bool Pec12IsMinus(void) {
     return (Pec12.Dec);
 }
 
+//       Pec12NbPas        nombre de crans de l'incrment / dcrment courant
+
+uint8_t Pec12NbPas(void) {
+    return (Pec12.NbPas);
+}
+
+//       Pec12MemoCrans    mmorise la vitesse de rotation
+
+void Pec12MemoCrans(uint32_t horodatage, uint8_t nbPas) {
+    uint32_t intervalle;
+
+    if (nbPas == 0) {
+        return;
+    }
+    // Intervalle moyen depuis le dernier cran trait
+    intervalle = (horodatage - Pec12.DernierCran) / nbPas;
+    Pec12.IntervalleCran = (intervalle > UINT16_MAX) ? UINT16_MAX : (uint16_t) intervalle;
+    Pec12.DernierCran = horodatage;
+}
+
+//       Pec12Pas          incrment acclr selon la vitesse de rotation
+
+int32_t Pec12Pas(int16_t pasBase, uint8_t facteurMax) {
+    uint32_t facteur;
+
+    if ((facteurMax <= 1) || (Pec12.IntervalleCran >= PEC12_ACCEL_LENT)) {
+        facteur = 1;
+    } else if (Pec12.IntervalleCran <= PEC12_ACCEL_RAPIDE) {
+        facteur = facteurMax;
+    } else {
+        // Interpolation linaire entre 1 et facteurMax
+        facteur = 1 + ((uint32_t) (facteurMax - 1) * (PEC12_ACCEL_LENT - Pec12.IntervalleCran))
+                / (PEC12_ACCEL_LENT - PEC12_ACCEL_RAPIDE);
+    }
+    return (int32_t) Pec12.NbPas * pasBase * (int32_t) facteur;
+}
+
 //       Pec12IsOK         true indique action OK
 
 bool Pec12IsOK(void) {
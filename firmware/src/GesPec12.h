@@ -9,7 +9,10 @@
 //
 //
 // Principe : Il est ncessaire d'appeler cycliquement la fonction ScanPec12
-//            avec un cycle de 1 ms
+//            avec un cycle de 1 ms (via ScanEntrees, qui fait l'anti-rebond
+//            de toutes les entres en une fois)
+//            Les vnements sont dposs dans la file GesEvent, le menu
+//            les retire et positionne les indications ci-dessous
 //
 //  Pour la gestion du Pec12, il y a 9 fonctions  disposition :
 //       Pec12IsPlus       true indique un nouveau incrment
@@ -17,6 +20,8 @@
 //       Pec12IsOK         true indique action OK
 //       Pec12IsESC        true indique action ESC
 //       Pec12NoActivity   true indique abscence d'activit sur PEC12
+//       Pec12NbPas        nombre de crans regroups dans l'vnement courant
+//       Pec12Pas          incrment acclr selon la vitesse de rotation
 //  Fonctions pour quittance des indications
 //       Pec12ClearPlus    annule indication d'incrment
 //       Pec12ClearMinus   annule indication de dcrment
@@ -32,11 +37,25 @@
 // *****************************************************************************
 #include <stdbool.h>
 #include <stdint.h>
+#include "Mc32Debounce.h"
 
 // Dfinition des constantes
 #define PRESSION_LONGUE 500
 #define TEMPS_INACTIVITE 5000
 
+// Acclration : intervalle entre deux crans en ms (horloge Timer1)
+// au-del de PEC12_ACCEL_LENT le pas reste le pas de base,
+// en dessous de PEC12_ACCEL_RAPIDE le pas est multipli par le facteur max,
+// entre les deux le facteur varie linairement
+#define PEC12_ACCEL_LENT 80
+#define PEC12_ACCEL_RAPIDE 20
+
+// Position des entres dans le mot de l'anti-rebond vertical
+#define ENTREE_PEC12_A  (1u << 0)
+#define ENTREE_PEC12_B  (1u << 1)
+#define ENTREE_PEC12_PB (1u << 2)
+#define ENTREE_S9       (1u << 3)
+
 // structure du descripteur du PEC12
 typedef struct {
             uint8_t Inc : 1;             // vnement incrment
@@ -46,6 +65,9 @@ typedef struct {
             uint8_t NoActivity: 1 ;      // Indication de non activit
             uint16_t PressDuration;   // Pour dure pression du P.B.
             uint16_t InactivityDuration;   // Pour dure inactivit
+            uint8_t NbPas;            // Crans regroups (Inc ou Dec)
+            uint16_t IntervalleCran;  // Intervalle moyen entre crans [ms]
+            uint32_t DernierCran;     // Horodatage du dernier cran [ms]
 } S_Pec12_Descriptor;
 
 //!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
@@ -80,6 +102,16 @@ typedef struct {
 
 void ScanPec12 (bool ValA, bool ValB, bool ValPB);
 
+// ScanEntrees (uint8_t Entrees)
+//              Anti-rebond de toutes les entres en un seul appel
+//              (DoDebounceVertical) puis ScanPec12 et ScanS9.
+//              Entrees regroupe les valeurs brutes (masques ENTREE_xxx)
+//              A appeler avec un cycle de 1 ms  la place de ScanPec12/ScanS9
+void ScanEntrees (uint8_t Entrees);
+
+// Descripteur d'anti-rebond commun au PEC12 et  S9
+extern S_VerticalDebounce DescrEntrees;
+
 void Pec12Init (void);
 
 //       Pec12IsPlus       true indique un nouveau incrment
@@ -92,6 +124,15 @@ bool Pec12IsOK    (void);
 bool Pec12IsESC    (void);
 //       Pec12NoActivity   true indique abscence d'activit sur PEC12
 bool Pec12NoActivity    (void);
+//       Pec12NbPas        nombre de crans regroups dans l'vnement courant
+uint8_t Pec12NbPas    (void);
+//       Pec12MemoCrans    mmorise l'horodatage du dernier cran d'un groupe
+//                         de nbPas crans et en dduit la vitesse de rotation
+void Pec12MemoCrans    (uint32_t horodatage, uint8_t nbPas);
+//       Pec12Pas          incrment total pour les crans regroups :
+//                         nbPas * pasBase * facteur (1  facteurMax selon la
+//                         vitesse de rotation)
+int32_t Pec12Pas    (int16_t pasBase, uint8_t facteurMax);
 
 //  Fonctions pour quittance des indications
 //       Pec12ClearPlus    annule indication d'incrment
@@ -8,40 +8,36 @@
 #include "Mc32Debounce.h"
 #include "Mc32DriverLcd.h"
 #include "appgen.h"
-#include "Mc32Debounce.h"
-
+#include "GesEvent.h"
+#include "GesPec12.h"
 
-S_SwitchDescriptor DescrPB_S9;
 
 // Structure pour les traitements du S9
 S_9_Descriptor S9;
 
 void ScanS9(bool ValS9) {
-    DoDebounce(&DescrPB_S9, ValS9);
+    // L'antirebond de S9 est fait par ScanEntrees
 
     if (ValS9 == 0) {
         S9.PressDuration++;
-    } else if (DebounceIsReleased(&DescrPB_S9)) {
+    } else if (VDebounceIsReleased(&DescrEntrees, ENTREE_S9)) {
         // Appui long
         if (S9.PressDuration >= PRESSION_LONGUE_S9) {
-            S9.OK = 0;
-            S9.ESC = 1;
+            EVT_Push(EVT_S9_ESC);
         }// Appui court
         else {
-            S9.ESC = 0;
-            S9.OK = 1;
+            EVT_Push(EVT_S9_OK);
         }
         // Remise  0 du compteur de dure de l'appui
         S9.PressDuration = 0;
     }
 
-    DebounceClearPressed(&DescrPB_S9);
-    DebounceClearReleased(&DescrPB_S9);
+    VDebounceClearPressed(&DescrEntrees, ENTREE_S9);
+    VDebounceClearReleased(&DescrEntrees, ENTREE_S9);
 }
 
 void S9Init(void) {
-    // Initialisation des descripteurs de touches S9
-    DebounceInit(&DescrPB_S9);
+    // Le descripteur d'anti-rebond de S9 est initialis par Pec12Init
 
     // Init de la structure S9
     S9.OK = 0; // vnement action OK
@@ -0,0 +1,246 @@
+// GesSched.c
+// Ordonnanceur coopratif des tches de la boucle principale
+//
+// Toutes les fonctions s'excutent dans la boucle principale, aucune
+// protection contre les interruptions n'est ncessaire. Les temps sont
+// accumuls tour par tour en uint64_t : le rebouclage du core timer
+// (107 s) ne limite pas la fentre de mesure. Le core timer continue de
+// compter en mode Idle (il ne s'arrte qu'en mode Sleep), le temps
+// d'attente est donc mesur avec lui.
+//
+// Une interruption qui arrive entre le test de SCHED_Attente et
+// l'instruction wait ne rveille pas le CPU : son travail attend la
+// prochaine interruption, au plus une priode d'chantillon ou 1 ms.
+//
+//---------------------------------------------------------------------------
+
+#include <stdio.h>
+#include "GesSched.h"
+#include "GesMesure.h"
+#include "GesEvent.h"
+#include "GesTrace.h"
+#include "system_definitions.h"
+
+// Ordonnanceur de APPGEN
+S_Sched Sched;
+
+void SCHED_Init(void) {
+    Sched.NbTaches = 0;
+    SCHED_Raz();
+
+    // wait met le CPU en mode Idle (et non Sleep), registre OSCCON protg
+    SYS_DEVCON_SystemUnlock();
+    PLIB_OSC_OnWaitActionSet(OSC_ID_0, OSC_ON_WAIT_IDLE);
+    SYS_DEVCON_SystemLock();
+    // Mise en Idle autorise par la commande console "idle on"
+    Sched.AttenteActive = false;
+}
+
+bool SCHED_Ajoute(const char *nom, T_Tache fonction, uint16_t periode,
+        uint16_t budgetUs, uint16_t delai) {
+    S_Tache *pTache;
+
+    if (Sched.NbTaches >= SCHED_NB_TACHES) {
+        return false;
+    }
+    pTache = &Sched.Taches[Sched.NbTaches];
+    pTache->Nom = nom;
+    pTache->Fonction = fonction;
+    pTache->Periode = periode;
+    pTache->Budget = ((uint32_t) budgetUs * (MESURE_FREQ_CORE_TIMER / 1000)) / 1000;
+    pTache->Echeance = EVT_GetTick() + delai;
+    pTache->NbExecutions = 0;
+    pTache->NbDepassements = 0;
+    pTache->NbEcheancesManquees = 0;
+    pTache->DureeMax = 0;
+    pTache->Temps = 0;
+    Sched.NbTaches++;
+    return true;
+}
+
+//----------------------------------------------------------------------------
+//  SCHED_Tasks
+//  Lance dans l'ordre d'ajout les tches dont l'chance est atteinte.
+//  Une tche en retard d'une priode ou plus n'est lance qu'une fois :
+//  les priodes sautes sont comptes comme chances manques et
+//  l'chance suivante est recale sur la grille des priodes.
+//----------------------------------------------------------------------------
+
+void SCHED_Tasks(uint32_t tick) {
+    S_Tache *pTache;
+    uint32_t debut;
+    uint32_t duree;
+    uint32_t retard;
+    bool travail = false;
+    uint8_t i;
+
+    // Dure du tour prcdent, inactif si aucune tche n'a travaill
+    debut = MESURE_Lire();
+    if (Sched.Demarre) {
+        duree = debut - Sched.DernierTour;
+        Sched.TempsTotal += duree;
+        if (Sched.TourInactif) {
+            Sched.TempsInactif += duree;
+        }
+    }
+    Sched.DernierTour = debut;
+    Sched.Demarre = true;
+
+    for (i = 0; i < Sched.NbTaches; i++) {
+        pTache = &Sched.Taches[i];
+
+        if (pTache->Periode != 0) {
+            if ((int32_t) (tick - pTache->Echeance) < 0) {
+                continue;
+            }
+            retard = tick - pTache->Echeance;
+            if (retard >= pTache->Periode) {
+                pTache->NbEcheancesManquees += retard / pTache->Periode;
+                pTache->Echeance += (retard / pTache->Periode) * pTache->Periode;
+            }
+            pTache->Echeance += pTache->Periode;
+        }
+
+        TRACE_Ecrit(TRACE_TACHE_DEBUT, i);
+        debut = MESURE_Lire();
+        if (pTache->Fonction()) {
+            travail = true;
+        }
+        duree = MESURE_Lire() - debut;
+        TRACE_Ecrit(TRACE_TACHE_FIN, i);
+
+        pTache->NbExecutions++;
+        pTache->Temps += duree;
+        if (duree > pTache->DureeMax) {
+            pTache->DureeMax = duree;
+        }
+        if (duree > pTache->Budget) {
+            pTache->NbDepassements++;
+        }
+    }
+    Sched.TourInactif = !travail;
+}
+
+void SCHED_Raz(void) {
+    uint8_t i;
+
+    for (i = 0; i < Sched.NbTaches; i++) {
+        Sched.Taches[i].NbExecutions = 0;
+        Sched.Taches[i].NbDepassements = 0;
+        Sched.Taches[i].NbEcheancesManquees = 0;
+        Sched.Taches[i].DureeMax = 0;
+        Sched.Taches[i].Temps = 0;
+    }
+    Sched.Demarre = false;
+    Sched.TourInactif = false;
+    Sched.TempsTotal = 0;
+    Sched.TempsInactif = 0;
+    Sched.NbAttentes = 0;
+    Sched.TempsAttente = 0;
+}
+
+//----------------------------------------------------------------------------
+//  SCHED_Attente
+//  CPU en mode Idle si le dernier tour n'a rien fait, qu'aucun chantillon
+//  1 ms n'attend et que le serveur TCP n'a pas de travail en cours. Le
+//  temps d'attente fait partie du temps inactif.
+//----------------------------------------------------------------------------
+
+void SCHED_Attente(void) {
+#ifdef SCHED_ATTENTE_ENABLE
+    uint32_t debut;
+
+    if (!Sched.AttenteActive || !Sched.TourInactif || EVT_EchantillonEnAttente()
+            || APP_TravailEnAttente()) {
+        return;
+    }
+    TRACE_Ecrit(TRACE_ATTENTE, 0);
+    debut = MESURE_Lire();
+    mesureCpuEnAttente = true;
+    __asm__ __volatile__("wait");
+    mesureCpuEnAttente = false;
+    TRACE_Ecrit(TRACE_REVEIL, 0);
+    Sched.TempsAttente += MESURE_Lire() - debut;
+    Sched.NbAttentes++;
+#endif
+}
+
+void SCHED_AttenteActive(bool active) {
+#ifdef SCHED_ATTENTE_ENABLE
+    Sched.AttenteActive = active;
+#endif
+}
+
+//----------------------------------------------------------------------------
+//  SCHED_Pourmille
+//  Part d'un temps dans le temps total, en 1/10 de %
+//----------------------------------------------------------------------------
+
+static uint32_t SCHED_Pourmille(uint64_t temps) {
+    if (Sched.TempsTotal == 0) {
+        return 0;
+    }
+    return (uint32_t) ((temps * 1000ull) / Sched.TempsTotal);
+}
+
+//----------------------------------------------------------------------------
+//  SCHED_Format
+//  Une ligne par tche : priode, budget, excutions, utilisation,
+//  dure max, dpassements et chances manques, puis le temps inactif
+//----------------------------------------------------------------------------
+
+uint16_t SCHED_Format(char *pTexte, uint16_t taille) {
+    S_Tache *pTache;
+    uint16_t longueur;
+    uint32_t util;
+    uint8_t i;
+    int n;
+
+    n = snprintf(pTexte, taille, "tache    per[ms] budget[us] nb util[%%] max[us] depass manquees\r\n");
+    if ((n < 0) || (n >= taille)) {
+        return 0;
+    }
+    longueur = n;
+
+    for (i = 0; i < Sched.NbTaches; i++) {
+        pTache = &Sched.Taches[i];
+        util = SCHED_Pourmille(pTache->Temps);
+        n = snprintf(&pTexte[longueur], taille - longueur,
+                "%-8s %u %lu %lu %lu.%lu %lu %lu %lu\r\n",
+                pTache->Nom, (unsigned) pTache->Periode,
+                (unsigned long) (MESURE_EnNs(pTache->Budget) / 1000),
+                (unsigned long) pTache->NbExecutions,
+                (unsigned long) (util / 10), (unsigned long) (util % 10),
+                (unsigned long) (MESURE_EnNs(pTache->DureeMax) / 1000),
+                (unsigned long) pTache->NbDepassements,
+                (unsigned long) pTache->NbEcheancesManquees);
+        if ((n < 0) || (n >= (taille - longueur))) {
+            return longueur;
+        }
+        longueur += n;
+    }
+
+    util = SCHED_Pourmille(Sched.TempsInactif);
+    n = snprintf(&pTexte[longueur], taille - longueur,
+            "inactif %lu.%lu %% sur %lu ms\r\n",
+            (unsigned long) (util / 10), (unsigned long) (util % 10),
+            (unsigned long) (Sched.TempsTotal / (MESURE_FREQ_CORE_TIMER / 1000)));
+    if ((n < 0) || (n >= (taille - longueur))) {
+        return longueur;
+    }
+    longueur += n;
+
+    // Temps en mode Idle et dure moyenne d'une attente
+    util = SCHED_Pourmille(Sched.TempsAttente);
+    n = snprintf(&pTexte[longueur], taille - longueur,
+            "idle %s %lu.%lu %% %lu attentes moy %lu us\r\n",
+            Sched.AttenteActive ? "on" : "off",
+            (unsigned long) (util / 10), (unsigned long) (util % 10),
+            (unsigned long) Sched.NbAttentes,
+            (unsigned long) ((Sched.NbAttentes == 0) ? 0 :
+            (MESURE_EnNs((uint32_t) (Sched.TempsAttente / Sched.NbAttentes)) / 1000)));
+    if ((n < 0) || (n >= (taille - longueur))) {
+        return longueur;
+    }
+    return longueur + n;
+}
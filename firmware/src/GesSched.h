@@ -0,0 +1,111 @@
+#ifndef GesSched_h
+#define GesSched_h
+
+// GesSched.h
+// Ordonnanceur coopratif des tches de la boucle principale
+//
+// Principe : chaque tche dclare sa priode (ms, horloge EVT_GetTick) et
+//            son budget de temps (us). SCHED_Tasks, appele  chaque tour
+//            de la boucle principale, lance les tches arrives 
+//            chance, mesure leur dure au core timer et compte :
+//              - les dpassements de budget ;
+//              - les chances manques (tche lance une priode ou plus
+//                aprs son chance, les priodes sautes sont comptes).
+//            Une tche de priode 0 est lance  chaque tour (tche de
+//            fond, ex. vidage du LCD).
+//
+//            Chaque tche retourne true si elle a eu du travail. Un tour
+//            de boucle o aucune tche n'a travaill est compt comme
+//            inactif : le temps jusqu'au tour suivant s'ajoute au temps
+//            inactif.
+//
+//            Aprs un tour inactif, SCHED_Attente met le CPU en mode Idle
+//            (instruction wait) jusqu' la prochaine interruption : Timer3
+//            (chantillons), Timer1 (1 ms), Ethernet, USB ou Timer2
+//            (SYS_TMR) rveillent le CPU et la boucle repart. Les
+//            priphriques continuent de tourner, seul le CPU s'arrte.
+//            Le MAC Ethernet, l'USB et SYS_TMR sont en mode interruption ;
+//            le seul travail Harmony scrut est celui du serveur TCP, le
+//            CPU reste actif tant que APP_TravailEnAttente le signale.
+//
+//            La mise en Idle est inactive au dmarrage : son effet sur la
+//            gigue de Timer3 n'a pas encore t mesur sur la carte. Pour
+//            la mesurer, comparer "gigue" et "sched" aprs "idle off" puis
+//            "idle on" (statistiques remises  zro  chaque changement).
+//
+//  Fonctions  disposition :
+//       SCHED_Init        initialisation (aucune tche)
+//       SCHED_Ajoute      ajout d'une tche (priode, budget, dlai)
+//       SCHED_Tasks       lancement des tches  chance
+//       SCHED_Raz         remise  zro des statistiques
+//       SCHED_Attente     mise en Idle du CPU si le dernier tour tait inactif
+//       SCHED_AttenteActive  autorise / interdit la mise en Idle
+//       SCHED_Format      rapport d'utilisation par tche
+//
+//---------------------------------------------------------------------------
+
+// *****************************************************************************
+// Section: Type Definitions
+// *****************************************************************************
+#include <stdbool.h>
+#include <stdint.h>
+
+// Nombre maximum de tches
+#define SCHED_NB_TACHES 5
+
+// Mise en Idle du CPU dans les tours inactifs (commenter pour la retirer)
+#define SCHED_ATTENTE_ENABLE
+
+// Fonction d'une tche, retourne true si elle a eu du travail
+typedef bool (*T_Tache)(void);
+
+// Descripteur d'une tche
+typedef struct {
+    const char *Nom;
+    T_Tache Fonction;
+    uint16_t Periode;               // ms, 0 :  chaque tour de boucle
+    uint32_t Budget;                // pas du core timer
+    uint32_t Echeance;              // horloge ms du prochain lancement
+    uint32_t NbExecutions;
+    uint32_t NbDepassements;        // dure > budget
+    uint32_t NbEcheancesManquees;   // priodes sautes
+    uint32_t DureeMax;              // pas du core timer
+    uint64_t Temps;                 // temps total d'excution
+} S_Tache;
+
+// Etat de l'ordonnanceur
+typedef struct {
+    S_Tache Taches[SCHED_NB_TACHES];
+    uint8_t NbTaches;
+    bool Demarre;                   // DernierTour valide
+    bool TourInactif;               // aucune tche n'a travaill au dernier tour
+    uint32_t DernierTour;           // core timer au dbut du dernier tour
+    uint64_t TempsTotal;            // temps coul depuis la remise  zro
+    uint64_t TempsInactif;          // part du temps coul sans travail
+    bool AttenteActive;             // mise en Idle autorise
+    uint32_t NbAttentes;            // passages en mode Idle
+    uint64_t TempsAttente;          // temps pass en mode Idle
+} S_Sched;
+
+void SCHED_Init(void);
+
+// Ajout d'une tche, premier lancement aprs delai ms. Retourne false si
+// la table est pleine
+bool SCHED_Ajoute(const char *nom, T_Tache fonction, uint16_t periode,
+        uint16_t budgetUs, uint16_t delai);
+
+// Lancement des tches  chance, tick : horloge ms courante
+void SCHED_Tasks(uint32_t tick);
+
+void SCHED_Raz(void);
+
+// Mise en Idle jusqu' la prochaine interruption,  appeler en fin de
+// tour de boucle principale
+void SCHED_Attente(void);
+
+void SCHED_AttenteActive(bool active);
+
+// Rapport texte (une ligne par tche), retourne la longueur crite
+uint16_t SCHED_Format(char *pTexte, uint16_t taille);
+
+#endif
@@ -0,0 +1,537 @@
+// GesSignal.c
+// Calcul de la table d'chantillons du gnrateur
+//
+// Aucune dpendance au matriel : seuls DefMenuGen.h, Generateur.h (pour
+// les constantes) et la bibliothque math sont utiliss.
+//
+// Le seul calcul en virgule flottante est le quart de sinus de
+// SIGNAL_Init, en simple prcision (float, sinf) : sur PIC32MZ EF il
+// utilise directement le FPU, sur PIC32MX l'mulation logicielle. Les
+// tables sont ensuite calcules en entiers 32 bits (pas de division ni
+// de multiplication 64 bits par chantillon).
+//
+//---------------------------------------------------------------------------
+
+#include <math.h>
+#include <stddef.h>
+#include "GesSignal.h"
+#include "Generateur.h"
+
+// Echelle des valeurs brutes : 1 mV = 2 * SIGNAL_CRETE units
+#define SIGNAL_ECHELLE (2 * SIGNAL_CRETE)
+// 4 / pi en Q15, coefficient des sries de Fourier du carr et de la dent
+#define SIGNAL_4_SUR_PI 41722
+
+// Forme normalise en cache
+typedef struct {
+    E_FormesSignal Forme;
+    uint16_t Longueur;
+    int16_t *pValeurs;      // Longueur valeurs dans cachePoints
+    bool Pret;              // false : construction en cours ou abandonne
+} S_FormeCache;
+
+// Cache des formes normalises : les tables sont ranges  la suite dans
+// cachePoints, le cache est vid en entier quand la place manque
+static int16_t cachePoints[SIGNAL_CACHE_POINTS];
+static S_FormeCache cacheFormes[SIGNAL_CACHE_NB];
+static uint8_t nbFormes = 0;
+static uint16_t nbPointsUtilises = 0;
+
+// Quart de priode du sinus de longueur GENSIG_LONGUEUR_MAX (SIGNAL_Init),
+// les sinus plus courts en sont extraits
+static int16_t sinusQuart[(GENSIG_LONGUEUR_MAX / 4) + 1];
+
+#ifdef SIGNAL_BL_ENABLE
+// Sommes partielles des sries de Fourier (quart de priode, Q30)
+static int32_t sommesHarmoniques[(GENSIG_LONGUEUR_MAX / 4) + 1];
+
+// Etapes de la construction d'un carr ou d'une dent de scie
+typedef enum {
+    SIGNAL_ETAPE_REPORT,        // dent : report de S_m/2 sur m points
+    SIGNAL_ETAPE_HARMONIQUE,    // ajout d'une harmonique impaire de m
+    SIGNAL_ETAPE_AJOUT,         // dent : ajout des harmoniques de m  S
+    SIGNAL_ETAPE_CONVERSION     // mise  l'chelle SIGNAL_CRETE, forme prte
+} E_EtapeSignal;
+
+// Construction en cours (une seule  la fois)
+typedef struct {
+    S_FormeCache *pEntree;      // NULL : aucune construction
+    uint16_t Periode;           // m : priode des harmoniques en cours
+    uint16_t Harmonique;        // k : prochaine harmonique impaire
+    E_EtapeSignal Etape;
+} S_Construction;
+
+static S_Construction construction = {NULL, 0, 0, SIGNAL_ETAPE_CONVERSION};
+#endif
+
+static void SIGNAL_VideCache(void);
+
+//----------------------------------------------------------------------------
+//  SIGNAL_Init
+//  sin(2 pi n / GENSIG_LONGUEUR_MAX) * SIGNAL_CRETE arrondi, pour n de 0 au
+//  quart de priode. Vide le cache des formes normalises.
+//----------------------------------------------------------------------------
+
+void SIGNAL_Init(void) {
+    uint16_t n;
+    float valeur;
+
+    for (n = 0; n <= (GENSIG_LONGUEUR_MAX / 4); n++) {
+        valeur = sinf(2 * (float) M_PI * ((float) n / (float) GENSIG_LONGUEUR_MAX))
+                * SIGNAL_CRETE;
+        sinusQuart[n] = (int16_t) (valeur + ((valeur >= 0) ? 0.5f : -0.5f));
+    }
+    SIGNAL_VideCache();
+}
+
+//----------------------------------------------------------------------------
+//  SIGNAL_Longueur
+//  Plus grande puissance de 2 entre GENSIG_LONGUEUR_MIN et
+//  GENSIG_LONGUEUR_MAX telle que frequence * longueur <= fechMax
+//----------------------------------------------------------------------------
+
+uint16_t SIGNAL_Longueur(int16_t frequence, uint32_t fechMax) {
+    uint32_t longueur = GENSIG_LONGUEUR_MAX;
+
+    if (frequence <= 0) {
+        return GENSIG_LONGUEUR_MAX;
+    }
+    while ((longueur > GENSIG_LONGUEUR_MIN)
+            && (((uint32_t) frequence * longueur) > fechMax)) {
+        longueur /= 2;
+    }
+    return (uint16_t) longueur;
+}
+
+//----------------------------------------------------------------------------
+//  SIGNAL_Cherche / SIGNAL_Place / SIGNAL_Reserve / SIGNAL_VideCache
+//  Gestion du cache des formes normalises
+//----------------------------------------------------------------------------
+
+// Forme prte (construction termine), NULL si absente
+static int16_t *SIGNAL_Cherche(E_FormesSignal forme, uint16_t longueur) {
+    uint8_t i;
+
+    for (i = 0; i < nbFormes; i++) {
+        if ((cacheFormes[i].Forme == forme) && (cacheFormes[i].Longueur == longueur)
+                && cacheFormes[i].Pret) {
+            return cacheFormes[i].pValeurs;
+        }
+    }
+    return NULL;
+}
+
+// true si nbEntrees tables de nbPoints points au total tiennent encore
+static bool SIGNAL_Place(uint16_t nbPoints, uint8_t nbEntrees) {
+    return (((uint32_t) nbPointsUtilises + nbPoints) <= SIGNAL_CACHE_POINTS)
+            && ((nbFormes + nbEntrees) <= SIGNAL_CACHE_NB);
+}
+
+// Rservation d'une table (la place doit avoir t vrifie)
+static S_FormeCache *SIGNAL_Reserve(E_FormesSignal forme, uint16_t longueur) {
+    S_FormeCache *pEntree = &cacheFormes[nbFormes];
+
+    pEntree->Forme = forme;
+    pEntree->Longueur = longueur;
+    pEntree->pValeurs = &cachePoints[nbPointsUtilises];
+    pEntree->Pret = false;
+    nbFormes++;
+    nbPointsUtilises += longueur;
+    return pEntree;
+}
+
+// Vidage complet, la construction en cours est abandonne
+static void SIGNAL_VideCache(void) {
+    nbFormes = 0;
+    nbPointsUtilises = 0;
+#ifdef SIGNAL_BL_ENABLE
+    construction.pEntree = NULL;
+#endif
+}
+
+//----------------------------------------------------------------------------
+//  SIGNAL_CalculeSinus
+//  sin(2 pi n / N) * SIGNAL_CRETE arrondi : un point sur
+//  GENSIG_LONGUEUR_MAX / N du quart de sinus de SIGNAL_Init, le reste par
+//  symtrie. N tant une puissance de 2, n / N = (n * pas) / longueur max
+//  exactement : les valeurs sont celles d'un calcul direct.
+//----------------------------------------------------------------------------
+
+static void SIGNAL_CalculeSinus(int16_t *pValeurs, uint16_t longueur) {
+    uint16_t n;
+    uint16_t pas = GENSIG_LONGUEUR_MAX / longueur;
+    int16_t entier;
+
+    for (n = 0; n <= (longueur / 4); n++) {
+        entier = sinusQuart[n * pas];
+        pValeurs[n] = entier;
+        pValeurs[(longueur / 2) - n] = entier;
+        pValeurs[(longueur / 2) + n] = (int16_t) -entier;
+        if (n > 0) {
+            pValeurs[longueur - n] = (int16_t) -entier;
+        }
+    }
+}
+
+#ifdef SIGNAL_BL_ENABLE
+//----------------------------------------------------------------------------
+//  SIGNAL_Sinus
+//  sin(2 pi i / GENSIG_LONGUEUR_MAX) * SIGNAL_CRETE, i pris modulo la
+//  longueur max, lu dans le quart de sinus
+//----------------------------------------------------------------------------
+
+static inline int32_t SIGNAL_Sinus(uint32_t i) {
+    uint32_t quart = GENSIG_LONGUEUR_MAX / 4;
+    uint32_t j = i & ((GENSIG_LONGUEUR_MAX / 2) - 1);
+    int32_t valeur = sinusQuart[(j <= quart) ? j : ((2 * quart) - j)];
+
+    return (i & (GENSIG_LONGUEUR_MAX / 2)) ? -valeur : valeur;
+}
+
+//----------------------------------------------------------------------------
+//  SIGNAL_AjouteHarmonique
+//  Somme des harmoniques impaires sous Nyquist d'une priode de m points :
+//    O(n) = somme sur k impair < m/2 de sin(2 pi k n / m) / k
+//  pour n = 1 .. m/4 dans sommesHarmoniques[n] (Q30), une harmonique k par
+//  appel. Les autres points s'en dduisent : O(m/2 - n) = O(n),
+//  O(m/2 + n) = O(m - n) = -O(n), O(0) = O(m/2) = 0.
+//  Cot : m / 4 multiplications 32 x 32 bits par harmonique.
+//----------------------------------------------------------------------------
+
+static void SIGNAL_AjouteHarmonique(uint16_t m, uint16_t k) {
+    uint16_t n;
+    uint32_t pas = (uint32_t) k * (GENSIG_LONGUEUR_MAX / m);
+    // 1 / k en Q30, sinus en Q14 : terme en Q30
+    int32_t inverse = (int32_t) (0x40000000u / k);
+
+    for (n = 1; n <= (m / 4); n++) {
+        sommesHarmoniques[n] += (int32_t)
+                (((int64_t) SIGNAL_Sinus(n * pas) * inverse) >> 14);
+    }
+}
+
+static void SIGNAL_RazHarmoniques(uint16_t m) {
+    uint16_t n;
+
+    for (n = 1; n <= (m / 4); n++) {
+        sommesHarmoniques[n] = 0;
+    }
+}
+
+//----------------------------------------------------------------------------
+//  SIGNAL_Demarre
+//  Dbut de la construction d'un carr ou d'une dent de scie dans
+//  pEntree (rserve), remplace une construction en cours
+//
+//  Carr  bande limite : 4 / pi * O(n), O calcul sur toute la longueur.
+//
+//  Dent de scie  bande limite : -2 / pi * S(n) avec
+//    S(n) = somme sur k < N/2 de sin(2 pi k n / N) / k
+//  Les harmoniques paires de N sont les harmoniques de N/2 au double de
+//  l'angle : S_N(n) = O_N(n) + S_N/2(n mod N/2) / 2. S est construite en
+//  place en doublant la priode  chaque passage (Q14), puis convertie.
+//----------------------------------------------------------------------------
+
+static void SIGNAL_Demarre(S_FormeCache *pEntree) {
+    construction.pEntree = pEntree;
+    if (pEntree->Forme == SignalCarre) {
+        construction.Periode = pEntree->Longueur;
+        construction.Harmonique = 1;
+        construction.Etape = SIGNAL_ETAPE_HARMONIQUE;
+        SIGNAL_RazHarmoniques(pEntree->Longueur);
+    } else {
+        // Priode de 2 points : aucune harmonique sous Nyquist
+        pEntree->pValeurs[0] = 0;
+        pEntree->pValeurs[1] = 0;
+        construction.Periode = 4;
+        construction.Etape = SIGNAL_ETAPE_REPORT;
+    }
+}
+
+//----------------------------------------------------------------------------
+//  SIGNAL_Avance
+//  Une tape de la construction en cours : au plus GENSIG_LONGUEUR_MAX / 4
+//  multiplications ou GENSIG_LONGUEUR_MAX copies. Retourne true s'il reste
+//  des tapes, false si la forme est prte ou si rien n'est en cours.
+//----------------------------------------------------------------------------
+
+bool SIGNAL_Avance(void) {
+    S_FormeCache *pEntree = construction.pEntree;
+    int16_t *pValeurs;
+    uint16_t longueur;
+    uint16_t m = construction.Periode;
+    uint16_t n;
+    int32_t valeur;
+
+    if (pEntree == NULL) {
+        return false;
+    }
+    pValeurs = pEntree->pValeurs;
+    longueur = pEntree->Longueur;
+
+    switch (construction.Etape) {
+        case SIGNAL_ETAPE_REPORT:
+            // Report de S_m/2 sur m points,  demi-poids (du haut vers le
+            // bas, la moiti basse est lue avant d'tre rcrite)
+            for (n = m; n > 0; n--) {
+                pValeurs[n - 1] = (int16_t) (pValeurs[(n - 1) & ((m / 2) - 1)] / 2);
+            }
+            SIGNAL_RazHarmoniques(m);
+            construction.Harmonique = 1;
+            construction.Etape = SIGNAL_ETAPE_HARMONIQUE;
+            break;
+
+        case SIGNAL_ETAPE_HARMONIQUE:
+            SIGNAL_AjouteHarmonique(m, construction.Harmonique);
+            construction.Harmonique += 2;
+            if (construction.Harmonique >= (m / 2)) {
+                construction.Etape = (pEntree->Forme == SignalCarre) ?
+                        SIGNAL_ETAPE_CONVERSION : SIGNAL_ETAPE_AJOUT;
+            }
+            break;
+
+        case SIGNAL_ETAPE_AJOUT:
+            // Ajout des harmoniques impaires de m  S (Q30 -> Q14)
+            for (n = 1; n <= (m / 4); n++) {
+                valeur = sommesHarmoniques[n] >> 16;
+                pValeurs[n] += valeur;
+                pValeurs[m - n] -= valeur;
+                if (n < (m / 4)) {
+                    pValeurs[(m / 2) - n] += valeur;
+                    pValeurs[(m / 2) + n] -= valeur;
+                }
+            }
+            if (m < longueur) {
+                construction.Periode = 2 * m;
+                construction.Etape = SIGNAL_ETAPE_REPORT;
+            } else {
+                construction.Etape = SIGNAL_ETAPE_CONVERSION;
+            }
+            break;
+
+        default:
+            if (pEntree->Forme == SignalCarre) {
+                pValeurs[0] = 0;
+                pValeurs[longueur / 2] = 0;
+                for (n = 1; n <= (longueur / 4); n++) {
+                    // Q30 * Q15 -> Q14 (SIGNAL_CRETE)
+                    valeur = (int32_t) (((int64_t) sommesHarmoniques[n] * SIGNAL_4_SUR_PI) >> 31);
+                    pValeurs[n] = (int16_t) valeur;
+                    pValeurs[(longueur / 2) - n] = (int16_t) valeur;
+                    pValeurs[(longueur / 2) + n] = (int16_t) -valeur;
+                    pValeurs[longueur - n] = (int16_t) -valeur;
+                }
+            } else {
+                // S en Q14 -> -2 / pi * S * SIGNAL_CRETE
+                for (n = 0; n < longueur; n++) {
+                    pValeurs[n] = (int16_t) -(((int32_t) pValeurs[n] * SIGNAL_4_SUR_PI) >> 16);
+                }
+            }
+            pEntree->Pret = true;
+            construction.pEntree = NULL;
+            return false;
+    }
+    return true;
+}
+#else
+
+bool SIGNAL_Avance(void) {
+    return false;
+}
+#endif
+
+//----------------------------------------------------------------------------
+//  SIGNAL_FormePrete
+//  Forme normalise (-SIGNAL_CRETE..SIGNAL_CRETE) pour la longueur donne,
+//  reprise du cache ou calcule. Le carr et la dent de scie  bande
+//  limite ne sont pas calculs ici : leur construction est lance (ou
+//  laisse en cours si c'est dj la leur) et retourne false, la forme
+//  est prte quand SIGNAL_Avance a retourn false.
+//
+//  Formes normalises pour n = 0 .. N - 1 (N = longueur) :
+//    sinus      sin(2 pi n / N) * SIGNAL_CRETE arrondi
+//    triangle   4 * SIGNAL_CRETE * (n - N/4) / N       pour n < N/2
+//               4 * SIGNAL_CRETE * (3N/4 - n) / N      pour n >= N/2
+//               (minimum -SIGNAL_CRETE en n = 0, maximum en n = N/2)
+//    dent       srie de Fourier de la rampe -SIGNAL_CRETE..SIGNAL_CRETE
+//               limite aux harmoniques k < N/2 (SIGNAL_BL_ENABLE),
+//               sinon 2 * SIGNAL_CRETE * (n - N/2) / N
+//    carr      srie de Fourier limite aux harmoniques k < N/2
+//               (SIGNAL_BL_ENABLE), sinon +SIGNAL_CRETE pour n < N/2,
+//               -SIGNAL_CRETE ensuite
+//
+//  Jou  F * N chantillons par seconde, un carr ou une dent nafs
+//  contiennent toutes les harmoniques de F : celles au-del de F * N / 2
+//  se replient dans la bande. Les sries limites n'ont aucune harmonique
+//  replie ; en contrepartie elles valent 0 sur les fronts et dpassent
+//  la crte de 18 % (phnomne de Gibbs), ce dpassement est crt 
+//  pleine amplitude.
+//
+//  N tant une puissance de 2 (au moins 64), N/2 et N/4 sont exacts.
+//----------------------------------------------------------------------------
+
+bool SIGNAL_FormePrete(E_FormesSignal forme, uint16_t longueur) {
+    S_FormeCache *pEntree;
+    int16_t *pValeurs;
+    int32_t n32 = longueur;
+    int32_t n;
+
+    if (SIGNAL_Cherche(forme, longueur) != NULL) {
+        return true;
+    }
+#ifdef SIGNAL_BL_ENABLE
+    if ((construction.pEntree != NULL) && (construction.pEntree->Forme == forme)
+            && (construction.pEntree->Longueur == longueur)) {
+        return false;
+    }
+#endif
+    if (!SIGNAL_Place(longueur, 1)) {
+        SIGNAL_VideCache();
+    }
+    pEntree = SIGNAL_Reserve(forme, longueur);
+    pValeurs = pEntree->pValeurs;
+
+    switch (forme) {
+        case SignalSinus:
+            SIGNAL_CalculeSinus(pValeurs, longueur);
+            break;
+
+        case SignalTriangle:
+            // Monte sur la premire moiti, descente sur la seconde
+            for (n = 0; n < n32; n++) {
+                if (n < (n32 / 2)) {
+                    pValeurs[n] = (int16_t) ((4 * SIGNAL_CRETE * (n - (n32 / 4))) / n32);
+                } else {
+                    pValeurs[n] = (int16_t) ((4 * SIGNAL_CRETE * ((3 * n32 / 4) - n)) / n32);
+                }
+            }
+            break;
+
+#ifdef SIGNAL_BL_ENABLE
+        case SignalDentDeScie:
+        case SignalCarre:
+            SIGNAL_Demarre(pEntree);
+            return false;
+#else
+        case SignalDentDeScie:
+            // Valeur linaire sur longueur points
+            for (n = 0; n < n32; n++) {
+                pValeurs[n] = (int16_t) ((2 * SIGNAL_CRETE * (n - (n32 / 2))) / n32);
+            }
+            break;
+
+        case SignalCarre:
+            // Hauteur max sur la premire moiti, hauteur min sur la seconde
+            for (n = 0; n < n32; n++) {
+                pValeurs[n] = (n < (n32 / 2)) ? SIGNAL_CRETE : -SIGNAL_CRETE;
+            }
+            break;
+#endif
+
+        default:
+            // Forme sans table (bruit, PRBS) : milieu seul
+            for (n = 0; n < n32; n++) {
+                pValeurs[n] = 0;
+            }
+            break;
+    }
+    pEntree->Pret = true;
+    return true;
+}
+
+//----------------------------------------------------------------------------
+//  SIGNAL_Normalisee
+//  Forme normalise prte, construction ventuelle mene  son terme
+//----------------------------------------------------------------------------
+
+static const int16_t *SIGNAL_Normalisee(E_FormesSignal forme, uint16_t longueur) {
+    if (!SIGNAL_FormePrete(forme, longueur)) {
+        while (SIGNAL_Avance()) {
+        }
+    }
+    return SIGNAL_Cherche(forme, longueur);
+}
+
+//----------------------------------------------------------------------------
+//  SIGNAL_CalculeTable
+//  Application de l'amplitude et de l'offset  la forme normalise,
+//  crtage puis mise  l'chelle du DAC
+//
+//  valeurBrute = (MOITIE_AMPLITUDE - Offset / 2) * SIGNAL_ECHELLE
+//                + forme(n) * Amplitude
+//  (en mV * SIGNAL_ECHELLE ; l'offset est divis par 2 et de signe
+//  invers dans la table)
+//
+//  La valeur est calcule directement en pas du DAC, avec le milieu et
+//  le gain en Q14 de SIGNAL_CalculeEchelle (mme relation que les formes
+//  sans table), un seul arrondi final :
+//    code = (milieu + forme(n) * gain + 2^13) / 2^14
+//  Somme au plus 2^30 + 1.2 * SIGNAL_CRETE * 32768 < 2^31 (milieu et
+//  gain saturs par SIGNAL_CalculeEchelle) : calcul en 32 bits. L'cart avec un arrondi direct de valeurBrute est d'au plus
+//  un pas (gain arrondi  2^-14 pas prs).
+//
+//  Ecrtage : si |Offset| / 2 + Amplitude / 2 dpasse MOITIE_AMPLITUDE,
+//  la partie de la forme hors de 0..VAL_MAX_PAS est aplatie sur la
+//  borne (pas d'erreur signale, la forme est simplement tronque). Par
+//  exemple Amplitude = 10000 et Offset = +1000 donnent une table de
+//  -500  9500, aplatie  0 sur les chantillons les plus bas.
+//----------------------------------------------------------------------------
+
+void SIGNAL_CalculeTable(const S_ParamGen *pParam, uint16_t *pTable, uint16_t longueur) {
+    uint16_t nbEchantillon = 0;
+    int32_t milieu;
+    int32_t gain;
+    const int16_t *pForme = SIGNAL_Normalisee(pParam->Forme, longueur);
+
+    // Mise  l'chelle calcule une fois par table
+    SIGNAL_CalculeEchelle(pParam, &milieu, &gain);
+
+    // Parcours de tous les chantillons
+    for (nbEchantillon = 0; nbEchantillon < longueur; nbEchantillon++) {
+        int32_t code = (milieu + ((int32_t) pForme[nbEchantillon] * gain)
+                + (1 << 13)) >> 14;
+
+        // crtage : borne la valeur entre 0 et VAL_MAX_PAS
+        if (code > VAL_MAX_PAS) {
+            code = VAL_MAX_PAS;
+        } else if (code < 0) {
+            code = 0;
+        }
+        pTable[nbEchantillon] = (uint16_t) code;
+    }
+}
+
+//----------------------------------------------------------------------------
+//  SIGNAL_CalculeEchelle
+//  Milieu en pas du DAC et gain en pas du DAC par unit Q14, tous deux au
+//  format Q14 (2^14 = un pas). Calcul 64 bits une fois par table.
+//
+//  Saturation : milieu born  0..VAL_MAX_PAS (offset de -MAX_AMPLITUDE
+//   +MAX_AMPLITUDE), gain born  celui de MAX_AMPLITUDE. Des
+//  paramtres hors limites (trame TCP, page NVM corrompue) donnent une
+//  table crte, jamais un dbordement du calcul 32 bits par
+//  chantillon (somme borne ci-dessus).
+//----------------------------------------------------------------------------
+
+static int32_t SIGNAL_EnPasQ14(int64_t valeur) {
+    return (int32_t) (((valeur * VAL_MAX_PAS * (1 << 14))
+            + ((MAX_AMPLITUDE * SIGNAL_ECHELLE) / 2)) / (MAX_AMPLITUDE * SIGNAL_ECHELLE));
+}
+
+void SIGNAL_CalculeEchelle(const S_ParamGen *pParam, int32_t *pMilieu, int32_t *pGain) {
+    int64_t milieu = ((int64_t) MOITIE_AMPLITUDE - (pParam->Offset / 2)) * SIGNAL_ECHELLE;
+    int64_t amplitude = pParam->Amplitude;
+
+    if (milieu < 0) {
+        milieu = 0;
+    } else if (milieu > (int64_t) MAX_AMPLITUDE * SIGNAL_ECHELLE) {
+        milieu = (int64_t) MAX_AMPLITUDE * SIGNAL_ECHELLE;
+    }
+    if (amplitude < 0) {
+        amplitude = 0;
+    } else if (amplitude > MAX_AMPLITUDE) {
+        amplitude = MAX_AMPLITUDE;
+    }
+    *pMilieu = SIGNAL_EnPasQ14(milieu);
+    *pGain = SIGNAL_EnPasQ14(amplitude);
+}
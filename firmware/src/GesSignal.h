@@ -0,0 +1,90 @@
+#ifndef GesSignal_h
+#define GesSignal_h
+
+// GesSignal.h
+// Calcul de la table d'chantillons du gnrateur
+//
+// Principe : le calcul des formes (sinus, triangle, dent de scie, carr),
+//            l'application de l'amplitude et de l'offset et l'crtage
+//            sont spars de la gestion du timer et du DAC. Ce module
+//            n'utilise ni Harmony ni les registres du PIC32 : il se
+//            compile tel quel avec un compilateur C du PC pour vrifier
+//            les tables produites.
+//
+//  Fonctions  disposition :
+//       SIGNAL_Init          quart de sinus de rfrence (au dmarrage)
+//       SIGNAL_Longueur      longueur de table pour une frquence et une
+//                            frquence d'chantillonnage maximale
+//       SIGNAL_FormePrete    true si la forme normalise est prte, sinon
+//                            lance sa construction par tapes
+//       SIGNAL_Avance        une tape de la construction en cours
+//       SIGNAL_CalculeTable  remplit une table de longueur chantillons
+//                            (0..VAL_MAX_PAS)  partir des paramtres
+//       SIGNAL_CalculeEchelle  milieu et gain pour les formes sans table
+//                            (bruit, PRBS), calcules  chaque chantillon
+//
+//  Les formes normalises (avant amplitude et offset) sont gardes en
+//  cache par forme et longueur : un changement d'amplitude, d'offset ou
+//  un retour  une bande de frquence dj utilise ne les recalcule pas.
+//  Le carr et la dent de scie sont synthtiss  bande limite (somme
+//  des harmoniques sous la frquence de Nyquist de leur longueur). Ce
+//  calcul prend jusqu' 10^6 multiplications pour 4096 points : il est
+//  dcoup en tapes (SIGNAL_Avance) que l'appelant rpartit sur
+//  plusieurs tours de boucle, la table active restant en service.
+//
+//---------------------------------------------------------------------------
+
+// *****************************************************************************
+// Section: Type Definitions
+// *****************************************************************************
+#include <stdbool.h>
+#include <stdint.h>
+#include "DefMenuGen.h"
+
+// Valeur crte des formes normalises : chaque forme est calcule en
+// entiers entre -SIGNAL_CRETE et +SIGNAL_CRETE (format Q14), puis
+// multiplie par l'amplitude en mV. Crte-crte = Amplitude. Le format
+// laisse une marge pour le dpassement des formes  bande limite
+// (phnomne de Gibbs, +18 % sur la dent de scie).
+#define SIGNAL_CRETE 16384
+
+// Forme sans table, calcule  chaque chantillon (GesBruit)
+#define SIGNAL_EST_BRUIT(forme) ((forme) >= SignalBruitBlanc)
+
+// Carr et dent de scie  bande limite (commenter pour les formes
+// naves, sans calcul d'harmoniques)
+#define SIGNAL_BL_ENABLE
+
+// Taille du cache des formes normalises en points (2 octets par point) :
+// au moins GENSIG_LONGUEUR_MAX, le double garde une forme en construction
+// avec la prcdente
+#define SIGNAL_CACHE_POINTS (2 * GENSIG_LONGUEUR_MAX)
+// Nombre maximum de formes dans le cache
+#define SIGNAL_CACHE_NB 8
+
+// Quart de sinus de rfrence (sinf),  appeler une fois au dmarrage
+// avant tout calcul de table
+void SIGNAL_Init(void);
+
+// Longueur de table (puissance de 2) pour la frquence en Hz, sans
+// dpasser fechMax chantillons par seconde (sauf  GENSIG_LONGUEUR_MIN)
+uint16_t SIGNAL_Longueur(int16_t frequence, uint32_t fechMax);
+
+// true si la forme normalise est prte ; sinon sa construction est lance
+// (ou poursuivie si elle est dj en cours) et la fonction retourne false
+bool SIGNAL_FormePrete(E_FormesSignal forme, uint16_t longueur);
+
+// Une tape de la construction en cours (au plus GENSIG_LONGUEUR_MAX / 4
+// multiplications), true s'il reste des tapes
+bool SIGNAL_Avance(void);
+
+// Calcul des longueur chantillons du signal dcrit par pParam (une
+// construction en cours pour cette forme est mene  son terme)
+void SIGNAL_CalculeTable(const S_ParamGen *pParam, uint16_t *pTable, uint16_t longueur);
+
+// Mise  l'chelle d'une valeur Q14 calcule  la vole, mme relation
+// que la table : code DAC = (milieu + valeur * gain) / 2^14 arrondi, born
+//  0..VAL_MAX_PAS par l'appelant
+void SIGNAL_CalculeEchelle(const S_ParamGen *pParam, int32_t *pMilieu, int32_t *pGain);
+
+#endif
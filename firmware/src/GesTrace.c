@@ -0,0 +1,127 @@
+// GesTrace.c
+// Trace binaire des interruptions et des tches en RAM
+//
+// Le vidage envoie TRACE_PAR_LIGNE vnements par appel de TRACE_Tasks
+// (une ligne de 70 caractres) : la console USB et le tampon d'impression
+// de SYS_CMD (SYS_CMD_PRINT_BUFFER_SIZE) ne sont jamais dbords. La
+// trace reprend  la fin du vidage.
+//
+//---------------------------------------------------------------------------
+
+#include <stdio.h>
+#include "GesTrace.h"
+#include "GesMesure.h"
+#include "system_definitions.h"
+
+// Evnements par ligne envoye
+#define TRACE_PAR_LIGNE 4
+// Evnements pour la calibration
+#define TRACE_NB_CALIBRATION 32
+
+// Tampon de trace
+S_Trace Trace = {.Masque = TRACE_MASQUE_DEFAUT, .Actif = true};
+
+// Etat du vidage
+static bool videEnCours = false;
+static bool enteteEnvoyee = false;
+static uint16_t indexVidage;
+static uint16_t resteVidage;
+
+//----------------------------------------------------------------------------
+//  TRACE_Calibre
+//  Dure moyenne d'un TRACE_Ecrit enregistr (le cas le plus long)
+//----------------------------------------------------------------------------
+
+void TRACE_Calibre(void) {
+#ifdef TRACE_ENABLE
+    uint32_t masque = Trace.Masque;
+    uint32_t debut;
+    uint8_t i;
+
+    Trace.Masque = (1u << TRACE_MARQUE);
+    debut = MESURE_Lire();
+    for (i = 0; i < TRACE_NB_CALIBRATION; i++) {
+        TRACE_Ecrit(TRACE_MARQUE, i);
+    }
+    Trace.Cout = (MESURE_Lire() - debut) / TRACE_NB_CALIBRATION;
+    Trace.Masque = masque;
+    TRACE_Raz();
+#endif
+}
+
+void TRACE_Masque(uint32_t masque) {
+    Trace.Masque = masque;
+}
+
+void TRACE_Raz(void) {
+    bool etatInt = SYS_INT_Disable();
+
+    Trace.Index = 0;
+    Trace.Nb = 0;
+    SYS_INT_Restore(etatInt);
+}
+
+//----------------------------------------------------------------------------
+//  TRACE_Vide
+//  Fige la trace : le plus ancien vnement est  Index si le tampon a
+//  dj fait le tour, sinon  0
+//----------------------------------------------------------------------------
+
+void TRACE_Vide(void) {
+    if (videEnCours) {
+        return;
+    }
+    Trace.Actif = false;
+    if (Trace.Nb >= TRACE_TAILLE) {
+        indexVidage = Trace.Index;
+        resteVidage = TRACE_TAILLE;
+    } else {
+        indexVidage = 0;
+        resteVidage = (uint16_t) Trace.Nb;
+    }
+    enteteEnvoyee = false;
+    videEnCours = true;
+}
+
+//----------------------------------------------------------------------------
+//  TRACE_Tasks
+//  Envoie l'en-tte, puis une ligne par appel, puis FIN
+//----------------------------------------------------------------------------
+
+bool TRACE_Tasks(void) {
+    char ligne[2 + (TRACE_PAR_LIGNE * 16) + 3];
+    S_TraceEvenement *pEvt;
+    uint16_t longueur;
+    uint8_t i;
+
+    if (!videEnCours) {
+        return false;
+    }
+
+    if (!enteteEnvoyee) {
+        SYS_CONSOLE_PRINT("TRACE n=%u f=%lu cout=%lu\r\n", (unsigned) resteVidage,
+                (unsigned long) MESURE_FREQ_CORE_TIMER, (unsigned long) Trace.Cout);
+        enteteEnvoyee = true;
+        return true;
+    }
+
+    if (resteVidage == 0) {
+        SYS_CONSOLE_MESSAGE("FIN\r\n");
+        videEnCours = false;
+        Trace.Actif = true;
+        return true;
+    }
+
+    ligne[0] = 'T';
+    ligne[1] = ' ';
+    longueur = 2;
+    for (i = 0; (i < TRACE_PAR_LIGNE) && (resteVidage > 0); i++) {
+        pEvt = &Trace.Evenements[indexVidage];
+        longueur += snprintf(&ligne[longueur], sizeof (ligne) - longueur, "%08lx%04x%04x",
+                (unsigned long) pEvt->Horodatage, pEvt->Id, pEvt->Arg);
+        indexVidage = (indexVidage + 1) & (TRACE_TAILLE - 1);
+        resteVidage--;
+    }
+    SYS_CONSOLE_PRINT("%s\r\n", ligne);
+    return true;
+}
@@ -0,0 +1,128 @@
+#ifndef GesTrace_h
+#define GesTrace_h
+
+// GesTrace.h
+// Trace binaire des interruptions et des tches en RAM
+//
+// Principe : TRACE_Ecrit(id, arg) range un vnement {horodatage core
+//            timer, id, argument} dans un tampon circulaire, en quelques
+//            instructions et sans formatage : la trace ne modifie presque
+//            pas le comportement temporel observ. Le tampon contient les
+//            TRACE_TAILLE derniers vnements. Utilisable depuis toutes
+//            les interruptions et la boucle principale (la rservation
+//            d'une case se fait interruptions bloques).
+//
+//            Chaque id peut tre masqu (TRACE_Masque) : l'interruption
+//            Timer3, trs frquente, est masque au dmarrage.
+//
+//            Le vidage (commande console "trace dump") fige la trace puis
+//            la tche TRACE_Tasks l'envoie par morceaux sur la console :
+//              TRACE n=<nombre> f=<Hz du core timer> cout=<pas/vnement>
+//              T <vnement><vnement><vnement><vnement>
+//              ...
+//              FIN
+//            Chaque vnement fait 16 chiffres hexadcimaux : horodatage
+//            (8), id (4), argument (4), du plus ancien au plus rcent.
+//            L'horodatage reboucle toutes les 107 s.
+//
+//  Fonctions  disposition :
+//       TRACE_Ecrit       enregistrement d'un vnement (inline)
+//       TRACE_Calibre     mesure du cot d'un vnement
+//       TRACE_Masque      choix des id enregistrs
+//       TRACE_Raz         vidage du tampon
+//       TRACE_Vide        demande d'envoi du tampon sur la console
+//       TRACE_Tasks       envoi par morceaux (tche de l'ordonnanceur)
+//
+//---------------------------------------------------------------------------
+
+// *****************************************************************************
+// Section: Type Definitions
+// *****************************************************************************
+#include <stdbool.h>
+#include <stdint.h>
+#include <xc.h>
+
+// Trace compile (commenter pour la retirer, TRACE_Ecrit devient vide)
+#define TRACE_ENABLE
+
+// Nombre d'vnements conservs (puissance de 2), 8 octets par vnement
+#define TRACE_TAILLE 512
+
+// Identifiants des vnements
+typedef enum {
+    TRACE_MARQUE = 0,       // marque libre (arg au choix)
+    TRACE_ISR_T3,           // entre interruption Timer3
+    TRACE_ISR_T1,           // entre interruption Timer1 (arg : entres)
+    TRACE_ISR_ETH,          // entre interruption Ethernet
+    TRACE_TRAME,            // trame TCP reue (arg : longueur)
+    TRACE_TABLE,            // table du gnrateur recalcule (arg : forme)
+    TRACE_TACHE_DEBUT,      // dbut d'une tche (arg : index)
+    TRACE_TACHE_FIN,        // fin d'une tche (arg : index)
+    TRACE_ATTENTE,          // CPU en mode Idle
+    TRACE_REVEIL,           // sortie du mode Idle
+    TRACE_DECLENCHEMENT     // front de dclenchement (arg : capture TMR3)
+} E_TraceId;
+
+// Masque au dmarrage : tout sauf Timer3
+#define TRACE_MASQUE_DEFAUT (~(1u << TRACE_ISR_T3))
+
+// Evnement
+typedef struct {
+    uint32_t Horodatage;    // core timer
+    uint16_t Id;
+    uint16_t Arg;
+} S_TraceEvenement;
+
+// Tampon de trace
+typedef struct {
+    S_TraceEvenement Evenements[TRACE_TAILLE];
+    volatile uint16_t Index;        // prochaine case
+    volatile uint32_t Nb;           // vnements enregistrs depuis TRACE_Raz
+    volatile uint32_t Masque;       // bit n : id n enregistr
+    volatile bool Actif;            // false pendant le vidage
+    uint32_t Cout;                  // pas du core timer par vnement
+} S_Trace;
+
+extern S_Trace Trace;
+
+//----------------------------------------------------------------------------
+//  TRACE_Ecrit
+//  Rserve une case et l'horodate interruptions bloques, puis crit l'id
+//  et l'argument. Une interruption qui crit entre-temps prend la case
+//  suivante.
+//----------------------------------------------------------------------------
+
+static inline void TRACE_Ecrit(E_TraceId id, uint16_t arg) {
+#ifdef TRACE_ENABLE
+    S_TraceEvenement *pEvt;
+    uint32_t etatInt;
+
+    if (!Trace.Actif || ((Trace.Masque & (1u << id)) == 0)) {
+        return;
+    }
+    etatInt = __builtin_disable_interrupts();
+    pEvt = &Trace.Evenements[Trace.Index];
+    Trace.Index = (Trace.Index + 1) & (TRACE_TAILLE - 1);
+    Trace.Nb++;
+    pEvt->Horodatage = _CP0_GET_COUNT();
+    if (etatInt & 1) {
+        __builtin_enable_interrupts();
+    }
+    pEvt->Id = id;
+    pEvt->Arg = arg;
+#endif
+}
+
+// Mesure du cot d'un vnement ( l'initialisation), vide le tampon
+void TRACE_Calibre(void);
+
+void TRACE_Masque(uint32_t masque);
+void TRACE_Raz(void);
+
+// Fige la trace et lance son envoi sur la console
+void TRACE_Vide(void);
+
+// Envoi par morceaux, true tant que l'envoi est en cours
+bool TRACE_Tasks(void);
+
+#endif
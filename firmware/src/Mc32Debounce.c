@@ -137,3 +137,66 @@ void DebounceClearPressed  (S_SwitchDescriptor *pDescriptor) {
 void DebounceClearReleased  (S_SwitchDescriptor *pDescriptor) {
    pDescriptor->bits.KeyReleased = 0;
 }
+
+
+/********************************************************************************************/
+// DoDebounceVertical (S_VerticalDebounce *pDescriptor, uint32_t Entrees)
+//              Anti-rebond de toutes les entres d'un mot par compteurs verticaux.
+//
+// Pour chaque bit dont l'entre diffre de l'tat stable, le compteur de
+// 2 bits (Compteur1:Compteur0) avance ; il est remis  zro ds que l'entre
+// revient  l'tat stable. Au 4me chantillon diffrent conscutif, le bit
+// de l'tat stable bascule et l'vnement press / relach est mmoris.
+//
+
+void DoDebounceVertical (S_VerticalDebounce *pDescriptor, uint32_t Entrees)
+{
+   uint32_t Difference;
+   uint32_t Bascule;
+
+   Difference = Entrees ^ pDescriptor->Etat;
+
+   // Avance des compteurs des bits diffrents, remise  zro des autres
+   pDescriptor->Compteur1 = (pDescriptor->Compteur1 ^ pDescriptor->Compteur0) & Difference;
+   pDescriptor->Compteur0 = ~pDescriptor->Compteur0 & Difference;
+
+   // Bits dont le compteur a fait le tour
+   Bascule = Difference & ~(pDescriptor->Compteur0 | pDescriptor->Compteur1);
+
+   pDescriptor->Etat ^= Bascule;
+   pDescriptor->Presse |= Bascule & ~pDescriptor->Etat;
+   pDescriptor->Relache |= Bascule & pDescriptor->Etat;
+} // end DoDebounceVertical
+
+void VDebounceInit (S_VerticalDebounce *pDescriptor) {
+   pDescriptor->Compteur0 = 0;
+   pDescriptor->Compteur1 = 0;
+   pDescriptor->Etat      = UINT32_MAX;
+   pDescriptor->Presse    = 0;
+   pDescriptor->Relache   = 0;
+}
+
+//  VDebounceGetInput  fourni l'tat de l'entre aprs anti-rebond
+bool VDebounceGetInput (S_VerticalDebounce *pDescriptor, uint32_t Masque) {
+   return ((pDescriptor->Etat & Masque) != 0);
+}
+
+//  VDebounceIsPressed    true indique que l'on vient de presser la touche
+bool VDebounceIsPressed (S_VerticalDebounce *pDescriptor, uint32_t Masque) {
+   return ((pDescriptor->Presse & Masque) != 0);
+}
+
+//  VDebounceIsReleased   true indique que l'on vient de relacher la touche
+bool VDebounceIsReleased (S_VerticalDebounce *pDescriptor, uint32_t Masque) {
+   return ((pDescriptor->Relache & Masque) != 0);
+}
+
+//  VDebounceClearPressed    annule indication de pression sur la touche
+void VDebounceClearPressed  (S_VerticalDebounce *pDescriptor, uint32_t Masque) {
+   pDescriptor->Presse &= ~Masque;
+}
+
+//  VDebounceClearReleased   annule indication de relachement de la touche
+void VDebounceClearReleased  (S_VerticalDebounce *pDescriptor, uint32_t Masque) {
+   pDescriptor->Relache &= ~Masque;
+}
@@ -103,4 +103,48 @@ void DebounceClearPressed  (S_SwitchDescriptor *pDescriptor);
 //  DebounceClearReleased   annule indication de relachement de la touche
 void DebounceClearReleased  (S_SwitchDescriptor *pDescriptor);
 
+
+/********************************************************************************************/
+// Anti-rebond vertical (compteurs verticaux)
+//
+// Principe : jusqu' 32 entres sont traites en parallle, une entre par
+//            bit d'un mot. Chaque bit possde un compteur de 2 bits rparti
+//            sur deux mots (Compteur0 / Compteur1). Une entre change d'tat
+//            aprs 4 chantillons conscutifs diffrents de l'tat stable.
+//            Un appel de DoDebounceVertical remplace un appel de DoDebounce
+//            par switch, sans branchement.
+//
+//  Les fonctions VDebounceXxx reprennent l'API du descripteur simple,
+//  l'entre tant dsigne par son masque de bit.
+//  Un tat 0 indique une touche presse.
+
+typedef struct {
+   uint32_t Compteur0;      // bit 0 des compteurs verticaux
+   uint32_t Compteur1;      // bit 1 des compteurs verticaux
+   uint32_t Etat;           // valeur finale (image) des entres
+   uint32_t Presse;         // vnements touche presse
+   uint32_t Relache;        // vnements touche relache
+} S_VerticalDebounce;
+
+// DoDebounceVertical : anti-rebond de toutes les entres d'un mot
+void DoDebounceVertical (S_VerticalDebounce *pDescriptor, uint32_t Entrees);
+
+// VDebounceInit : initialisation, toutes les entres relaches (tat 1)
+void VDebounceInit (S_VerticalDebounce *pDescriptor);
+
+//  VDebounceGetInput  fourni l'tat de l'entre aprs anti-rebond
+bool VDebounceGetInput (S_VerticalDebounce *pDescriptor, uint32_t Masque);
+
+//  VDebounceIsPressed    true indique que l'on vient de presser la touche
+bool VDebounceIsPressed (S_VerticalDebounce *pDescriptor, uint32_t Masque);
+
+//  VDebounceIsReleased   true indique que l'on vient de relacher la touche
+bool VDebounceIsReleased (S_VerticalDebounce *pDescriptor, uint32_t Masque);
+
+//  VDebounceClearPressed    annule indication de pression sur la touche
+void VDebounceClearPressed  (S_VerticalDebounce *pDescriptor, uint32_t Masque);
+
+//  VDebounceClearReleased   annule indication de relachement de la touche
+void VDebounceClearReleased  (S_VerticalDebounce *pDescriptor, uint32_t Masque);
+
 #endif
\ No newline at end of file
@@ -15,6 +15,15 @@
 //   SCA 04.04.2022 Config des signaux ctrl (CS et CLR) 
 //                  en sortie au pralable  l'init du DAC
 //                  MPLABX 5.45, xc32 2.50, Harmony 2.06
+//                  Horloge SPI selon la cible (MX : PBCLK, MZ : PBCLK2)
+//                  SPI en mode 32 bits, un mot LTC2604 par criture
+//                  (SPI_WriteMotDac)
+//                  Ecriture sans attente (SPI_DebutMotDac, SPI_FinMotDac)
+//                  Horloge SPI modifiable (reconfiguration seulement si
+//                  elle a chang), modle de temps du DAC
+//                  Mise  jour simultane de plusieurs canaux
+//                  (SPI_WriteCanauxDac, SPI_DebutCanauxDac)
+//                  Modle de temps dplac dans GesDac (compilable PC)
 /*--------------------------------------------------------*/
 
 
@@ -27,6 +36,23 @@
 // SPI_ID_1 correspond au SPI1 !
 #define KitSpi1 (SPI_ID_1)
 
+// Horloge du SPI et frquence SCK selon la cible.
+// LTC2604 : SCK max 50 MHz. MX : PBCLK 80 MHz -> 20 MHz (BRG = 1),
+// MZ : PBCLK2 100 MHz -> 25 MHz (BRG = 1)
+#if defined(__PIC32MZ__)
+#define DAC_BUS_SPI CLK_BUS_PERIPHERAL_2
+#define DAC_FREQ_SPI 25000000
+#else
+#define DAC_BUS_SPI CLK_BUS_PERIPHERAL_1
+#define DAC_FREQ_SPI 20000000
+#endif
+
+// Trame dpose dans le FIFO, CS pas encore remont
+static volatile bool dacTrameEnCours = false;
+// SCK choisie et reconfiguration en attente
+static volatile uint32_t frequenceSpi = DAC_FREQ_SPI;
+static volatile bool spiAReconfigurer = false;
+
 uint32_t ConfigReg;     // pour lecture de SPI1CON
 uint32_t BaudReg;       // pour lecture de SPI1BRG
 
@@ -52,9 +78,10 @@ void SPI_ConfigureLTC2604(void)
    PLIB_SPI_BufferClear(KitSpi1);
    PLIB_SPI_StopInIdleDisable(KitSpi1);
    PLIB_SPI_PinEnable(KitSpi1, SPI_PIN_DATA_OUT);
-   PLIB_SPI_CommunicationWidthSelect(KitSpi1, SPI_COMMUNICATION_WIDTH_8BITS);
-   // Config SPI clock  20 MHz 
-   PLIB_SPI_BaudRateSet(KitSpi1, SYS_CLK_PeripheralFrequencyGet(CLK_BUS_PERIPHERAL_1), 20000000);
+   // Mot de 32 bits : le LTC2604 ignore les 8 premiers bits
+   PLIB_SPI_CommunicationWidthSelect(KitSpi1, SPI_COMMUNICATION_WIDTH_32BITS);
+   // Config SPI clock (DAC_FREQ_SPI au dpart, 20 MHz sur MX)
+   PLIB_SPI_BaudRateSet(KitSpi1, SYS_CLK_PeripheralFrequencyGet(DAC_BUS_SPI), frequenceSpi);
    // Config polarit traitement des signaux SPI
    // pour input  confirmer
    // Polarit clock OK
@@ -71,6 +98,45 @@ void SPI_ConfigureLTC2604(void)
    // Contrle le la configuration
    ConfigReg = SPI1CON;
    BaudReg = SPI1BRG;
+   spiAReconfigurer = false;
+}
+
+// SCK obtenue pour une demande avec l'horloge du SPI de la cible
+uint32_t SPI_SckPossible(uint32_t Frequence)
+{
+   return DAC_SckPossible(SYS_CLK_PeripheralFrequencyGet(DAC_BUS_SPI), Frequence);
+}
+
+// Changement d'horloge SPI, appliqu  la prochaine trame
+bool SPI_ChoisitFrequenceDac(uint32_t Frequence)
+{
+   uint32_t sck = SPI_SckPossible(Frequence);
+
+   if (sck == 0)
+   {
+      return false;
+   }
+   if (sck != frequenceSpi)
+   {
+      frequenceSpi = sck;
+      spiAReconfigurer = true;
+   }
+   return true;
+}
+
+// Reconfiguration du SPI si l'horloge a chang (entre deux trames)
+void SPI_AppliqueFrequenceDac(void)
+{
+   if (spiAReconfigurer)
+   {
+      SPI_FinMotDac();
+      SPI_ConfigureLTC2604();
+   }
+}
+
+uint32_t SPI_FrequenceDac(void)
+{
+   return frequenceSpi;
 }
 
 // Initialisation des signaux de controle du DAC, reset du DAC, puis config. du periph. SPI
@@ -86,70 +152,109 @@ void SPI_InitLTC2604(void)
    delay_us(500);
    DAC_CLEAR = 1;
 
-   // LTC2604 MAX 50 MHz choix 20 MHz
+   // LTC2604 MAX 50 MHz choix DAC_FREQ_SPI
    SPI_ConfigureLTC2604();
 }
 
-// Envoi d'une valeur sur le DAC  LTC2604
-// Sans reconfiguration du SPI
-// Indication du canal 0  3
-void SPI_WriteToDac(uint8_t NoCh, uint16_t DacVal)
+// Envoi d'un mot de commande complet au DAC LTC2604 (LTC2604_MOT)
+// Une seule criture dans le FIFO du SPI, une seule attente
+void SPI_WriteMotDac(uint32_t Mot)
 {
-   //Dclaration des variables
-   uint8_t MSB;
-   uint8_t LSB;
-   
-   //Slection du canal
-   //3 -> Set and Update, 0/1/2/3 Slection canal A/B/C/D, F tous canaux
-   NoCh = NoCh + 0x30;
-
-   // Selon canal
-   MSB =  DacVal >> 8;
-   LSB =  DacVal;
+   // Trame sans attente en cours : termine d'abord
+   SPI_FinMotDac();
 
    CS_DAC = 0;
-   spi_write1(NoCh);
-   spi_write1(MSB);
-   spi_write1(LSB);
- 
+   PLIB_SPI_BufferWrite32bit(KitSpi1, Mot);
+   while (PLIB_SPI_IsBusy(KitSpi1));
+
    //Fin de transmission
    CS_DAC = 1;
 
+} // SPI_WriteMotDac
+
+// Dbut de trame sans attente : CS bas, mot dans le FIFO, retour immdiat
+// Le dcalage (32 coups d'horloge SPI) se fait pendant la suite du
+// programme, SPI_FinMotDac remonte CS
+void SPI_DebutMotDac(uint32_t Mot)
+{
+   SPI_FinMotDac();
+
+   CS_DAC = 0;
+   PLIB_SPI_BufferWrite32bit(KitSpi1, Mot);
+   dacTrameEnCours = true;
+
+} // SPI_DebutMotDac
+
+// Fin de la trame en cours : le dcalage est normalement termin depuis
+// longtemps (1,6 us  20 MHz pour une priode d'au moins 5 us), l'attente
+// ne sert qu'en cas d'appels rapprochs
+void SPI_FinMotDac(void)
+{
+   if (dacTrameEnCours)
+   {
+      while (PLIB_SPI_IsBusy(KitSpi1));
+      // Front montant de CS : mise  jour de la sortie du DAC
+      CS_DAC = 1;
+      dacTrameEnCours = false;
+   }
+
+} // SPI_FinMotDac
+
+// Envoi d'une valeur sur le DAC  LTC2604
+// Sans reconfiguration du SPI
+// Indication du canal 0  3
+void SPI_WriteToDac(uint8_t NoCh, uint16_t DacVal)
+{
+   SPI_WriteMotDac(LTC2604_MOT(NoCh, DacVal));
+
 } // SPI_WriteToDac
    
 
 // Envoi d'une valeur sur le DAC  LTC2604
-// Avec reconfiguration du SPI
+// Avec reconfiguration du SPI (seulement si l'horloge a chang)
 // Indication du canal 0  3
 void SPI_CfgWriteToDac(uint8_t NoCh, uint16_t DacVal)
 {
-   //Dclaration des variables
-   uint8_t MSB;
-   uint8_t LSB;
+   // Reconfiguration du SPI si l'horloge a chang
+   SPI_AppliqueFrequenceDac();
 
-   // Reconfiguration du SPI
-   SPI_ConfigureLTC2604();
+   SPI_WriteMotDac(LTC2604_MOT(NoCh, DacVal));
 
-   //Slection du canal
-   //3 -> Set and Update, 0/1/2/3 Slection canal A/B/C/D, F tous canaux
-   NoCh = NoCh + 0x30;
+} // SPI_CfgWriteToDac
 
-   // Selon canal
-   MSB =  DacVal >> 8;
-   LSB =  DacVal;
 
-   CS_DAC = 0;
-   spi_write1(NoCh);
-   spi_write1(MSB);
-   spi_write1(LSB);
+ 
 
-   // Fin de transmission
-   CS_DAC = 1;
 
-} // SPI_CfgWriteToDac
+// Ecriture des registres d'entre des canaux 0  NbCanaux - 1, sans
+// mise  jour des sorties. Chaque trame doit se terminer par un front
+// montant de CS : une trame et une attente par canal
+static void SPI_EcritRegistresDac(const uint16_t *pValeurs, uint8_t NbCanaux)
+{
+   uint8_t canal;
 
+   for (canal = 0; canal < NbCanaux; canal++)
+   {
+      SPI_WriteMotDac(LTC2604_MOT_ECRIT(canal, pValeurs[canal]));
+   }
 
- 
+} // SPI_EcritRegistresDac
 
+// Mise  jour simultane de plusieurs canaux, avec attente
+// Cot : DAC_MOTS_PAR_MAJ(NbCanaux) trames (DAC_TempsMotsNs)
+void SPI_WriteCanauxDac(const uint16_t *pValeurs, uint8_t NbCanaux)
+{
+   SPI_EcritRegistresDac(pValeurs, NbCanaux);
+   SPI_WriteMotDac(LTC2604_MOT_MAJ_TOUS);
+
+} // SPI_WriteCanauxDac
 
+// Idem, la trame de mise  jour reste en cours (SPI_FinMotDac)
+// Les registres d'entre sont crits avec attente, seule la dernire
+// trame se dcale pendant la suite du programme
+void SPI_DebutCanauxDac(const uint16_t *pValeurs, uint8_t NbCanaux)
+{
+   SPI_EcritRegistresDac(pValeurs, NbCanaux);
+   SPI_DebutMotDac(LTC2604_MOT_MAJ_TOUS);
 
+} // SPI_DebutCanauxDac
@@ -10,6 +10,10 @@
 //  Modifications :
 //   CHR 06.03.2015  ajout fonction SPI_CfgWriteToDac
 //   CHR 24.05.2016  maj version compilateur et Harmony 
+//                   SPI en mode 32 bits, ajout SPI_WriteMotDac
+//                   Ecriture sans attente SPI_DebutMotDac / SPI_FinMotDac
+//                   Horloge SPI modifiable, modle de temps du DAC
+//                   Mise  jour simultane de plusieurs canaux
 //
 /*--------------------------------------------------------*/
 
@@ -19,12 +23,63 @@
 // *****************************************************************************
 // Section: Type Definitions
 // *****************************************************************************
+#include <stdbool.h>
 #include <stdint.h>
+// Modle de temps (DAC_NB_CANAUX, DAC_MOTS_PAR_MAJ, DAC_TempsMotsNs...)
+#include "GesDac.h"
+
+// Ecriture sans attente dans l'interruption du gnrateur (commenter pour
+// l'criture bloquante) : le mot est dpos dans le FIFO du SPI et CS est
+// remont  l'interruption suivante. Le DAC se met  jour une priode
+// d'chantillonnage plus tard, toujours au mme instant de la priode,
+// et la dure de l'interruption ne dpend plus de l'horloge SPI.
+#define DAC_NON_BLOQUANT
+
+// Mot de commande LTC2604 sur 32 bits : 8 bits ignors, commande 3
+// (criture et mise  jour), adresse 0..3 (canal A..D, F tous canaux),
+// valeur sur 16 bits. Avec un canal constant, la partie haute est
+// calcule  la compilation : il ne reste qu'un OU par chantillon.
+#define LTC2604_CMD_ECRIT_MAJ 0x30
+#define LTC2604_MOT(canal, valeur) \
+    ((((uint32_t) (LTC2604_CMD_ECRIT_MAJ | (canal))) << 16) | (uint16_t) (valeur))
+
+// Mise  jour simultane de plusieurs canaux : commande 0 (criture du
+// registre d'entre seul) pour chaque canal, puis commande 1 (mise  jour)
+//  l'adresse F. Les sorties changent toutes au front montant de CS de
+// la dernire trame, sans dcalage entre canaux.
+#define LTC2604_CMD_ECRIT 0x00
+#define LTC2604_CMD_MAJ 0x10
+#define LTC2604_ADR_TOUS 0x0F
+#define LTC2604_MOT_ECRIT(canal, valeur) \
+    ((((uint32_t) (LTC2604_CMD_ECRIT | (canal))) << 16) | (uint16_t) (valeur))
+#define LTC2604_MOT_MAJ_TOUS \
+    (((uint32_t) (LTC2604_CMD_MAJ | LTC2604_ADR_TOUS)) << 16)
 
 // Prototypes des fonctions du controle du SPI
 void SPI_InitLTC2604(void);
+// SCK rellement obtenue pour une demande avec l'horloge du SPI de la
+// cible (DAC_SckPossible)
+uint32_t SPI_SckPossible(uint32_t Frequence);
+// Changement d'horloge SPI : mmoris, appliqu par SPI_AppliqueFrequenceDac
+// entre deux trames (interruption Timer3). false si hors limites
+bool SPI_ChoisitFrequenceDac(uint32_t Frequence);
+void SPI_AppliqueFrequenceDac(void);
+// SCK choisie (Hz)
+uint32_t SPI_FrequenceDac(void);
+void SPI_WriteMotDac(uint32_t Mot);
+// Dbut de trame sans attente (CS reste bas) et fin de trame (attente de
+// la fin du dcalage si besoin, remonte de CS : mise  jour du DAC).
+// A utiliser depuis un seul contexte (interruption Timer3)
+void SPI_DebutMotDac(uint32_t Mot);
+void SPI_FinMotDac(void);
 void SPI_WriteToDac(uint8_t Noch, uint16_t DacVal);
 void SPI_CfgWriteToDac(uint8_t NoCh, uint16_t DacVal);
+// Mise  jour simultane des canaux 0  NbCanaux - 1 (pValeurs[canal]) :
+// registres d'entre crits un par un, puis mise  jour de tous.
+// SPI_DebutCanauxDac laisse la dernire trame en cours comme
+// SPI_DebutMotDac : les sorties changent au SPI_FinMotDac suivant
+void SPI_WriteCanauxDac(const uint16_t *pValeurs, uint8_t NbCanaux);
+void SPI_DebutCanauxDac(const uint16_t *pValeurs, uint8_t NbCanaux);
 
 
 #endif //Mc32GestSpiDac_H
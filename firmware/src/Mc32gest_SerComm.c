@@ -12,12 +12,41 @@
 #include <stdlib.h>
 #include "Generateur.h"
 #include "MenuGen.h"
+#include "GesMesure.h"
+#include "GesLatence.h"
+#include "Mc32gestSpiDac.h"
+
+// Rponse  une requte : remplit pReponse, retourne la longueur crite
+typedef uint16_t (*T_Requete)(char *pReponse, uint16_t Taille);
+
+typedef struct {
+    const char *Nom;
+    T_Requete Fonction;
+} S_Requete;
+
+static uint16_t RequeteProf(char *pReponse, uint16_t Taille);
+static uint16_t RequeteGigue(char *pReponse, uint16_t Taille);
+static uint16_t RequeteLatence(char *pReponse, uint16_t Taille);
+static uint16_t RequeteFreqMax(char *pReponse, uint16_t Taille);
+
+// Requtes reconnues par GetQuery
+static const S_Requete tableRequetes[] = {
+    {"PROF", RequeteProf},
+    {"JIT", RequeteGigue},
+    {"LAT", RequeteLatence},
+    {"FMAX", RequeteFreqMax},
+};
 
 // Fonction de reception  d'un  message
 // Met  jour les paramtres du generateur a partir du message recu
 // Format du message
 // !S=TF=0200A=5000O=+450W=0#
 // !S=TF=200A=5000O=+450W=1#    // ack sauvegarde
+// Formes : S, T, D, C, B (bruit blanc), R (bruit rose), P7, P15, P23 (PRBS)
+// Une frquence hors de 1..GENSIG_FrequenceMax (horloge SPI courante) est
+// refuse : le message est ignor et les paramtres ne changent pas. De
+// mme pour une amplitude ou un offset hors des limites du menu
+// (AMPLITUDE_MIN..AMPLITUDE_MAX, OFFSET_MIN..OFFSET_MAX)
 
 bool GetMessage(int8_t *USBReadBuffer, S_ParamGen *pParam, bool *SaveTodo) {
     char *pt_Forme = NULL;
@@ -25,6 +54,10 @@ bool GetMessage(int8_t *USBReadBuffer, S_ParamGen *pParam, bool *SaveTodo) {
     char *pt_Amplitude = NULL;
     char *pt_Offset = NULL;
     char *pt_Sauvegarde = NULL;
+    E_FormesSignal forme;
+    int frequence;
+    int amplitude;
+    int offset;
     Pec12ClearInactivity();
 
     //vrification des char en dbut et fin de trames
@@ -43,21 +76,50 @@ bool GetMessage(int8_t *USBReadBuffer, S_ParamGen *pParam, bool *SaveTodo) {
 
     // Dcodage de la forme
     switch (pt_Forme[2]) {
-        case 'T': pParam->Forme = SignalTriangle;
+        case 'T': forme = SignalTriangle;
+            break;
+        case 'S': forme = SignalSinus;
             break;
-        case 'S': pParam->Forme = SignalSinus;
+        case 'C': forme = SignalCarre;
             break;
-        case 'C': pParam->Forme = SignalCarre;
+        case 'D': forme = SignalDentDeScie;
             break;
-        case 'D': pParam->Forme = SignalDentDeScie;
+        case 'B': forme = SignalBruitBlanc;
+            break;
+        case 'R': forme = SignalBruitRose;
+            break;
+        case 'P':
+            // Ordre de la PRBS : S=P7, S=P15 ou S=P23
+            switch (atoi(pt_Forme + 3)) {
+                case 7: forme = SignalPrbs7;
+                    break;
+                case 15: forme = SignalPrbs15;
+                    break;
+                case 23: forme = SignalPrbs23;
+                    break;
+                default: return false;
+            }
             break;
         default: return false;
     }
 
+    // Frquence possible pour cette forme  l'horloge SPI courante
+    frequence = atoi(pt_Frequence + 2);
+    if ((frequence <= 0) || (frequence > GENSIG_FrequenceMax()))
+        return false;
+
+    // Amplitude et offset dans les limites du menu, trame refuse sinon
+    amplitude = atoi(pt_Amplitude + 2);
+    offset = atoi(pt_Offset + 2);
+    if ((amplitude < AMPLITUDE_MIN) || (amplitude > AMPLITUDE_MAX)
+            || (offset < OFFSET_MIN) || (offset > OFFSET_MAX))
+        return false;
+
     // ASCII to Integer
-    pParam->Frequence = atoi(pt_Frequence + 2);
-    pParam->Amplitude = atoi(pt_Amplitude + 2);
-    pParam->Offset = atoi(pt_Offset + 2);
+    pParam->Forme = forme;
+    pParam->Frequence = frequence;
+    pParam->Amplitude = amplitude;
+    pParam->Offset = offset;
 
     // ASCII to Integer - Save mode
     *SaveTodo = (atoi(pt_Sauvegarde + 2) == 1);
@@ -77,16 +139,26 @@ bool GetMessage(int8_t *USBReadBuffer, S_ParamGen *pParam, bool *SaveTodo) {
 // !S=TF=0200A=05000O=+0000WP=1#    // ack sauvegarde
 
 void SendMessage(int8_t *USBSendBuffer, S_ParamGen *pParam, bool Saved) {
-    char formeChar;
+    const char *pForme = "S";
     int saveFlag;
     switch (pParam->Forme) {
-        case SignalTriangle: formeChar = 'T';
+        case SignalTriangle: pForme = "T";
+            break;
+        case SignalSinus: pForme = "S";
+            break;
+        case SignalCarre: pForme = "C";
+            break;
+        case SignalDentDeScie: pForme = "D";
+            break;
+        case SignalBruitBlanc: pForme = "B";
             break;
-        case SignalSinus: formeChar = 'S';
+        case SignalBruitRose: pForme = "R";
             break;
-        case SignalCarre: formeChar = 'C';
+        case SignalPrbs7: pForme = "P7";
             break;
-        case SignalDentDeScie: formeChar = 'D';
+        case SignalPrbs15: pForme = "P15";
+            break;
+        case SignalPrbs23: pForme = "P23";
             break;
         default:
             break;
@@ -98,5 +170,88 @@ void SendMessage(int8_t *USBSendBuffer, S_ParamGen *pParam, bool Saved) {
         saveFlag = 0;
     }
     // Construction de la trame finale
-    sprintf((char*) USBSendBuffer,"!S=%cF=%dA=%dO=%dWP=%d#", formeChar, pParam->Frequence, pParam->Amplitude, pParam->Offset, saveFlag);
+    sprintf((char*) USBSendBuffer,"!S=%sF=%dA=%dO=%dWP=%d#", pForme, pParam->Frequence, pParam->Amplitude, pParam->Offset, saveFlag);
+}
+
+
+// Fonction de traitement d'une requte (lecture d'informations)
+// Format de la requte
+// ?PROF#
+// Format de la rponse : une ligne par valeur, encadres par ! et #
+// !PROF
+// isr_t3   nb min moy max
+// #
+// Retourne la longueur de la rponse, 0 si la requte est inconnue
+
+uint16_t GetQuery(int8_t *ReadBuffer, uint16_t Longueur, char *pReponse, uint16_t Taille) {
+    uint8_t i;
+    uint16_t nom;
+    uint16_t lg;
+    int n;
+
+    if ((Longueur < 3) || (ReadBuffer[0] != '?')) {
+        return 0;
+    }
+
+    for (i = 0; i < (sizeof (tableRequetes) / sizeof (tableRequetes[0])); i++) {
+        nom = strlen(tableRequetes[i].Nom);
+        if ((Longueur >= (nom + 2)) && (ReadBuffer[nom + 1] == '#')
+                && (strncmp((char*) &ReadBuffer[1], tableRequetes[i].Nom, nom) == 0)) {
+            n = snprintf(pReponse, Taille, "!%s\r\n", tableRequetes[i].Nom);
+            if ((n < 0) || (n >= Taille)) {
+                return 0;
+            }
+            lg = n;
+            lg += tableRequetes[i].Fonction(&pReponse[lg], Taille - lg);
+            // Place rserve pour la fin de trame
+            if ((lg + 3) >= Taille) {
+                lg = Taille - 4;
+            }
+            strcpy(&pReponse[lg], "#\r\n");
+            return lg + 3;
+        }
+    }
+    return 0;
+}
+
+// Requte PROF : statistiques des interruptions et des tches (ns)
+
+static uint16_t RequeteProf(char *pReponse, uint16_t Taille) {
+    uint16_t lg = 0;
+    uint8_t i;
+
+    for (i = 0; (i < MESURE_NbPoints()) && ((Taille - lg) > 1); i++) {
+        lg += MESURE_FormatPoint(i, &pReponse[lg], Taille - lg);
+    }
+    return lg;
+}
+
+// Requte JIT : retard et gigue des chantillons du gnrateur
+
+static uint16_t RequeteGigue(char *pReponse, uint16_t Taille) {
+    return MESURE_FormatGigue(pReponse, Taille);
+}
+
+// Requte LAT : dbit des trames et latence commande -> sortie DAC
+
+static uint16_t RequeteLatence(char *pReponse, uint16_t Taille) {
+    return LATENCE_Format(pReponse, Taille);
+}
+
+// Requte FMAX : frquence maximale (Hz, la mme pour toutes les formes),
+// horloge SPI, trames SPI et dure d'une mise  jour du DAC par
+// chantillon, frquence d'chantillonnage maximale qui en dcoule
+
+static uint16_t RequeteFreqMax(char *pReponse, uint16_t Taille) {
+    int n;
+
+    n = snprintf(pReponse, Taille, "fmax %d sck %lu trames %u maj_ns %lu fech_max %lu\r\n",
+            GENSIG_FrequenceMax(), (unsigned long) SPI_FrequenceDac(),
+            (unsigned) DAC_MOTS_PAR_MAJ(GENSIG_NB_CANAUX),
+            (unsigned long) DAC_TempsMotsNs(SPI_FrequenceDac(), DAC_MOTS_PAR_MAJ(GENSIG_NB_CANAUX)),
+            (unsigned long) GENSIG_FechMax());
+    if ((n < 0) || (n >= Taille)) {
+        return 0;
+    }
+    return n;
 }
@@ -22,5 +22,6 @@
 
 void SendMessage(int8_t *USBSendBuffer, S_ParamGen *pParam, bool Saved);
 bool GetMessage(int8_t *USBReadBuffer, S_ParamGen *pParam, bool *SaveTodo);
+uint16_t GetQuery(int8_t *ReadBuffer, uint16_t Longueur, char *pReponse, uint16_t Taille);
 
 #endif
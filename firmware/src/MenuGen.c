@@ -11,22 +11,29 @@
 #include <stdbool.h>
 #include "MenuGen.h"
 #include "Mc32DriverLcd.h"
+#include "GesLcd.h"
 #include "appgen.h"
 #include "GesPec12.h"
 #include "Mc32NVMUtil.h"
 #include <math.h>
 #include "Generateur.h"
+#include "GesEvent.h"
 
 
 //---------------------------------------------------------------------------------
 // Dfinition des constantes pour l'affichage des types de signaux sur le menu LCD
 // Chaque chane reprsente le nom d'un signal affich  l'cran.
 //---------------------------------------------------------------------------------
-const char MenuFormes[4][21] = {
+const char MenuFormes[9][21] = {
     "Sinus",
     "Triangle",
     "DentDeScie",
-    "Carre"
+    "Carre",
+    "BruitBlanc",
+    "BruitRose",
+    "PRBS7",
+    "PRBS15",
+    "PRBS23"
 };
 
 // Structure pour les traitements du Pec12
@@ -44,17 +51,70 @@ APPGEN_DATA initialisationState;
 //---------------------------------------------------------------------------------
 
 void MENU_Initialize(S_ParamGen *pParam) {
-    lcd_gotoxy(2, 1);
-    printf_lcd("Forme = %10s  ", MenuFormes[pParam->Forme]);
+    LCDQ_Gotoxy(2, 1);
+    LCDQ_Printf("Forme = %10s  ", MenuFormes[pParam->Forme]);
 
-    lcd_gotoxy(2, 2);
-    printf_lcd("Freq [Hz] =  %4d   ", pParam->Frequence);
+    LCDQ_Gotoxy(2, 2);
+    LCDQ_Printf("Freq [Hz] =  %4d   ", pParam->Frequence);
 
-    lcd_gotoxy(2, 3);
-    printf_lcd("Ampl [mV] = %5d   ", pParam->Amplitude);
+    LCDQ_Gotoxy(2, 3);
+    LCDQ_Printf("Ampl [mV] = %5d   ", pParam->Amplitude);
 
-    lcd_gotoxy(2, 4);
-    printf_lcd("Offset [mV] = %5d ", pParam->Offset);
+    LCDQ_Gotoxy(2, 4);
+    LCDQ_Printf("Offset [mV] = %5d ", pParam->Offset);
+}
+
+//---------------------------------------------------------------------------------
+// Fonction : MENU_ChargeEvenement
+// Description : Retire le prochain vnement de la file GesEvent et positionne
+//               l'indication correspondante du Pec12 ou de S9. Les crans
+//               conscutifs dans le mme sens sont regroups en un seul
+//               incrment / dcrment de Pec12NbPas() crans.
+//---------------------------------------------------------------------------------
+
+static void MENU_ChargeEvenement(void) {
+    S_Event evt;
+    S_Event suivant;
+
+    Pec12.NbPas = 0;
+    if (!EVT_Pop(&evt)) {
+        return;
+    }
+
+    switch (evt.Type) {
+        case EVT_PEC12_INC:
+        case EVT_PEC12_DEC:
+            if (evt.Type == EVT_PEC12_INC) {
+                Pec12.Inc = 1;
+            } else {
+                Pec12.Dec = 1;
+            }
+            Pec12.NbPas = 1;
+            // Regroupement des crans suivants dans le mme sens
+            while (EVT_Peek(&suivant) && (suivant.Type == evt.Type)
+                    && (Pec12.NbPas < UINT8_MAX)) {
+                EVT_Pop(&suivant);
+                Pec12.NbPas++;
+                evt.Timestamp = suivant.Timestamp;
+            }
+            // Vitesse de rotation pour l'acclration
+            Pec12MemoCrans(evt.Timestamp, Pec12.NbPas);
+            break;
+        case EVT_PEC12_OK:
+            Pec12.OK = 1;
+            break;
+        case EVT_PEC12_ESC:
+            Pec12.ESC = 1;
+            break;
+        case EVT_S9_OK:
+            S9.OK = 1;
+            break;
+        case EVT_S9_ESC:
+            S9.ESC = 1;
+            break;
+        default:
+            break;
+    }
 }
 
 //---------------------------------------------------------------------------------
@@ -83,6 +143,9 @@ void MENU_Execute(S_ParamGen *pParam, bool local) {
     //  MENU_Execute ? mode  remote  (local == false)
 
     if (local == false) {
+        // Pas de saisie locale en mode remote
+        EVT_Vide();
+
         if (appRJ45Status.usbStatSave == false) {
             if (!isInitializedRemote) {
 
@@ -91,25 +154,24 @@ void MENU_Execute(S_ParamGen *pParam, bool local) {
                 Pec12ClearInactivity();
 
                 // Affiche les paramtres initiaux sur le LCD.
-                lcd_putc('\f');
+                LCDQ_Putc('\f');
                 MENU_Initialize(pParam);
                 isInitializedLocal = 0;
                 isInitializedRemote = 1;
             }
 
-            lcd_gotoxy(1, 1);
-            printf_lcd("#Forme =");
-            lcd_gotoxy(1, 2);
-            printf_lcd("#Freq [Hz] =");
-            lcd_gotoxy(1, 3);
-            printf_lcd("#Ampl [mV] =");
-            lcd_gotoxy(1, 4);
-            printf_lcd("#Offset [mV] =");
+            LCDQ_Gotoxy(1, 1);
+            LCDQ_Printf("#Forme =");
+            LCDQ_Gotoxy(1, 2);
+            LCDQ_Printf("#Freq [Hz] =");
+            LCDQ_Gotoxy(1, 3);
+            LCDQ_Printf("#Ampl [mV] =");
+            LCDQ_Gotoxy(1, 4);
+            LCDQ_Printf("#Offset [mV] =");
 
             AfficheMenu(pParam);
             // Mise  jour du signal et de sa priode avec les nouveaux paramtres
             GENSIG_UpdateSignal(pParam);
-            GENSIG_UpdatePeriode(pParam);
         }
     } else {
         // Initialisation du menu lors du premier appel
@@ -119,7 +181,7 @@ void MENU_Execute(S_ParamGen *pParam, bool local) {
             Pec12ClearInactivity();
 
             // Affiche les paramtres initiaux sur le LCD.
-            lcd_putc('\f');
+            LCDQ_Putc('\f');
             MENU_Initialize(pParam);
 
             // Sauvegarde les paramtres actuels dans la structure temporaire.
@@ -129,6 +191,9 @@ void MENU_Execute(S_ParamGen *pParam, bool local) {
             isInitializedLocal = 1;
         }
 
+        // Un vnement d'entre par passage, aucun n'est perdu
+        MENU_ChargeEvenement();
+
         //Si save pas actif alors gestion menu
         if (menuState != SAVE) {
 
@@ -170,14 +235,14 @@ void MENU_Execute(S_ParamGen *pParam, bool local) {
         // Si le changement d'tat est significatif (diffrence de 2 ou plus),
         // on efface le marqueur affich sur le LCD pour viter les rsidus.
         if ((abs(previousMenuState - menuState)) >= 2) {
-            lcd_gotoxy(1, 1);
-            printf_lcd(" ");
-            lcd_gotoxy(1, 2);
-            printf_lcd(" ");
-            lcd_gotoxy(1, 3);
-            printf_lcd(" ");
-            lcd_gotoxy(1, 4);
-            printf_lcd(" ");
+            LCDQ_Gotoxy(1, 1);
+            LCDQ_Printf(" ");
+            LCDQ_Gotoxy(1, 2);
+            LCDQ_Printf(" ");
+            LCDQ_Gotoxy(1, 3);
+            LCDQ_Printf(" ");
+            LCDQ_Gotoxy(1, 4);
+            LCDQ_Printf(" ");
         }
 
         // Mise  jour de l'tat prcdent avec l'tat courant.
@@ -188,36 +253,36 @@ void MENU_Execute(S_ParamGen *pParam, bool local) {
         //   SI "?" alors on a choisi
         switch (menuState) {
             case SEL_FORME:
-                lcd_gotoxy(1, 1);
-                printf_lcd("*");
+                LCDQ_Gotoxy(1, 1);
+                LCDQ_Printf("*");
                 break;
             case SET_FORME:
-                lcd_gotoxy(1, 1);
-                printf_lcd("?");
+                LCDQ_Gotoxy(1, 1);
+                LCDQ_Printf("?");
                 break;
             case SEL_FREQU:
-                lcd_gotoxy(1, 2);
-                printf_lcd("*");
+                LCDQ_Gotoxy(1, 2);
+                LCDQ_Printf("*");
                 break;
             case SET_FREQU:
-                lcd_gotoxy(1, 2);
-                printf_lcd("?");
+                LCDQ_Gotoxy(1, 2);
+                LCDQ_Printf("?");
                 break;
             case SEL_AMPL:
-                lcd_gotoxy(1, 3);
-                printf_lcd("*");
+                LCDQ_Gotoxy(1, 3);
+                LCDQ_Printf("*");
                 break;
             case SET_AMPL:
-                lcd_gotoxy(1, 3);
-                printf_lcd("?");
+                LCDQ_Gotoxy(1, 3);
+                LCDQ_Printf("?");
                 break;
             case SEL_OFFSET:
-                lcd_gotoxy(1, 4);
-                printf_lcd("*");
+                LCDQ_Gotoxy(1, 4);
+                LCDQ_Printf("*");
                 break;
             case SET_OFFSET:
-                lcd_gotoxy(1, 4);
-                printf_lcd("?");
+                LCDQ_Gotoxy(1, 4);
+                LCDQ_Printf("?");
                 break;
             case SAVE:
                 // Vrification de l'appui long
@@ -227,17 +292,17 @@ void MENU_Execute(S_ParamGen *pParam, bool local) {
                     //Excuter la sauvegarde
                     NVM_WriteBlock((uint32_t*) pParam, sizeof (S_ParamGen));
                     //Affichage d'un message de confirmation de save
-                    lcd_ClearLine(3);
-                    lcd_gotoxy(1, 2);
-                    printf_lcd("    Sauvegarde OK   ");
+                    LCDQ_ClearLine(3);
+                    LCDQ_Gotoxy(1, 2);
+                    LCDQ_Printf("    Sauvegarde OK   ");
                     Pec12ClearInactivity(); // Rinitialiser l'inactivit
                 }// Toutes autres actions
                 else if (S9IsOK() || Pec12IsESC() || Pec12IsMinus() || Pec12IsOK() || Pec12IsPlus()) {
                     compteur++; // Incrmentation du compteur
-                    lcd_ClearLine(3);
+                    LCDQ_ClearLine(3);
                     // Annuler la sauvegarde
-                    lcd_gotoxy(1, 2);
-                    printf_lcd(" Sauvegarde ANNULEE ");
+                    LCDQ_Gotoxy(1, 2);
+                    LCDQ_Printf(" Sauvegarde ANNULEE ");
                     Pec12ClearInactivity(); // Rinitialiser l'inactivit
                 }
 
@@ -252,12 +317,12 @@ void MENU_Execute(S_ParamGen *pParam, bool local) {
                     }
                 } else {
                     // Afficher la question de la sauvegarde
-                    lcd_putc('\f');
+                    LCDQ_Putc('\f');
 
-                    lcd_gotoxy(1, 2);
-                    printf_lcd("    Sauvegarde ?    ");
-                    lcd_gotoxy(1, 3);
-                    printf_lcd("    (Appui long)    ");
+                    LCDQ_Gotoxy(1, 2);
+                    LCDQ_Printf("    Sauvegarde ?    ");
+                    LCDQ_Gotoxy(1, 3);
+                    LCDQ_Printf("    (Appui long)    ");
                 }
                 break;
             default:
@@ -284,20 +349,72 @@ void MENU_Execute(S_ParamGen *pParam, bool local) {
 
 void AfficheMenu(S_ParamGen *pParam) {
     // Affiche le nom de la forme de signal modifie
-    lcd_gotoxy(10, 1);
-    printf_lcd("%10s", MenuFormes[pParam->Forme]);
+    LCDQ_Gotoxy(10, 1);
+    LCDQ_Printf("%10s", MenuFormes[pParam->Forme]);
 
     // Affiche la valeur de la frquence modifie
-    lcd_gotoxy(15, 2);
-    printf_lcd("%4d", pParam->Frequence);
+    LCDQ_Gotoxy(15, 2);
+    LCDQ_Printf("%4d", pParam->Frequence);
 
     // Affiche la valeur de l'amplitude modifie
-    lcd_gotoxy(14, 3);
-    printf_lcd("%5d", pParam->Amplitude);
+    LCDQ_Gotoxy(14, 3);
+    LCDQ_Printf("%5d", pParam->Amplitude);
 
     // Affiche la valeur de l'offset modifie
-    lcd_gotoxy(16, 4);
-    printf_lcd("%5d", pParam->Offset);
+    LCDQ_Gotoxy(16, 4);
+    LCDQ_Printf("%5d", pParam->Offset);
+}
+
+//---------------------------------------------------------------------------------
+// Fonction : MENU_FrequenceMax
+// Description : Borne suprieure de la frquence : FREQUENCE_MAX, ou moins si
+//               l'horloge SPI du DAC ne permet pas cette frquence
+//               (GENSIG_FrequenceMax). Arrondie au multiple de FREQUENCE_MIN
+//               infrieur : la borne reste sur la grille des pas du menu.
+//---------------------------------------------------------------------------------
+
+static int16_t MENU_FrequenceMax(void) {
+    int16_t max = GENSIG_FrequenceMax();
+
+    if (max > FREQUENCE_MAX) {
+        max = FREQUENCE_MAX;
+    }
+    return max - (max % FREQUENCE_MIN);
+}
+
+//---------------------------------------------------------------------------------
+// Fonction : MENU_Augmente / MENU_Diminue
+// Description : Applique un incrment (ou dcrment) de plusieurs pas en une
+//               seule mise  jour, born  [min, max]. Avec rebouclage, une
+//               valeur dj sur la borne passe  l'autre borne (comportement
+//               d'un pas unique). Une valeur au-del de max (borne abaisse
+//               depuis, horloge SPI plus lente) revient sur max.
+//---------------------------------------------------------------------------------
+
+static int16_t MENU_Augmente(int16_t valeur, int32_t delta, int16_t min, int16_t max, bool rebouclage) {
+    int32_t nouvelle;
+
+    if (valeur > max) {
+        return max;
+    }
+    if (valeur == max) {
+        return rebouclage ? min : max;
+    }
+    nouvelle = (int32_t) valeur + delta;
+    return (nouvelle > max) ? max : (int16_t) nouvelle;
+}
+
+static int16_t MENU_Diminue(int16_t valeur, int32_t delta, int16_t min, int16_t max, bool rebouclage) {
+    int32_t nouvelle;
+
+    if (valeur <= min) {
+        return rebouclage ? max : min;
+    }
+    nouvelle = (int32_t) valeur - delta;
+    if (nouvelle > max) {
+        return max;
+    }
+    return (nouvelle < min) ? min : (int16_t) nouvelle;
 }
 
 //---------------------------------------------------------------------------------
@@ -324,7 +441,6 @@ MENU_STATE GestSettingMenu(MENU_STATE menuState, S_ParamGen *tempData, S_ParamGe
         AfficheMenu(tempData);
         // Mise  jour du signal et de sa priode avec les nouveaux paramtres
         GENSIG_UpdateSignal(pParam);
-        GENSIG_UpdatePeriode(pParam);
     }// Si l'utilisateur annule la modification en appuyant sur ESC
     else if (Pec12IsESC()) {
         // Restaure la valeur initiale dans la structure temporaire
@@ -338,35 +454,26 @@ MENU_STATE GestSettingMenu(MENU_STATE menuState, S_ParamGen *tempData, S_ParamGe
         switch (menuState) {
             case SET_FORME:
                 // Passage  la forme suivante si l'on n'est pas dj  la limite suprieure
-                if (tempData->Forme < SignalCarre) {
-                    tempData->Forme++;
-                } else {
-                    tempData->Forme = SignalCarre;
-                }
+                tempData->Forme = MENU_Augmente(tempData->Forme, Pec12NbPas(),
+                        SignalSinus, SIGNAL_DERNIERE_FORME, false);
                 break;
             case SET_FREQU:
-                // Augmente la frquence d'un pas ; rebouclage  la valeur minimale si on dpasse FREQUENCE_MAX
-                if (tempData->Frequence < FREQUENCE_MAX) {
-                    tempData->Frequence += FREQUENCE_MIN;
-                } else {
-                    tempData->Frequence = FREQUENCE_MIN;
-                }
+                // Augmente la frquence ; rebouclage  la valeur minimale si on dpasse FREQUENCE_MAX
+                tempData->Frequence = MENU_Augmente(tempData->Frequence,
+                        Pec12Pas(FREQUENCE_MIN, ACCEL_FREQUENCE),
+                        FREQUENCE_MIN, MENU_FrequenceMax(), true);
                 break;
             case SET_AMPL:
-                // Augmente l'amplitude d'un pas ; rebouclage  AMPLITUDE_MIN si la valeur maximale est atteinte
-                if (tempData->Amplitude < AMPLITUDE_MAX) {
-                    tempData->Amplitude += PAS_AMPLITUDE;
-                } else {
-                    tempData->Amplitude = AMPLITUDE_MIN;
-                }
+                // Augmente l'amplitude ; rebouclage  AMPLITUDE_MIN si la valeur maximale est atteinte
+                tempData->Amplitude = MENU_Augmente(tempData->Amplitude,
+                        Pec12Pas(PAS_AMPLITUDE, ACCEL_AMPLITUDE),
+                        AMPLITUDE_MIN, AMPLITUDE_MAX, true);
                 break;
             case SET_OFFSET:
-                // Augmente l'offset d'un pas ; on ne dpasse pas OFFSET_MAX
-                if (tempData->Offset < OFFSET_MAX) {
-                    tempData->Offset += PAS_OFFSET;
-                } else {
-                    tempData->Offset = OFFSET_MAX;
-                }
+                // Augmente l'offset ; on ne dpasse pas OFFSET_MAX
+                tempData->Offset = MENU_Augmente(tempData->Offset,
+                        Pec12Pas(PAS_OFFSET, ACCEL_OFFSET),
+                        OFFSET_MIN, OFFSET_MAX, false);
                 break;
             default:
                 break;
@@ -376,35 +483,26 @@ MENU_STATE GestSettingMenu(MENU_STATE menuState, S_ParamGen *tempData, S_ParamGe
         switch (menuState) {
             case SET_FORME:
                 // Passage  la forme prcdente si possible, sinon maintien  SignalSinus
-                if (tempData->Forme > SignalSinus) {
-                    tempData->Forme--;
-                } else {
-                    tempData->Forme = SignalSinus;
-                }
+                tempData->Forme = MENU_Diminue(tempData->Forme, Pec12NbPas(),
+                        SignalSinus, SIGNAL_DERNIERE_FORME, false);
                 break;
             case SET_FREQU:
-                // Diminue la frquence d'un pas ; rebouclage  FREQUENCE_MAX si la valeur minimale est atteinte
-                if (tempData->Frequence > FREQUENCE_MIN) {
-                    tempData->Frequence -= FREQUENCE_MIN;
-                } else {
-                    tempData->Frequence = FREQUENCE_MAX;
-                }
+                // Diminue la frquence ; rebouclage  FREQUENCE_MAX si la valeur minimale est atteinte
+                tempData->Frequence = MENU_Diminue(tempData->Frequence,
+                        Pec12Pas(FREQUENCE_MIN, ACCEL_FREQUENCE),
+                        FREQUENCE_MIN, MENU_FrequenceMax(), true);
                 break;
             case SET_AMPL:
-                // Diminue l'amplitude d'un pas ; rebouclage  AMPLITUDE_MAXsi la valeur minimale est atteinte
-                if (tempData->Amplitude > AMPLITUDE_MIN) {
-                    tempData->Amplitude -= PAS_AMPLITUDE;
-                } else {
-                    tempData->Amplitude = AMPLITUDE_MAX;
-                }
+                // Diminue l'amplitude ; rebouclage  AMPLITUDE_MAX si la valeur minimale est atteinte
+                tempData->Amplitude = MENU_Diminue(tempData->Amplitude,
+                        Pec12Pas(PAS_AMPLITUDE, ACCEL_AMPLITUDE),
+                        AMPLITUDE_MIN, AMPLITUDE_MAX, true);
                 break;
             case SET_OFFSET:
-                // Diminue l'offset d'un pas ; on ne descend pas en dessous de OFFSET_MIN
-                if (tempData->Offset > OFFSET_MIN) {
-                    tempData->Offset -= PAS_OFFSET;
-                } else {
-                    tempData->Offset = OFFSET_MIN;
-                }
+                // Diminue l'offset ; on ne descend pas en dessous de OFFSET_MIN
+                tempData->Offset = MENU_Diminue(tempData->Offset,
+                        Pec12Pas(PAS_OFFSET, ACCEL_OFFSET),
+                        OFFSET_MIN, OFFSET_MAX, false);
                 break;
             default:
                 break;
@@ -25,6 +25,11 @@
 #define OFFSET_MIN -5000    // Offset minimal
 #define PAS_OFFSET 100      // Incrmentation de l'offset
 
+// Facteur d'acclration maximum du PEC12 par paramtre (1 = sans acclration)
+#define ACCEL_FREQUENCE 10  // Pas max 200 Hz
+#define ACCEL_AMPLITUDE 10  // Pas max 1000 mV
+#define ACCEL_OFFSET 5      // Pas max 500 mV
+
 // numration des diffrents tats du menu (SEL = selection & SET = setting)
 typedef enum 
 {
@@ -42,6 +47,9 @@ typedef enum
 // Excution du menu, appele cycliquement par l'application
 void MENU_Execute(S_ParamGen *pParam, bool local);
 
+// Noms des formes affichs (LCD et console)
+extern const char MenuFormes[9][21];
+
 // Initialisation de l'affichage du menu
 void MENU_Initialize(S_ParamGen *pParam);
 
@@ -55,9 +55,15 @@ SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
 
 #include "app.h"
 #include "Mc32DriverLcd.h"
+#include "GesLcd.h"
 #include "appgen.h"
 #include "Mc32gest_SerComm.h"
+#include "GesLatence.h"
+#include "GesLog.h"
+#include "GesTrace.h"
 #define SERVER_PORT 9760
+// Taille maximale de la rponse  une requte ?xxx#
+#define APP_TAILLE_REPONSE 512
 
 // *****************************************************************************
 // *****************************************************************************
@@ -85,6 +91,15 @@ APPGEN_DATA appRJ45Status;
 
 bool SaveTodo = false;
 
+// Rponse aux requtes ?xxx# (plus longue qu'une trame) : la partie qui
+// ne tient pas dans la FIFO TX est envoye aux passages suivants
+static char Reponse[APP_TAILLE_REPONSE];
+static uint16_t LongueurReponse = 0;
+static uint16_t EnvoyeReponse = 0;
+// Octets changs au dernier passage : la pile TCP/IP doit encore les
+// traiter au tour suivant
+static bool TravailTcp = false;
+
 S_ParamGen LocalParamGen;
 S_ParamGen RemoteParamGen;
 APPGEN_IPADDR appgen_ipAddr;
@@ -159,11 +174,11 @@ void APP_Tasks(void) {
         case APP_TCPIP_WAIT_INIT:
             tcpipStat = TCPIP_STACK_Status(sysObj.tcpip);
             if (tcpipStat < 0) { // some error occurred
-                SYS_CONSOLE_MESSAGE(" APP: TCP/IP stack initialization failed!\r\n");
+                LOG(LOG_ERREUR, "APP: TCP/IP stack initialization failed!");
 
                 //ajout SCA 
-                lcd_gotoxy(1, 4);
-                printf_lcd("TCP/IP error !");
+                LCDQ_Gotoxy(1, 4);
+                LCDQ_Printf("TCP/IP error !");
 
                 appData.state = APP_TCPIP_ERROR;
             } else if (tcpipStat == SYS_STATUS_READY) {
@@ -177,9 +192,9 @@ void APP_Tasks(void) {
                     netBiosName = TCPIP_STACK_NetBIOSName(netH);
 
 #if defined(TCPIP_STACK_USE_NBNS)
-                    SYS_CONSOLE_PRINT("    Interface %s on host %s - NBNS enabled\r\n", netName, netBiosName);
+                    LOG(LOG_INFO, "Interface %s on host %s - NBNS enabled", netName, netBiosName);
 #else
-                    SYS_CONSOLE_PRINT("    Interface %s on host %s - NBNS disabled\r\n", netName, netBiosName);
+                    LOG(LOG_INFO, "Interface %s on host %s - NBNS disabled", netName, netBiosName);
 #endif  // defined(TCPIP_STACK_USE_NBNS)
 
                 }
@@ -202,9 +217,8 @@ void APP_Tasks(void) {
                 ipAddr.Val = TCPIP_STACK_NetAddress(netH);
                 if (dwLastIP[i].Val != ipAddr.Val) {
                     appRJ45Status.ipState = true;
-                    SYS_CONSOLE_MESSAGE(TCPIP_STACK_NetNameGet(netH));
-                    SYS_CONSOLE_MESSAGE(" IP Address: ");
-                    SYS_CONSOLE_PRINT("%d.%d.%d.%d \r\n", ipAddr.v[0], ipAddr.v[1], ipAddr.v[2], ipAddr.v[3]);
+                    LOG(LOG_INFO, "%s IP Address: %d.%d.%d.%d", TCPIP_STACK_NetNameGet(netH),
+                            ipAddr.v[0], ipAddr.v[1], ipAddr.v[2], ipAddr.v[3]);
 
                     APPGEN_SetIP(ipAddr.v[0], ipAddr.v[1], ipAddr.v[2], ipAddr.v[3]);
                 }
@@ -214,10 +228,10 @@ void APP_Tasks(void) {
         case APP_TCPIP_OPENING_SERVER:
         {
 
-            SYS_CONSOLE_PRINT("Waiting for Client Connection on port: %d\r\n", SERVER_PORT);
+            LOG(LOG_INFO, "Waiting for Client Connection on port: %d", SERVER_PORT);
             appData.socket = TCPIP_TCP_ServerOpen(IP_ADDRESS_TYPE_IPV4, SERVER_PORT, 0);
             if (appData.socket == INVALID_SOCKET) {
-                SYS_CONSOLE_MESSAGE("Couldn't open server socket\r\n");
+                LOG(LOG_ERREUR, "Couldn't open server socket");
                 break;
             }
             // Ncessaire si on veut que TCPIP_TCP_IsConnected() dtecte dconnexion du cble 
@@ -240,7 +254,7 @@ void APP_Tasks(void) {
                 // We got a connection
                 appRJ45Status.rj45Stat = true;
                 appData.state = APP_TCPIP_SERVING_CONNECTION;
-                SYS_CONSOLE_MESSAGE("Received a connection\r\n");
+                LOG(LOG_INFO, "Received a connection");
             }
         }
             break;
@@ -249,12 +263,26 @@ void APP_Tasks(void) {
         {
             if (!TCPIP_TCP_IsConnected(appData.socket)) {
                 appData.state = APP_TCPIP_CLOSING_CONNECTION;
-                SYS_CONSOLE_MESSAGE("Connection was closed\r\n");
+                LOG(LOG_INFO, "Connection was closed");
                 break;
             }
             int16_t wMaxGet, wMaxPut, wCurrentChunk;
             uint16_t w;
             uint8_t AppBuffer[32];
+
+            TravailTcp = false;
+
+            // Fin d'une rponse en attente : aucune trame n'est lue avant
+            // qu'elle soit entirement envoye (ordre des rponses)
+            if (EnvoyeReponse < LongueurReponse) {
+                EnvoyeReponse += TCPIP_TCP_ArrayPut(appData.socket,
+                        (uint8_t*) &Reponse[EnvoyeReponse],
+                        LongueurReponse - EnvoyeReponse);
+                TravailTcp = true;
+                if (EnvoyeReponse < LongueurReponse) {
+                    break;
+                }
+            }
             // Figure out how many bytes have been received and how many we can transmit.
             wMaxGet = TCPIP_TCP_GetIsReady(appData.socket); // Get TCP RX FIFO byte count
             wMaxPut = TCPIP_TCP_PutIsReady(appData.socket); // Get TCP TX FIFO free space
@@ -262,6 +290,8 @@ void APP_Tasks(void) {
             // Make sure we don't take more bytes out of the RX FIFO than we can put into the TX FIFO
             if (wMaxPut < wMaxGet)
                 wMaxGet = wMaxPut;
+            if (wMaxGet > 0)
+                TravailTcp = true;
 
             // Process all bytes that we can
             // This is implemented as a loop, processing up to sizeof(AppBuffer) bytes at a time.
@@ -274,11 +304,28 @@ void APP_Tasks(void) {
 
                 // Transfer the data out of the TCP RX FIFO and into our local processing buffer.
                 wCurrentChunk = TCPIP_TCP_ArrayGet(appData.socket, AppBuffer, wCurrentChunk);
-                GetMessage((int8_t*) AppBuffer, &RemoteParamGen, &SaveTodo);
+                TRACE_Ecrit(TRACE_TRAME, wCurrentChunk);
+
+                // Requte d'information : la rponse remplace l'cho
+                if (AppBuffer[0] == '?') {
+                    LongueurReponse = GetQuery((int8_t*) AppBuffer, wCurrentChunk,
+                            Reponse, sizeof (Reponse));
+                    EnvoyeReponse = TCPIP_TCP_ArrayPut(appData.socket,
+                            (uint8_t*) Reponse, LongueurReponse);
+                    // FIFO TX pleine : le reste part aux passages suivants
+                    if (EnvoyeReponse < LongueurReponse) {
+                        break;
+                    }
+                    continue;
+                }
+                // Horodatage de la trame pour la mesure de latence
+                LATENCE_CommandeRecue(GetMessage((int8_t*) AppBuffer, &RemoteParamGen, &SaveTodo));
                 
                 // Transfer the data out of our local processing buffer and into the TCP TX FIFO.
-                SYS_CONSOLE_PRINT("Server Sending %s\r\n", AppBuffer);
                 SendMessage((int8_t*) AppBuffer, &RemoteParamGen, SaveTodo);
+                // Trace de chaque trame : niveau debug seulement, aucun
+                // formatage dans la boucle de service aux autres niveaux
+                LOG(LOG_DEBUG, "Server Sending %s", AppBuffer);
                 TCPIP_TCP_ArrayPut(appData.socket, AppBuffer, wCurrentChunk);
 
                 // No need to perform any flush.  TCP data in TX FIFO will automatically transmit itself after it accumulates for a while.  If you want to decrease latency (at the expense of wasting network bandwidth on TCP overhead), perform and explicit flush via the TCPFlush() API.
@@ -288,6 +335,9 @@ void APP_Tasks(void) {
         case APP_TCPIP_CLOSING_CONNECTION:
         {
             appRJ45Status.rj45Stat = false;
+            // Rponse en attente abandonne avec la connexion
+            LongueurReponse = 0;
+            EnvoyeReponse = 0;
             // Close the socket connection.
             TCPIP_TCP_Close(appData.socket);
             appData.socket = INVALID_SOCKET;
@@ -302,6 +352,23 @@ void APP_Tasks(void) {
 
 
 
+//------------------------------------------------------------------------------
+// Travail en attente du serveur TCP (voir app.h). En dehors de l'attente et
+// du service d'une connexion, les tats avancent par scrutation de la pile :
+// ils comptent comme du travail.
+//------------------------------------------------------------------------------
+
+bool APP_TravailEnAttente(void) {
+    switch (appData.state) {
+        case APP_TCPIP_WAIT_FOR_CONNECTION:
+            return false;
+        case APP_TCPIP_SERVING_CONNECTION:
+            return TravailTcp || (EnvoyeReponse < LongueurReponse)
+                    || (TCPIP_TCP_GetIsReady(appData.socket) > 0);
+        default:
+            return true;
+    }
+}
 
 /*******************************************************************************
  End of File
@@ -204,6 +204,11 @@ void APP_Initialize ( void );
 
 void APP_Tasks ( void );
 
+// true si le serveur TCP a du travail sans attendre d'interruption (donnes
+// reues, rponse en cours, changement d'tat) : la boucle principale ne
+// met alors pas le CPU en Idle (SCHED_Attente)
+bool APP_TravailEnAttente ( void );
+
 
 #endif /* _APP_H */
 /*******************************************************************************
@@ -55,12 +55,18 @@ SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
 
 #include "appgen.h"
 #include "Mc32DriverLcd.h"
+#include "GesLcd.h"
 #include "../apps/tcpip/tcpip_tcp_server_TP5_IpGen/firmware/src/system_config/pic32mx_eth_sk2/framework/driver/drv_tmr_static.h"
 #include "Mc32gestSpiDac.h"
 #include "MenuGen.h"
 #include "GesPec12.h"
 #include "Generateur.h"
 #include "Mc32Debounce.h"
+#include "GesEvent.h"
+#include "GesMesure.h"
+#include "GesConsole.h"
+#include "GesSched.h"
+#include "GesTrace.h"
 
 // Descripteur des sinaux
 S_SwitchDescriptor DescrS9;
@@ -112,8 +118,62 @@ APPGEN_DATA appRJ45Status;
 // *****************************************************************************
 
 
-/* TODO:  Add any necessary local functions.
- */
+//------------------------------------------------------------------------------
+// Traitement des chantillons 1 ms dposs par l'interruption Timer1 :
+// anti-rebond et gestion du PEC12 et de S9, clignotement LED1. L'horloge
+// ms avance dans l'interruption.
+// Tous les chantillons en attente sont traits, aucun n'est saut.
+//------------------------------------------------------------------------------
+
+static void APPGEN_TraiteTicks(void) {
+    uint8_t entrees;
+
+    while (EVT_RetireEchantillon(&entrees)) {
+        // Anti-rebond vertical du PEC12 et de S9 en un seul appel
+        ScanEntrees(entrees);
+
+        LED1_W = !LED1_R;
+    }
+}
+
+//------------------------------------------------------------------------------
+// Tche de service (toutes les APPGEN_PERIODE_SERVICE ms) : affichage de
+// l'IP, menu local ou remote, message de sauvegarde
+//------------------------------------------------------------------------------
+
+static bool APPGEN_Service(void) {
+    static uint16_t wait5Secondes = 0;
+
+    // Toggle de la led 2
+    BSP_LEDToggle(BSP_LED_2);
+
+    if (appRJ45Status.ipState == true) {
+        APPGEN_DisplayStoredIP();
+        if (wait5Secondes >= 500) {
+            wait5Secondes = 0;
+            appRJ45Status.ipState = false;
+            appRJ45Status.initialisationMenu = true;
+        }else {
+            ++wait5Secondes;
+        }
+
+    } else {
+        if (appRJ45Status.rj45Stat) {
+            MENU_Execute(&RemoteParamGen, false);
+            BSP_LEDOn(BSP_LED_5);
+            BSP_LEDOff(BSP_LED_7);
+        } else {
+            MENU_Execute(&LocalParamGen, true);
+            BSP_LEDOff(BSP_LED_5);
+            BSP_LEDOn(BSP_LED_7);
+        }
+    }
+    // Si on doit sauver les paramtres sur USB, on lance la demande de sauvegarde
+    if (appRJ45Status.usbStatSave) {
+        MENU_DemandeSave();
+    }
+    return true;
+}
 
 
 // *****************************************************************************
@@ -148,7 +208,8 @@ void APPGEN_Initialize(void) {
  */
 
 void APPGEN_Tasks(void) {
-    static uint16_t wait5Secondes = 0;
+    // Echantillons 1 ms en attente (hors interruption)
+    APPGEN_TraiteTicks();
 
     /* Check the application's current state. */
     switch (appgenData.stategen) {
@@ -158,11 +219,14 @@ void APPGEN_Tasks(void) {
             // Initialisation et allumage de l'affichage LCD
             lcd_init();
             lcd_bl_on();
+            // Les critures LCD passent ensuite par la file d'attente
+            LCDQ_Init();
 
             // Init SPI DAC
             SPI_InitLTC2604();
 
-            // Initialisation PEC12 et S9
+            // Initialisation PEC12 et S9 et de leur file d'vnements
+            EVT_Init();
             Pec12Init();
             S9Init();
 
@@ -173,63 +237,54 @@ void APPGEN_Tasks(void) {
             RemoteParamGen = LocalParamGen;
 
             // Affichage  l'enclechement 
-            lcd_gotoxy(1, 1);
-            printf_lcd("TP5 IpGen 2025");
-            lcd_gotoxy(1, 2);
-            printf_lcd("ACL/TCT");
-
-            // mise a jour du signal et de la periode des parametre local
+            LCDQ_Gotoxy(1, 1);
+            LCDQ_Printf("TP5 IpGen 2025");
+            LCDQ_Gotoxy(1, 2);
+            LCDQ_Printf("ACL/TCT");
+
+            // mise a jour du signal et de la periode des parametre local,
+            // forme  bande limite construite en entier avant le dpart
+            // des timers
             GENSIG_UpdateSignal(&LocalParamGen);
-            GENSIG_UpdatePeriode(&LocalParamGen);
+            while (GENSIG_Tasks()) {
+            }
+
+            // Cot de l'instrumentation, mesur avant le dpart des timers
+            MESURE_Calibre();
+            TRACE_Calibre();
+            // Commandes du gnrateur sur la console USB
+            CONSOLE_Init();
 
             // ajout init drivers timers statiques
             DRV_TMR0_Initialize();
             DRV_TMR1_Initialize();
+            // Entre de dclenchement (capture sur TMR3)
+            GENSIG_InitDeclenchement();
 
             // Active les timers 
             DRV_TMR0_Start();
             DRV_TMR1_Start();
 
-            APPGEN_UpdateState(APPGEN_STATE_WAIT); // Passer  l'tat d'attente
-            break;
-        }
-        case APPGEN_STATE_WAIT:
-        {
-            // nothing to do
+            // Tches : service aprs 3 s puis toutes les 10 ms, vidage
+            // du LCD  chaque tour, envoi de la trace et des rponses
+            // longues de la console toutes les 2 ms, construction des
+            // formes  chaque tour
+            SCHED_Init();
+            SCHED_Ajoute("service", APPGEN_Service, APPGEN_PERIODE_SERVICE,
+                    APPGEN_BUDGET_SERVICE, APPGEN_DELAI_DEMARRAGE);
+            SCHED_Ajoute("lcd", LCDQ_Tasks, 0, APPGEN_BUDGET_LCD, 0);
+            SCHED_Ajoute("trace", TRACE_Tasks, APPGEN_PERIODE_TRACE,
+                    APPGEN_BUDGET_TRACE, 0);
+            SCHED_Ajoute("console", CONSOLE_Tasks, APPGEN_PERIODE_CONSOLE,
+                    APPGEN_BUDGET_CONSOLE, 0);
+            SCHED_Ajoute("calcul", GENSIG_Tasks, 0, APPGEN_BUDGET_CALCUL, 0);
+
+            APPGEN_UpdateState(APPGEN_STATE_SERVICE_TASKS);
             break;
         }
         case APPGEN_STATE_SERVICE_TASKS:
         {
-            // Toggle de la led 2
-            BSP_LEDToggle(BSP_LED_2);
-
-            if (appRJ45Status.ipState == true) {
-                APPGEN_DisplayStoredIP();
-                if (wait5Secondes >= 500) {
-                    wait5Secondes = 0;
-                    appRJ45Status.ipState = false;
-                    appRJ45Status.initialisationMenu = true;
-                }else {
-                    ++wait5Secondes;
-                }
-
-            } else {
-                if (appRJ45Status.rj45Stat) {
-                    MENU_Execute(&RemoteParamGen, false);
-                    BSP_LEDOn(BSP_LED_5);
-                    BSP_LEDOff(BSP_LED_7);
-                } else {
-                    MENU_Execute(&LocalParamGen, true);
-                    BSP_LEDOff(BSP_LED_5);
-                    BSP_LEDOn(BSP_LED_7);
-                }
-            }
-            // Si on doit sauver les paramtres sur USB, on lance la demande de sauvegarde
-            if (appRJ45Status.usbStatSave) {
-                MENU_DemandeSave();
-            }
-
-            APPGEN_UpdateState(APPGEN_STATE_WAIT); // Passer  l'tat d'attente
+            SCHED_Tasks(EVT_GetTick());
             break;
         }
 
@@ -265,13 +320,13 @@ void MENU_DemandeSave(void) {
     Pec12ClearInactivity();
 
     // Affichage du message de sauvegarde
-    lcd_putc('\f');
-    lcd_gotoxy(4, 2);
-    printf_lcd("Sauvegarde USB");
+    LCDQ_Putc('\f');
+    LCDQ_Gotoxy(4, 2);
+    LCDQ_Printf("Sauvegarde USB");
 
     // Aprs environ 500 appels (~3 s si TMR dclenche  6 ms), on efface
     if (wait3Secondes >= 500) {
-        lcd_putc('\f');
+        LCDQ_Putc('\f');
         appRJ45Status.usbStatSave = false; // on dsactive le flag de sauvegarde
         wait3Secondes = 0; // on rinitialise le compteur
     } else {
@@ -287,11 +342,11 @@ void APPGEN_SetIP(uint8_t ip0, uint8_t ip1, uint8_t ip2, uint8_t ip3) {
 }
 
 void APPGEN_DisplayStoredIP(void) {
-    lcd_putc('\f');
-    lcd_gotoxy(7, 2);
-    printf_lcd("Adr. IP");
-    lcd_gotoxy(4, 3);
-    printf_lcd("%d.%d.%d.%d", appgen_ipAddr.v[0], appgen_ipAddr.v[1], appgen_ipAddr.v[2], appgen_ipAddr.v[3]);
+    LCDQ_Putc('\f');
+    LCDQ_Gotoxy(7, 2);
+    LCDQ_Printf("Adr. IP");
+    LCDQ_Gotoxy(4, 3);
+    LCDQ_Printf("%d.%d.%d.%d", appgen_ipAddr.v[0], appgen_ipAddr.v[1], appgen_ipAddr.v[2], appgen_ipAddr.v[3]);
 }
 
 /*******************************************************************************
@@ -68,8 +68,16 @@ SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
 // Section: Type Definitions
 // *****************************************************************************
 // *****************************************************************************
-#define WAITFOR3SECONDES 2999
-#define WAITFOR10CYCLES 9
+// Tches de APPGEN (ordonnanceur GesSched)
+#define APPGEN_DELAI_DEMARRAGE 3000     // ms avant le premier service
+#define APPGEN_PERIODE_SERVICE 10       // ms entre deux services (menu)
+#define APPGEN_BUDGET_SERVICE 2000      // us, calcul de la table compris
+#define APPGEN_BUDGET_LCD 100           // us, voir LCDQ_BUDGET_CYCLES
+#define APPGEN_PERIODE_TRACE 2          // ms entre deux lignes de trace
+#define APPGEN_BUDGET_TRACE 200         // us, formatage d'une ligne
+#define APPGEN_PERIODE_CONSOLE 2        // ms entre deux lignes de rponse
+#define APPGEN_BUDGET_CONSOLE 200       // us, formatage d'une ligne
+#define APPGEN_BUDGET_CALCUL 600        // us, voir GENSIG_BUDGET_CYCLES
 
 #define PRESSION_LONGUE_S9 499
 
@@ -89,7 +97,7 @@ SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
 typedef enum {
     /* Application's state machine's initial state. */
     APPGEN_STATE_INIT = 0,
-    APPGEN_STATE_WAIT,
+    // Tches lances par l'ordonnanceur
     APPGEN_STATE_SERVICE_TASKS
 
 } APPGEN_STATES;
@@ -133,6 +141,10 @@ extern APPGEN_DATA appRJ45Status;
 
 extern APPGEN_DATA usbStatSave;
 
+// Paramtres du gnrateur en mode local (PEC12) et remote (TCP)
+extern S_ParamGen LocalParamGen;
+extern S_ParamGen RemoteParamGen;
+
 //Structure pour les vnements du switch S9
 typedef struct {
     uint8_t OK : 1; // vnement action OK
@@ -59,6 +59,8 @@ SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
 #include <stdbool.h>                    // Defines true
 #include <stdlib.h>                     // Defines EXIT_FAILURE
 #include "system/common/sys_module.h"   // SYS function prototypes
+#include "GesMesure.h"                  // Mesure du temps de boucle
+#include "GesSched.h"                   // Mise en Idle du CPU
 
 
 // *****************************************************************************
@@ -69,14 +71,24 @@ SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
 
 int main ( void )
 {
+    // Pile libre marque pour la commande console "pile"
+    MESURE_PeintPile();
+
     /* Initialize all MPLAB Harmony modules, including application(s). */
     SYS_Initialize ( NULL );
 
     while ( true )
     {
+        MESURE_DEBUT(debutBoucle);
+
         /* Maintain state machines of all polled MPLAB Harmony modules. */
         SYS_Tasks ( );
 
+        // Dure d'un tour de boucle, avec ou sans LCDQ_ENABLE
+        MESURE_FIN(&mesureBoucle, debutBoucle);
+
+        // Rien  faire : CPU en Idle jusqu' la prochaine interruption
+        SCHED_Attente();
     }
 
     /* Execution should not come here during normal operation */
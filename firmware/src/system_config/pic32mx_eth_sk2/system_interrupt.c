@@ -65,6 +65,9 @@ SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
 #include "system_definitions.h"
 #include "Generateur.h"
 #include "GesPec12.h"
+#include "GesEvent.h"
+#include "GesMesure.h"
+#include "GesTrace.h"
 #include <stdint.h>
 #include "bsp.h"
 
@@ -79,47 +82,86 @@ void __ISR(_TIMER_2_VECTOR, ipl1AUTO) IntHandlerDrvTmrInstance0(void) {
 }
 
 // timer 1 configure pour interrupt toutes les 1 ms
-// anti-rebond et appgen
+// horloge ms et chantillonnage brut des entres uniquement, l'anti-rebond
+// et l'inactivit sont traits dans la boucle principale
+// (APPGEN_TraiteTicks)
 
 void __ISR(_TIMER_1_VECTOR, ipl3AUTO) IntHandlerDrvTmrInstance2(void) {
-    static uint16_t wait3Secondes = 0;
-    static uint8_t wait10cycle = 0;
+    MESURE_DEBUT(debutIsr);
+    uint8_t entrees = 0;
 
-    ScanPec12(PEC12_A, PEC12_B, PEC12_PB);
-
-    ScanS9(S_OK);
-
-    LED1_W = !LED1_R;
-
-    if (wait3Secondes >= WAITFOR3SECONDES) {
-        if (wait10cycle >= WAITFOR10CYCLES) {
-
-            wait3Secondes = 2998;
-            APPGEN_UpdateState(APPGEN_STATE_SERVICE_TASKS);
-            wait10cycle = 0;
-        } else {
-            wait10cycle++;
-        }
-    } else {
-        wait3Secondes++;
+    if (PEC12_A) {
+        entrees |= ENTREE_PEC12_A;
+    }
+    if (PEC12_B) {
+        entrees |= ENTREE_PEC12_B;
     }
+    if (PEC12_PB) {
+        entrees |= ENTREE_PEC12_PB;
+    }
+    if (S_OK) {
+        entrees |= ENTREE_S9;
+    }
+    // Horloge ms puis dpt de l'chantillon dat
+    EVT_Tick();
+    EVT_DeposeEchantillon(entrees);
+    TRACE_Ecrit(TRACE_ISR_T1, entrees);
 
     PLIB_INT_SourceFlagClear(INT_ID_0, INT_SOURCE_TIMER_1);
+
+    // Dure de l'interruption en cycles du core timer
+    MESURE_FIN(&mesureIsrT1, debutIsr);
 }
 
 void __ISR(_TIMER_3_VECTOR, ipl7AUTO) IntHandlerDrvTmrInstance1(void) {
+    MESURE_DEBUT(entree);
+    TRACE_Ecrit(TRACE_ISR_T3, 0);
+#ifdef MESURE_ENABLE
+    // Retard sur l'chance idale (TMR3), gigue et chantillons sauts
+    MESURE_EchantillonT3(entree, PLIB_TMR_Counter16BitGet(TMR_ID_3),
+            GENSIG_PeriodeCoreTimer());
+#endif
+
+#ifdef GENSIG_SYNC_ENABLE
+    // LED0 sert de sortie de synchronisation (GENSIG_SYNC_W)
+    GENSIG_Execute();
+    PLIB_INT_SourceFlagClear(INT_ID_0, INT_SOURCE_TIMER_3);
+#else
     LED0_W = 1;
     GENSIG_Execute();
     PLIB_INT_SourceFlagClear(INT_ID_0, INT_SOURCE_TIMER_3);
     LED0_W = 0;
+#endif
+
+    MESURE_FIN(&mesureIsrT3, entree);
+}
+
+#ifdef GENSIG_DECLENCHEMENT_ENABLE
+void __ISR(_INPUT_CAPTURE_1_VECTOR, ipl7AUTO) IntHandlerDeclenchement(void) {
+    uint16_t capture = 0;
+
+    // Dernire capture (des fronts rapprochs ne comptent qu'une fois)
+    while (IC1CONbits.ICBNE) {
+        capture = (uint16_t) IC1BUF;
+    }
+    GENSIG_Declenche(capture);
+    TRACE_Ecrit(TRACE_DECLENCHEMENT, capture);
+    PLIB_INT_SourceFlagClear(INT_ID_0, INT_SOURCE_INPUT_CAPTURE_1);
 }
+#endif
 
 void __ISR(_USB_1_VECTOR, ipl1AUTO) _IntHandlerUSBInstance0(void) {
     DRV_USBFS_Tasks_ISR(sysObj.drvUSBObject);
 }
 
 void __ISR(_ETH_VECTOR, ipl5AUTO) _IntHandler_ETHMAC(void) {
+    MESURE_DEBUT(debutIsr);
+    TRACE_Ecrit(TRACE_ISR_ETH, 0);
+
     DRV_ETHMAC_Tasks_ISR((SYS_MODULE_OBJ) 0);
+
+    // Comprend les ventuelles premptions par Timer3 (ipl7)
+    MESURE_FIN(&mesureIsrEth, debutIsr);
 }
 
 /* This function is used by ETHMAC driver */
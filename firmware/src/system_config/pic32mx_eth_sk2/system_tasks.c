@@ -53,6 +53,7 @@ SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
 
 #include "system_config.h"
 #include "system_definitions.h"
+#include "GesMesure.h"
 
 
 // *****************************************************************************
@@ -94,8 +95,16 @@ void SYS_Tasks ( void )
     USB_DEVICE_Tasks(sysObj.usbDevObject0);
 
     /* Maintain the application's state machine. */
-    APP_Tasks();
-    APPGEN_Tasks();
+    {
+        MESURE_DEBUT(debutTache);
+        APP_Tasks();
+        MESURE_FIN(&mesureApp, debutTache);
+    }
+    {
+        MESURE_DEBUT(debutTache);
+        APPGEN_Tasks();
+        MESURE_FIN(&mesureAppGen, debutTache);
+    }
 }
 
 